@@ -7,8 +7,9 @@ ELSE()
 ENDIF()
 
 TRIBITS_REPOSITORY_DEFINE_TPLS(
-  BoostOrg  "cmake/TPLs/"                                       SS
-  MPI       "${${PROJECT_NAME}_TRIBITS_DIR}/core/std_tpls/"     SS
-  Netcdf    "${${PROJECT_NAME}_TRIBITS_DIR}/common_tpls/"       SS
+  BoostOrg         "cmake/TPLs/"                                       SS
+  MPI              "${${PROJECT_NAME}_TRIBITS_DIR}/core/std_tpls/"     SS
+  Netcdf           "${${PROJECT_NAME}_TRIBITS_DIR}/common_tpls/"       SS
+  GoogleBenchmark  "cmake/TPLs/"                                       SS
   ${TRILINOS_TPL}
 )
@@ -0,0 +1,5 @@
+TRIBITS_TPL_FIND_INCLUDE_DIRS_AND_LIBRARIES(
+  GoogleBenchmark
+  REQUIRED_HEADERS benchmark/benchmark.h
+  REQUIRED_LIBS_NAMES benchmark
+  )
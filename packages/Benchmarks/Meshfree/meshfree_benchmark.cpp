@@ -0,0 +1,50 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Kokkos_Core.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <mpi.h>
+
+// Only the root processor prints the results.
+class NullReporter : public benchmark::BenchmarkReporter
+{
+  public:
+    bool ReportContext( Context const & ) override { return true; }
+    void ReportRuns( std::vector<Run> const & ) override {}
+    void Finalize() override {}
+};
+
+int main( int argc, char *argv[] )
+{
+    MPI_Init( &argc, &argv );
+    Kokkos::initialize( argc, argv );
+
+    benchmark::Initialize( &argc, argv );
+
+    int comm_rank;
+    MPI_Comm_rank( MPI_COMM_WORLD, &comm_rank );
+    if ( comm_rank == 0 )
+    {
+        benchmark::RunSpecifiedBenchmarks();
+    }
+    else
+    {
+        NullReporter null_reporter;
+        benchmark::RunSpecifiedBenchmarks( &null_reporter );
+    }
+
+    Kokkos::finalize();
+    MPI_Finalize();
+
+    return 0;
+}
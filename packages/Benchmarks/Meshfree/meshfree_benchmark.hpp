@@ -0,0 +1,72 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_MESHFREE_BENCHMARK_HPP
+#define DTK_MESHFREE_BENCHMARK_HPP
+
+#include <DTK_ConfigDefs.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <random>
+
+#include <mpi.h>
+
+using DeviceType = Kokkos::DefaultExecutionSpace::device_type;
+
+// Fill a cloud of points uniformly distributed in the box [ox, ox + lx] x [0,
+// 1] x [0, 1].
+template <typename DeviceType>
+Kokkos::View<DataTransferKit::Coordinate **, DeviceType>
+makeRandomCloud( int n, double ox, double lx, unsigned int seed )
+{
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> points(
+        "points", n, 3 );
+    auto points_host = Kokkos::create_mirror_view( points );
+    std::default_random_engine generator( seed );
+    std::uniform_real_distribution<double> distribution( 0., 1. );
+    for ( int i = 0; i < n; ++i )
+    {
+        points_host( i, 0 ) = ox + lx * distribution( generator );
+        points_host( i, 1 ) = distribution( generator );
+        points_host( i, 2 ) = distribution( generator );
+    }
+    Kokkos::deep_copy( points, points_host );
+    return points;
+}
+
+// Time a collective operation and report the slowest processor. All the
+// processors report the same value which guarantees that they all run the same
+// number of iterations.
+template <typename Function>
+void timeCollective( benchmark::State &state, MPI_Comm comm,
+                     Function const &function )
+{
+    for ( auto _ : state )
+    {
+        MPI_Barrier( comm );
+        auto const start = std::chrono::high_resolution_clock::now();
+        function();
+        Kokkos::fence();
+        auto const end = std::chrono::high_resolution_clock::now();
+        double elapsed_seconds =
+            std::chrono::duration<double>( end - start ).count();
+        double max_elapsed_seconds;
+        MPI_Allreduce( &elapsed_seconds, &max_elapsed_seconds, 1, MPI_DOUBLE,
+                       MPI_MAX, comm );
+        state.SetIterationTime( max_elapsed_seconds );
+    }
+}
+
+#endif
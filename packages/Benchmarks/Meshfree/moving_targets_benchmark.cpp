@@ -0,0 +1,131 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "meshfree_benchmark.hpp"
+
+#include <DTK_MovingLeastSquaresOperator.hpp>
+#include <DTK_NearestNeighborOperator.hpp>
+#include <DTK_PointCloudSearchTree.hpp>
+
+// Each processor owns a slab of source points and the target points in the
+// same slab. The target points oscillate between two positions, the second
+// one is the first one moved randomly by at most `amplitude` in each
+// direction.
+template <typename DeviceType>
+struct MovingTargetsProblem
+{
+    MovingTargetsProblem( MPI_Comm comm, int n_points, double amplitude )
+    {
+        int comm_rank;
+        MPI_Comm_rank( comm, &comm_rank );
+
+        source_points =
+            makeRandomCloud<DeviceType>( n_points, comm_rank, 1., comm_rank );
+        target_points = makeRandomCloud<DeviceType>( n_points, comm_rank, 1.,
+                                                     comm_rank + 1234 );
+
+        // Random displacement in [-amplitude, amplitude]^3
+        auto displacement = makeRandomCloud<DeviceType>( n_points, 0., 1.,
+                                                         comm_rank + 5678 );
+        moved_target_points =
+            Kokkos::View<DataTransferKit::Coordinate **, DeviceType>(
+                "moved_target_points", n_points, 3 );
+        auto target_points_ = target_points;
+        auto moved_target_points_ = moved_target_points;
+        Kokkos::parallel_for(
+            "move_target_points",
+            Kokkos::RangePolicy<typename DeviceType::execution_space>(
+                0, n_points ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int d = 0; d < 3; ++d )
+                    moved_target_points_( i, d ) =
+                        target_points_( i, d ) +
+                        amplitude * ( 2. * displacement( i, d ) - 1. );
+            } );
+        Kokkos::fence();
+    }
+
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> source_points;
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> target_points;
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType>
+        moved_target_points;
+};
+
+// Cost of building a new operator every time the target points move. The
+// search tree over the source points is reused since they do not move.
+template <class Operator>
+void BM_moving_targets_rebuild( benchmark::State &state )
+{
+    using DeviceType = typename Operator::device_type;
+    MPI_Comm comm = MPI_COMM_WORLD;
+    MovingTargetsProblem<DeviceType> problem( comm, state.range( 0 ),
+                                              1e-4 * state.range( 1 ) );
+
+    DataTransferKit::PointCloudSearchTree<DeviceType> search_tree(
+        comm, problem.source_points );
+
+    bool moved = false;
+    timeCollective( state, comm, [&]() {
+        moved = !moved;
+        Operator op( search_tree, moved ? problem.moved_target_points
+                                        : problem.target_points );
+        benchmark::DoNotOptimize( op );
+    } );
+}
+
+// Cost of updating the operator every time the target points move. Only the
+// target points that moved farther than the tolerance are searched again.
+template <class Operator>
+void BM_moving_targets_update( benchmark::State &state )
+{
+    using DeviceType = typename Operator::device_type;
+    MPI_Comm comm = MPI_COMM_WORLD;
+    MovingTargetsProblem<DeviceType> problem( comm, state.range( 0 ),
+                                              1e-4 * state.range( 1 ) );
+    double const tolerance = 1e-3;
+
+    DataTransferKit::PointCloudSearchTree<DeviceType> search_tree(
+        comm, problem.source_points );
+    Operator op( search_tree, problem.target_points );
+
+    bool moved = false;
+    timeCollective( state, comm, [&]() {
+        moved = !moved;
+        op.update( moved ? problem.moved_target_points : problem.target_points,
+                   tolerance );
+    } );
+}
+
+using MLS = DataTransferKit::MovingLeastSquaresOperator<DeviceType>;
+using NearestNeighbor = DataTransferKit::NearestNeighborOperator<DeviceType>;
+
+// The second argument is the amplitude of the motion in units of 1e-4. The
+// tolerance of the update is 1e-3.
+BENCHMARK_TEMPLATE( BM_moving_targets_rebuild, MLS )
+    ->Args( {100000, 1} )
+    ->Args( {100000, 100} )
+    ->UseManualTime()
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_moving_targets_update, MLS )
+    ->Args( {100000, 1} )
+    ->Args( {100000, 100} )
+    ->UseManualTime()
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_moving_targets_rebuild, NearestNeighbor )
+    ->Args( {100000, 1} )
+    ->Args( {100000, 100} )
+    ->UseManualTime()
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_moving_targets_update, NearestNeighbor )
+    ->Args( {100000, 1} )
+    ->Args( {100000, 100} )
+    ->UseManualTime()
+    ->Unit( benchmark::kMillisecond );
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "meshfree_benchmark.hpp"
+
+#include <ArborX.hpp>
+#include <DTK_DetailsNearestNeighborOperatorImpl.hpp>
+#include <DTK_NearestNeighborOperator.hpp>
+
+// Each processor owns a slab of source points. The target points are spread
+// over the whole domain so that most of the nearest neighbors live on another
+// processor.
+template <typename DeviceType>
+struct NearestNeighborProblem
+{
+    NearestNeighborProblem( MPI_Comm comm, int n_source_points,
+                            int n_target_points )
+    {
+        int comm_rank;
+        MPI_Comm_rank( comm, &comm_rank );
+        int comm_size;
+        MPI_Comm_size( comm, &comm_size );
+
+        source_points = makeRandomCloud<DeviceType>( n_source_points,
+                                                     comm_rank, 1., comm_rank );
+        target_points = makeRandomCloud<DeviceType>(
+            n_target_points, 0., comm_size, comm_size + comm_rank );
+
+        source_values = Kokkos::View<double *, DeviceType>( "source_values",
+                                                            n_source_points );
+        Kokkos::deep_copy( source_values, 1. );
+        target_values = Kokkos::View<double *, DeviceType>( "target_values",
+                                                            n_target_points );
+    }
+
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> source_points;
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> target_points;
+    Kokkos::View<double *, DeviceType> source_values;
+    Kokkos::View<double *, DeviceType> target_values;
+};
+
+// Per-apply cost when the communication pattern is rebuilt on every call. This
+// is what NearestNeighborOperator::apply() used to do.
+template <class DeviceType>
+void BM_nearest_neighbor_apply_fetch( benchmark::State &state )
+{
+    MPI_Comm comm = MPI_COMM_WORLD;
+    NearestNeighborProblem<DeviceType> problem( comm, state.range( 0 ),
+                                                state.range( 1 ) );
+
+    ArborX::DistributedSearchTree<DeviceType> search_tree(
+        comm, problem.source_points );
+    auto queries = DataTransferKit::Details::NearestNeighborOperatorImpl<
+        DeviceType>::makeNearestNeighborQueries( problem.target_points );
+    Kokkos::View<int *, DeviceType> indices( "indices", 0 );
+    Kokkos::View<int *, DeviceType> offset( "offset", 0 );
+    Kokkos::View<int *, DeviceType> ranks( "ranks", 0 );
+    search_tree.query( queries, indices, offset, ranks );
+
+    timeCollective( state, comm, [&]() {
+        auto values = DataTransferKit::Details::NearestNeighborOperatorImpl<
+            DeviceType>::fetch( comm, ranks, indices, problem.source_values );
+        Kokkos::deep_copy( problem.target_values, values );
+    } );
+}
+
+// Per-apply cost with the communication plan precomputed at construction.
+template <class DeviceType>
+void BM_nearest_neighbor_apply_plan( benchmark::State &state )
+{
+    MPI_Comm comm = MPI_COMM_WORLD;
+    NearestNeighborProblem<DeviceType> problem( comm, state.range( 0 ),
+                                                state.range( 1 ) );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> op(
+        comm, problem.source_points, problem.target_points );
+
+    timeCollective( state, comm, [&]() {
+        op.apply( problem.source_values, problem.target_values );
+    } );
+}
+
+BENCHMARK_TEMPLATE( BM_nearest_neighbor_apply_fetch, DeviceType )
+    ->Args( {10000, 10000} )
+    ->Args( {100000, 100000} )
+    ->UseManualTime()
+    ->Unit( benchmark::kMicrosecond );
+BENCHMARK_TEMPLATE( BM_nearest_neighbor_apply_plan, DeviceType )
+    ->Args( {10000, 10000} )
+    ->Args( {100000, 100000} )
+    ->UseManualTime()
+    ->Unit( benchmark::kMicrosecond );
@@ -0,0 +1,114 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "meshfree_benchmark.hpp"
+
+#include <DTK_CompactlySupportedRadialBasisFunctions.hpp>
+
+// Random distances in [0, 1), stored by rows of n_neighbors like the weights
+// of the operators.
+template <typename DeviceType>
+Kokkos::View<double *, DeviceType> makeRandomDistances( int n )
+{
+    Kokkos::View<double *, DeviceType> distances( "distances", n );
+    auto distances_host = Kokkos::create_mirror_view( distances );
+    std::default_random_engine generator( 0 );
+    std::uniform_real_distribution<double> distribution( 0., 1. );
+    for ( int i = 0; i < n; ++i )
+        distances_host( i ) = distribution( generator );
+    Kokkos::deep_copy( distances, distances_host );
+    return distances;
+}
+
+// One evaluation per call, one row per thread.
+template <class DeviceType, class RBF>
+void BM_rbf_scalar( benchmark::State &state )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    int const n_rows = state.range( 0 );
+    int const n_neighbors = state.range( 1 );
+
+    auto distances = makeRandomDistances<DeviceType>( n_rows * n_neighbors );
+    Kokkos::View<double *, DeviceType> values( "values",
+                                               distances.extent( 0 ) );
+    DataTransferKit::RadialBasisFunction<RBF> rbf( 1. );
+
+    for ( auto _ : state )
+    {
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "evaluate_rbf_scalar" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_rows ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int j = i * n_neighbors; j < ( i + 1 ) * n_neighbors;
+                      ++j )
+                    values( j ) = rbf( distances( j ) );
+            } );
+        Kokkos::fence();
+    }
+
+    state.counters["evaluations"] =
+        benchmark::Counter( state.iterations() * n_rows * n_neighbors,
+                            benchmark::Counter::kIsRate );
+}
+
+// All the evaluations of a row in one call, one row per thread.
+template <class DeviceType, class RBF>
+void BM_rbf_batch( benchmark::State &state )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    int const n_rows = state.range( 0 );
+    int const n_neighbors = state.range( 1 );
+
+    auto distances = makeRandomDistances<DeviceType>( n_rows * n_neighbors );
+    Kokkos::View<double *, DeviceType> values( "values",
+                                               distances.extent( 0 ) );
+    DataTransferKit::RadialBasisFunction<RBF> rbf( 1. );
+
+    for ( auto _ : state )
+    {
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "evaluate_rbf_batch" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_rows ),
+            KOKKOS_LAMBDA( int i ) {
+                rbf( &distances( i * n_neighbors ),
+                     &values( i * n_neighbors ), n_neighbors );
+            } );
+        Kokkos::fence();
+    }
+
+    state.counters["evaluations"] =
+        benchmark::Counter( state.iterations() * n_rows * n_neighbors,
+                            benchmark::Counter::kIsRate );
+}
+
+using DataTransferKit::Buhmann;
+using DataTransferKit::Wendland;
+using DataTransferKit::Wu;
+
+// Number of neighbors of the quadratic polynomials in 3D.
+BENCHMARK_TEMPLATE( BM_rbf_scalar, DeviceType, Wendland<2> )
+    ->Args( {100000, 20} )
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_rbf_batch, DeviceType, Wendland<2> )
+    ->Args( {100000, 20} )
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_rbf_scalar, DeviceType, Wu<2> )
+    ->Args( {100000, 20} )
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_rbf_batch, DeviceType, Wu<2> )
+    ->Args( {100000, 20} )
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_rbf_scalar, DeviceType, Buhmann<3> )
+    ->Args( {100000, 20} )
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_rbf_batch, DeviceType, Buhmann<3> )
+    ->Args( {100000, 20} )
+    ->Unit( benchmark::kMillisecond );
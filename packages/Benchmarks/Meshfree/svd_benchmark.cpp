@@ -0,0 +1,108 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "meshfree_benchmark.hpp"
+
+#include <DTK_DetailsSVDImpl.hpp>
+
+// Random batch of n_matrices matrices of size n x n stored in a flat array.
+template <typename DeviceType>
+Kokkos::View<double *, DeviceType> makeRandomMatrices( int n_matrices, int n )
+{
+    int const size = n_matrices * n * n;
+    Kokkos::View<double *, DeviceType> matrices( "matrices", size );
+    auto matrices_host = Kokkos::create_mirror_view( matrices );
+    std::default_random_engine generator( 0 );
+    std::uniform_real_distribution<double> distribution( -1., 1. );
+    for ( int i = 0; i < size; ++i )
+        matrices_host( i ) = distribution( generator );
+    Kokkos::deep_copy( matrices, matrices_host );
+    return matrices;
+}
+
+// One matrix per thread, largest off-diagonal entry first, only the first row
+// of the pseudo-inverse. This is the kernel of the moving least squares
+// operator.
+template <class DeviceType, int N>
+void BM_svd_fixed_size( benchmark::State &state )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    using SVD = DataTransferKit::Details::SVDFixedSize<DeviceType, N>;
+    int const n_matrices = state.range( 0 );
+
+    auto matrices = makeRandomMatrices<DeviceType>( n_matrices, N );
+    Kokkos::View<double *, DeviceType> first_rows( "first_rows",
+                                                   n_matrices * N );
+
+    for ( auto _ : state )
+    {
+        size_t n_underdetermined = 0;
+        Kokkos::parallel_reduce(
+            DTK_MARK_REGION( "compute_svd_inverse_fixed_size" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_matrices ),
+            KOKKOS_LAMBDA( int m, size_t &underdetermined ) {
+                typename SVD::matrix_type a;
+                for ( int i = 0; i < N; ++i )
+                    for ( int j = 0; j < N; ++j )
+                        a[i][j] = matrices( ( m * N + i ) * N + j );
+                typename SVD::vector_type first_row;
+                if ( SVD::pseudo_inverse_first_row( a, first_row ) )
+                    ++underdetermined;
+                for ( int j = 0; j < N; ++j )
+                    first_rows( m * N + j ) = first_row[j];
+            },
+            n_underdetermined );
+        Kokkos::fence();
+    }
+
+    state.counters["matrices"] = benchmark::Counter(
+        state.iterations() * n_matrices, benchmark::Counter::kIsRate );
+}
+
+// One matrix per team, round-robin ordering.
+template <class DeviceType>
+void BM_svd_team_policy( benchmark::State &state )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    int const n_matrices = state.range( 0 );
+    int const n = state.range( 1 );
+
+    auto matrices = makeRandomMatrices<DeviceType>( n_matrices, n );
+    Kokkos::View<double *, DeviceType> inv_matrices( "inv_matrices",
+                                                     matrices.extent( 0 ) );
+    DataTransferKit::Details::SVDTeamFunctor<DeviceType> svd_functor(
+        n, matrices, inv_matrices );
+
+    for ( auto _ : state )
+    {
+        size_t n_underdetermined = 0;
+        Kokkos::parallel_reduce(
+            DTK_MARK_REGION( "compute_svd_inverse_team" ),
+            Kokkos::TeamPolicy<ExecutionSpace>( n_matrices, Kokkos::AUTO ),
+            svd_functor, n_underdetermined );
+        Kokkos::fence();
+    }
+
+    state.counters["matrices"] = benchmark::Counter(
+        state.iterations() * n_matrices, benchmark::Counter::kIsRate );
+}
+
+// Basis sizes of the linear and quadratic polynomials in 3D.
+BENCHMARK_TEMPLATE( BM_svd_fixed_size, DeviceType, 4 )
+    ->Args( {100000} )
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_svd_fixed_size, DeviceType, 10 )
+    ->Args( {100000} )
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_svd_team_policy, DeviceType )
+    ->Args( {100000, 4} )
+    ->Args( {100000, 10} )
+    ->Unit( benchmark::kMillisecond );
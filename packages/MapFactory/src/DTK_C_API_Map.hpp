@@ -22,8 +22,11 @@
 #include <DTK_NearestNeighborOperator.hpp>
 #include <DTK_ParallelTraits.hpp>
 #include <DTK_PointCloudOperator.hpp>
+#include <DTK_PointCloudSearchTree.hpp>
 #include <DTK_UserApplication.hpp>
 
+#include <boost/optional.hpp>
+
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 
@@ -80,6 +83,12 @@ struct DTK_MapImpl : public DTK_Map
             target_nodes.extent( 1 ) );
         Kokkos::deep_copy( target_nodes_copy, target_nodes );
 
+        // If field "Balance Targets" is true, the target nodes are
+        // redistributed among the processors during the setup of the map.
+        PointCloudSearchTree<map_device_type> search_tree(
+            comm, source_nodes_copy,
+            ptree.get<bool>( "Balance Targets", false ) );
+
         auto const which_map =
             ptree.get<std::string>( "Map Type", "Undefined" );
         if ( which_map == "Undefined" )
@@ -88,29 +97,26 @@ struct DTK_MapImpl : public DTK_Map
         else if ( which_map == "Nearest Neighbor" || which_map == "NN" )
             _map = std::unique_ptr<NearestNeighborOperator<map_device_type>>(
                 new NearestNeighborOperator<map_device_type>(
-                    comm, source_nodes_copy, target_nodes_copy ) );
+                    search_tree, target_nodes_copy ) );
         else if ( which_map == "Moving Least Squares" || which_map == "MLS" )
         {
             // NOTE if field "Order" is misspelled (for instance first letter
             // not capitalized), the default value (linear polynomials) will be
             // picked up without a warning or an error being raised.
             auto const order = ptree.get<std::string>( "Order", "Linear" );
+            // If field "Support Radius" is present, the neighbors are the
+            // source points within that radius instead of the closest ones. A
+            // non-positive value means that the radius is estimated.
+            auto const support_radius =
+                ptree.get_optional<double>( "Support Radius" );
             if ( order == "Linear" || order == "1" )
-                _map = std::unique_ptr<MovingLeastSquaresOperator<
-                    map_device_type, Wendland<0>,
-                    MultivariatePolynomialBasis<Linear, 3>>>(
-                    new MovingLeastSquaresOperator<
-                        map_device_type, Wendland<0>,
-                        MultivariatePolynomialBasis<Linear, 3>>(
-                        comm, source_nodes_copy, target_nodes_copy ) );
+                _map = makeMovingLeastSquaresOperator<
+                    MultivariatePolynomialBasis<Linear, 3>>(
+                    search_tree, target_nodes_copy, support_radius );
             else if ( order == "Quadratic" || order == "2" )
-                _map = std::unique_ptr<MovingLeastSquaresOperator<
-                    map_device_type, Wendland<0>,
-                    MultivariatePolynomialBasis<Quadratic, 3>>>(
-                    new MovingLeastSquaresOperator<
-                        map_device_type, Wendland<0>,
-                        MultivariatePolynomialBasis<Quadratic, 3>>(
-                        comm, source_nodes_copy, target_nodes_copy ) );
+                _map = makeMovingLeastSquaresOperator<
+                    MultivariatePolynomialBasis<Quadratic, 3>>(
+                    search_tree, target_nodes_copy, support_radius );
             else
                 throw DataTransferKitException(
                     "Invalid order \"" + order +
@@ -131,29 +137,48 @@ struct DTK_MapImpl : public DTK_Map
         // Pull the data from the source.
         _source.pullField( source_field_name, source_field );
 
-        // Copy to a compatible layout. Nearest neighbor operator needs a
-        // compatible layout and only 1 dimension
-        int num_src = source_field.dofs.extent( 0 );
-        Kokkos::View<double *, map_device_type> source_field_copy(
-            "source_field_copy", num_src );
-        Kokkos::deep_copy(
-            source_field_copy,
-            Kokkos::subview( source_field.dofs, Kokkos::ALL, 0 ) );
-        int num_tgt = target_field.dofs.extent( 0 );
-        Kokkos::View<double *, map_device_type> target_field_copy(
-            "target_field_copy", num_tgt );
+        // Copy to a layout that is compatible with the operator. All the
+        // components of the field are transferred at once.
+        using map_memory_space = typename map_device_type::memory_space;
+        auto source_dofs = Kokkos::create_mirror_view_and_copy(
+            map_memory_space{}, source_field.dofs );
+        Kokkos::View<double **, map_device_type> source_field_copy(
+            "source_field_copy", source_dofs.extent( 0 ),
+            source_dofs.extent( 1 ) );
+        Kokkos::deep_copy( source_field_copy, source_dofs );
+        Kokkos::View<double **, map_device_type> target_field_copy(
+            "target_field_copy", target_field.dofs.extent( 0 ),
+            target_field.dofs.extent( 1 ) );
 
         // Apply the map.
         _map->apply( source_field_copy, target_field_copy );
 
         // Copy the transferred field back to the original target layout.
-        Kokkos::deep_copy( Kokkos::subview( target_field.dofs, Kokkos::ALL, 0 ),
-                           target_field_copy );
+        auto target_dofs = Kokkos::create_mirror_view( map_memory_space{},
+                                                       target_field.dofs );
+        Kokkos::deep_copy( target_dofs, target_field_copy );
+        Kokkos::deep_copy( target_field.dofs, target_dofs );
 
         // Push the data to the target.
         _target.pushField( target_field_name, target_field );
     }
 
+    template <typename PolynomialBasis>
+    static std::unique_ptr<PointCloudOperator<map_device_type>>
+    makeMovingLeastSquaresOperator(
+        PointCloudSearchTree<map_device_type> const &search_tree,
+        Kokkos::View<Coordinate const **, map_device_type> target_nodes,
+        boost::optional<double> const &support_radius )
+    {
+        using Operator = MovingLeastSquaresOperator<
+            map_device_type, Wendland<0>, PolynomialBasis>;
+        if ( !support_radius )
+            return std::unique_ptr<Operator>(
+                new Operator( search_tree, target_nodes ) );
+        return std::unique_ptr<Operator>(
+            new Operator( search_tree, target_nodes, *support_radius ) );
+    }
+
     UserApplication<double, SourceMemSpace> _source;
     UserApplication<double, TargetMemSpace> _target;
     std::unique_ptr<PointCloudOperator<map_device_type>> _map;
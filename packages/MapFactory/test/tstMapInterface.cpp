@@ -26,18 +26,22 @@
 #include <Kokkos_Core.hpp>
 
 #include <memory>
+#include <string>
 
 //---------------------------------------------------------------------------//
-// User implementation
+// User implementation. The field named "vector" has three components, the
+// other ones have a single component.
 template <class Space>
 struct TestUserData
 {
     Kokkos::View<double * [3], Space> coords;
     Kokkos::View<double *, Space> field;
+    Kokkos::View<double * [3], Space> vector_field;
 
     TestUserData( const int size )
         : coords( "coords", size )
         , field( "field", size )
+        , vector_field( "vector_field", size )
     {
     }
 };
@@ -66,24 +70,39 @@ void fieldSize( void *user_data, const char *field_name,
                 unsigned *field_dimension, size_t *local_num_dofs )
 {
     TestUserData<Space> *data = static_cast<TestUserData<Space> *>( user_data );
-    field_name = "dummy_field";
-    *field_dimension = 1;
+    *field_dimension =
+        std::string( field_name ) == "vector" ? data->vector_field.extent( 1 )
+                                              : 1;
     *local_num_dofs = data->field.extent( 0 );
 }
 
+// The components of a field are stored one after the other.
 template <class Space>
-void pullField( void *user_data, const char *, double *field_dofs )
+void pullField( void *user_data, const char *field_name, double *field_dofs )
 {
     TestUserData<Space> *data = static_cast<TestUserData<Space> *>( user_data );
-    for ( unsigned i = 0; i < data->field.extent( 0 ); ++i )
-        field_dofs[i] = data->field( i );
+    int num_dofs = data->field.extent( 0 );
+    if ( std::string( field_name ) == "vector" )
+        for ( unsigned i = 0; i < data->vector_field.extent( 0 ); ++i )
+            for ( unsigned d = 0; d < data->vector_field.extent( 1 ); ++d )
+                field_dofs[num_dofs * d + i] = data->vector_field( i, d );
+    else
+        for ( unsigned i = 0; i < data->field.extent( 0 ); ++i )
+            field_dofs[i] = data->field( i );
 }
 template <class Space>
-void pushField( void *user_data, const char *, const double *field_dofs )
+void pushField( void *user_data, const char *field_name,
+                const double *field_dofs )
 {
     TestUserData<Space> *data = static_cast<TestUserData<Space> *>( user_data );
-    for ( unsigned i = 0; i < data->field.extent( 0 ); ++i )
-        data->field( i ) = field_dofs[i];
+    int num_dofs = data->field.extent( 0 );
+    if ( std::string( field_name ) == "vector" )
+        for ( unsigned i = 0; i < data->vector_field.extent( 0 ); ++i )
+            for ( unsigned d = 0; d < data->vector_field.extent( 1 ); ++d )
+                data->vector_field( i, d ) = field_dofs[num_dofs * d + i];
+    else
+        for ( unsigned i = 0; i < data->field.extent( 0 ); ++i )
+            data->field( i ) = field_dofs[i];
 }
 
 //---------------------------------------------------------------------------//
@@ -168,6 +187,12 @@ void test( bool &success, Teuchos::FancyOStream &out )
         }
         src_data->field( p ) = 1.0 * p + comm_rank * num_point;
         tgt_data->field( p ) = 0.0;
+        for ( int d = 0; d < 3; ++d )
+        {
+            src_data->vector_field( p, d ) =
+                ( d + 1.0 ) * ( 1.0 * p + comm_rank * num_point );
+            tgt_data->vector_field( p, d ) = 0.0;
+        }
     }
 
     // Create the source user application instance.
@@ -226,6 +251,10 @@ void test( bool &success, Teuchos::FancyOStream &out )
                                                       // double quoted
               R"({ "Map Type": "MLS", "Order": "Quadratic" })",
               R"({ "Map Type": "MLS", "Order": "2" })",
+              R"({ "Map Type": "MLS", "Support Radius": 2.5 })",
+              R"({ "Map Type": "MLS", "Support Radius": 0 })", // estimated
+              R"({ "Map Type": "NN", "Balance Targets": true })",
+              R"({ "Map Type": "MLS", "Balance Targets": true })",
           } )
     {
         auto map_handle =
@@ -292,6 +321,17 @@ void test( bool &success, Teuchos::FancyOStream &out )
                                     relative_tolerance );
         }
 
+        // All the components of a field are transferred by a single apply.
+        DTK_applyMap( map_handle, "vector", "vector" );
+        TEST_EQUALITY( errno, DTK_SUCCESS );
+        for ( int p = 0; p < num_point; ++p )
+            for ( int d = 0; d < 3; ++d )
+                TEST_FLOATING_EQUALITY(
+                    tgt_data->vector_field( p, d ) + shift_from_zero,
+                    ( d + 1.0 ) * ( 1.0 * p + inverse_rank * num_point ) +
+                        shift_from_zero,
+                    relative_tolerance );
+
         DTK_destroyMap( map_handle );
         TEST_EQUALITY( errno, DTK_SUCCESS );
     }
@@ -19,6 +19,9 @@
 namespace DataTransferKit
 {
 
+// The functions are evaluated in Horner form. The batch overload of
+// RadialBasisFunction evaluates them at contiguous distances in a loop
+// without dependencies between iterations that the compiler can vectorize.
 template <typename RBF>
 class RadialBasisFunction
 {
@@ -33,6 +36,14 @@ class RadialBasisFunction
     {
         return _rbf( x / _radius );
     }
+    // Evaluate the function at the n distances x and write the values in y.
+    // x and y may be the same array.
+    KOKKOS_INLINE_FUNCTION void operator()( double const *x, double *y,
+                                            int n ) const
+    {
+        for ( int i = 0; i < n; ++i )
+            y[i] = _rbf( x[i] / _radius );
+    }
 
   private:
     double _radius;
@@ -47,7 +58,8 @@ struct Wendland<0>
 {
     KOKKOS_INLINE_FUNCTION double operator()( double x ) const
     {
-        return ( 1.0 - x ) * ( 1.0 - x );
+        double const t = 1.0 - x;
+        return t * t;
     }
 };
 
@@ -56,8 +68,9 @@ struct Wendland<2>
 {
     KOKKOS_INLINE_FUNCTION double operator()( double x ) const
     {
-        return ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) *
-               ( 4.0 * x + 1.0 );
+        double const t = 1.0 - x;
+        double const t2 = t * t;
+        return t2 * t2 * ( 4.0 * x + 1.0 );
     }
 };
 
@@ -66,8 +79,9 @@ struct Wendland<4>
 {
     KOKKOS_INLINE_FUNCTION double operator()( double x ) const
     {
-        return ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) *
-               ( 1.0 - x ) * ( 1.0 - x ) * ( 35.0 * x * x + 18.0 * x + 3.0 );
+        double const t = 1.0 - x;
+        double const t2 = t * t;
+        return t2 * t2 * t2 * ( ( 35.0 * x + 18.0 ) * x + 3.0 );
     }
 };
 
@@ -76,9 +90,10 @@ struct Wendland<6>
 {
     KOKKOS_INLINE_FUNCTION double operator()( double x ) const
     {
-        return ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) *
-               ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) *
-               ( 32.0 * x * x * x + 25.0 * x * x + 8.0 * x + 1.0 );
+        double const t = 1.0 - x;
+        double const t2 = t * t;
+        double const t4 = t2 * t2;
+        return t4 * t4 * ( ( ( 32.0 * x + 25.0 ) * x + 8.0 ) * x + 1.0 );
     }
 };
 
@@ -90,8 +105,9 @@ struct Wu<2>
 {
     KOKKOS_INLINE_FUNCTION double operator()( double x ) const
     {
-        return ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) *
-               ( 3.0 * x * x * x + 12.0 * x * x + 16.0 * x + 4.0 );
+        double const t = 1.0 - x;
+        double const t2 = t * t;
+        return t2 * t2 * ( ( ( 3.0 * x + 12.0 ) * x + 16.0 ) * x + 4.0 );
     }
 };
 
@@ -100,10 +116,14 @@ struct Wu<4>
 {
     KOKKOS_INLINE_FUNCTION double operator()( double x ) const
     {
-        return ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) * ( 1.0 - x ) *
-               ( 1.0 - x ) * ( 1.0 - x ) *
-               ( 5.0 * x * x * x * x * x + 30.0 * x * x * x * x +
-                 72.0 * x * x * x + 82.0 * x * x + 36.0 * x + 6.0 );
+        double const t = 1.0 - x;
+        double const t2 = t * t;
+        double p = 5.0 * x + 30.0;
+        p = p * x + 72.0;
+        p = p * x + 82.0;
+        p = p * x + 36.0;
+        p = p * x + 6.0;
+        return t2 * t2 * t2 * p;
     }
 };
 
@@ -115,8 +135,9 @@ struct Buhmann<2>
 {
     KOKKOS_INLINE_FUNCTION double operator()( double x ) const
     {
-        return 2.0 * x * x * x * x * log( x ) - 7.0 / 2.0 * x * x * x * x +
-               16 / 3.0 * x * x * x - 2 * x * x + 1.0 / 6.0;
+        double const x2 = x * x;
+        double const p = ( 2.0 * log( x ) - 7.0 / 2.0 ) * x2 + 16.0 / 3.0 * x;
+        return ( p - 2.0 ) * x2 + 1.0 / 6.0;
     }
 };
 
@@ -125,11 +146,13 @@ struct Buhmann<3>
 {
     KOKKOS_INLINE_FUNCTION double operator()( double x ) const
     {
-        return x * x * x * x * x * x * x * x -
-               84.0 / 5.0 * x * x * x * x * x * x +
-               1024.0 / 5.0 * x * x * x * x * sqrt( x ) -
-               378.0 * x * x * x * x + 1024.0 / 5.0 * x * x * x * sqrt( x ) -
-               84.0 / 5.0 * x * x + 1.0;
+        double const x2 = x * x;
+        double const s = sqrt( x );
+        double p = x2 - 84.0 / 5.0;
+        p = p * x2 + 1024.0 / 5.0 * s - 378.0;
+        p = p * x + 1024.0 / 5.0 * s;
+        p = p * x - 84.0 / 5.0;
+        return p * x2 + 1.0;
     }
 };
 
@@ -138,11 +161,13 @@ struct Buhmann<4>
 {
     KOKKOS_INLINE_FUNCTION double operator()( double x ) const
     {
-        return 99.0 / 35.0 * x * x * x * x * x * x * x * x -
-               132.0 * x * x * x * x * x * x +
-               9216.0 / 35.0 * x * x * x * x * x * sqrt( x ) -
-               11264.0 / 35.0 * x * x * x * x * sqrt( x ) +
-               198.0 * x * x * x * x - 396.0 / 5.0 * x * x + 1.0;
+        double const x2 = x * x;
+        double const s = sqrt( x );
+        double p = 99.0 / 35.0 * x2 - 132.0;
+        p = p * x + 9216.0 / 35.0 * s;
+        p = p * x - 11264.0 / 35.0 * s + 198.0;
+        p = p * x2 - 396.0 / 5.0;
+        return p * x2 + 1.0;
     }
 };
 
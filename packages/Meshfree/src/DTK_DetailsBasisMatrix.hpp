@@ -0,0 +1,318 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_BASIS_MATRIX_HPP
+#define DTK_BASIS_MATRIX_HPP
+
+#include <DTK_DBC.hpp>
+#include <DTK_DetailsCommunicationPlan.hpp>
+#include <DTK_Types.h>
+
+#include <Teuchos_Comm.hpp>
+#include <Teuchos_RCP.hpp>
+
+#include <Tpetra_CrsMatrix.hpp>
+#include <Tpetra_Map.hpp>
+#include <Tpetra_MultiVector.hpp>
+#include <Tpetra_Operator.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_Sort.hpp>
+
+#include <mpi.h>
+
+namespace DataTransferKit
+{
+
+/**
+ * Matrix-free operator for the radial basis function blocks of the spline
+ * interpolation. The i-th row has one entry per neighbor of the i-th point.
+ * The neighbors are given in CRS format by their (rank, index) pairs, the
+ * index being the local index of the source point in the domain map on
+ * processor rank, and the entries are the values of the radial basis
+ * function. Rows beyond the number of points in the neighbor lists are
+ * empty.
+ *
+ * apply() retrieves the entries of X that correspond to the neighbors with a
+ * precomputed communication plan and performs the product on the device. No
+ * global index is ever formed. The transpose is applied with the same plan,
+ * in the reverse direction. If an assembled matrix is needed, for instance
+ * to build a preconditioner, buildCrsMatrix() creates one on the device.
+ */
+template <typename Scalar, typename LocalOrdinal, typename GlobalOrdinal,
+          typename Node>
+class BasisMatrix
+    : public Tpetra::Operator<Scalar, LocalOrdinal, GlobalOrdinal, Node>
+{
+    using DeviceType = typename Node::device_type;
+    using ExecutionSpace = typename DeviceType::execution_space;
+    using Map = Tpetra::Map<LocalOrdinal, GlobalOrdinal, Node>;
+    using MultiVector =
+        Tpetra::MultiVector<Scalar, LocalOrdinal, GlobalOrdinal, Node>;
+    using CrsMatrix =
+        Tpetra::CrsMatrix<Scalar, LocalOrdinal, GlobalOrdinal, Node>;
+
+  public:
+    // The communication plan must have been built from ranks and indices.
+    BasisMatrix( MPI_Comm comm,
+                 Details::CommunicationPlan<DeviceType> const &plan,
+                 Kokkos::View<int const *, DeviceType> offset,
+                 Kokkos::View<int const *, DeviceType> ranks,
+                 Kokkos::View<int const *, DeviceType> indices,
+                 Kokkos::View<double const *, DeviceType> values,
+                 const Teuchos::RCP<const Map> &domain_map,
+                 const Teuchos::RCP<const Map> &range_map )
+        : _comm( comm )
+        , _offset( offset )
+        , _ranks( ranks )
+        , _indices( indices )
+        , _values( values )
+        , _plan( plan )
+        , _domain_map( domain_map )
+        , _range_map( range_map )
+    {
+        DTK_REQUIRE( _plan.getNumberOfRequests() == _indices.extent_int( 0 ) );
+        DTK_REQUIRE( _values.extent( 0 ) == _indices.extent( 0 ) );
+        DTK_REQUIRE( _offset.extent( 0 ) <=
+                     _range_map->getNodeNumElements() + 1 );
+    }
+
+    Teuchos::RCP<const Map> getDomainMap() const override
+    {
+        return _domain_map;
+    }
+
+    Teuchos::RCP<const Map> getRangeMap() const override { return _range_map; }
+
+    void
+    apply( const MultiVector &X, MultiVector &Y,
+           Teuchos::ETransp mode = Teuchos::NO_TRANS,
+           Scalar alpha = Teuchos::ScalarTraits<Scalar>::one(),
+           Scalar beta = Teuchos::ScalarTraits<Scalar>::zero() ) const override
+    {
+        DTK_REQUIRE( mode == Teuchos::NO_TRANS || mode == Teuchos::TRANS );
+        DTK_REQUIRE( X.getNumVectors() == Y.getNumVectors() );
+
+        if ( mode == Teuchos::TRANS )
+        {
+            applyTranspose( X, Y, alpha, beta );
+            return;
+        }
+
+        DTK_REQUIRE( _domain_map->isSameAs( *( X.getMap() ) ) );
+        DTK_REQUIRE( _range_map->isSameAs( *( Y.getMap() ) ) );
+
+        // Retrieve the entries of X associated with the neighbors.
+        auto x_neighbors = _plan.fetch( X.getLocalViewDevice() );
+
+        int const n_rows = _offset.extent_int( 0 ) - 1;
+        int const num_vec = X.getNumVectors();
+
+        // To avoid capturing *this
+        auto offset = _offset;
+        auto values = _values;
+
+        Y.scale( beta );
+
+        auto y_view = Y.getLocalViewDevice();
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "basis_matrix::apply" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_rows ),
+            KOKKOS_LAMBDA( int const i ) {
+                for ( int k = 0; k < num_vec; ++k )
+                {
+                    Scalar sum = 0.;
+                    for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                        sum += values( j ) * x_neighbors( j, k );
+                    y_view( i, k ) += alpha * sum;
+                }
+            } );
+    }
+
+    bool hasTransposeApply() const override { return true; }
+
+    // Neighbor lists and values of the radial basis function.
+    Kokkos::View<int const *, DeviceType> getOffset() const { return _offset; }
+    Kokkos::View<int const *, DeviceType> getRanks() const { return _ranks; }
+    Kokkos::View<int const *, DeviceType> getIndices() const
+    {
+        return _indices;
+    }
+    Kokkos::View<double const *, DeviceType> getValues() const
+    {
+        return _values;
+    }
+
+    /**
+     * Assemble the operator into a CrsMatrix. The global column indices, the
+     * column map, and the local matrix are all computed on the device and the
+     * matrix is completed without going through insertGlobalValues().
+     * Collective.
+     */
+    Teuchos::RCP<CrsMatrix> buildCrsMatrix() const
+    {
+        using local_matrix_type = typename CrsMatrix::local_matrix_type;
+        using row_map_type =
+            typename local_matrix_type::row_map_type::non_const_type;
+        using entries_type =
+            typename local_matrix_type::index_type::non_const_type;
+        using values_type =
+            typename local_matrix_type::values_type::non_const_type;
+
+        // The global index of a point in the domain map is its local index
+        // shifted by the global index of the first point owned by its
+        // processor.
+        int comm_size;
+        MPI_Comm_size( _comm, &comm_size );
+        GlobalOrdinal const min_global_index =
+            _domain_map->getMinGlobalIndex();
+        Kokkos::View<GlobalOrdinal *, Kokkos::HostSpace> first_global_index(
+            "first_global_index", comm_size );
+        MPI_Allgather( &min_global_index, sizeof( GlobalOrdinal ), MPI_BYTE,
+                       first_global_index.data(), sizeof( GlobalOrdinal ),
+                       MPI_BYTE, _comm );
+        auto first_global_index_device = Kokkos::create_mirror_view_and_copy(
+            DeviceType{}, first_global_index );
+
+        int const n_entries = _indices.extent( 0 );
+        auto ranks = _ranks;
+        auto indices = _indices;
+        Kokkos::View<GlobalOrdinal *, DeviceType> global_columns(
+            "global_columns", n_entries );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "basis_matrix::global_columns" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_entries ),
+            KOKKOS_LAMBDA( int const j ) {
+                global_columns( j ) =
+                    first_global_index_device( ranks( j ) ) + indices( j );
+            } );
+
+        // The column map contains the unique global columns.
+        Kokkos::View<GlobalOrdinal *, DeviceType> sorted_columns(
+            "sorted_columns", n_entries );
+        Kokkos::deep_copy( sorted_columns, global_columns );
+        Kokkos::sort( sorted_columns );
+        int n_columns = 0;
+        Kokkos::parallel_reduce(
+            DTK_MARK_REGION( "basis_matrix::count_columns" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_entries ),
+            KOKKOS_LAMBDA( int const j, int &count ) {
+                if ( j == 0 || sorted_columns( j ) != sorted_columns( j - 1 ) )
+                    ++count;
+            },
+            n_columns );
+        Kokkos::View<GlobalOrdinal *, DeviceType> unique_columns(
+            "unique_columns", n_columns );
+        Kokkos::parallel_scan(
+            DTK_MARK_REGION( "basis_matrix::unique_columns" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_entries ),
+            KOKKOS_LAMBDA( int const j, int &update, bool final_pass ) {
+                if ( j == 0 || sorted_columns( j ) != sorted_columns( j - 1 ) )
+                {
+                    if ( final_pass )
+                        unique_columns( update ) = sorted_columns( j );
+                    ++update;
+                }
+            } );
+        auto column_map = Teuchos::rcp(
+            new Map( Teuchos::OrdinalTraits<Tpetra::global_size_t>::invalid(),
+                     unique_columns, _domain_map->getIndexBase(),
+                     _domain_map->getComm() ) );
+
+        // Local matrix. The local column index of an entry is the position
+        // of its global column in the sorted unique columns.
+        int const n_rows = _range_map->getNodeNumElements();
+        int const n_offset = _offset.extent_int( 0 );
+        auto offset = _offset;
+        row_map_type row_ptrs( "row_ptrs", n_rows + 1 );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "basis_matrix::row_ptrs" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_rows + 1 ),
+            KOKKOS_LAMBDA( int const i ) {
+                // Rows beyond the neighbor lists are empty.
+                row_ptrs( i ) = offset( i < n_offset ? i : n_offset - 1 );
+            } );
+        entries_type local_columns( "local_columns", n_entries );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "basis_matrix::local_columns" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_entries ),
+            KOKKOS_LAMBDA( int const j ) {
+                int first = 0;
+                int last = n_columns;
+                while ( last - first > 1 )
+                {
+                    int const middle = ( first + last ) / 2;
+                    if ( unique_columns( middle ) <= global_columns( j ) )
+                        first = middle;
+                    else
+                        last = middle;
+                }
+                local_columns( j ) = first;
+            } );
+        values_type values( "values", n_entries );
+        Kokkos::deep_copy( values, _values );
+
+        auto crs_matrix = Teuchos::rcp( new CrsMatrix(
+            _range_map, column_map, row_ptrs, local_columns, values ) );
+        crs_matrix->expertStaticFillComplete( _domain_map, _range_map );
+        DTK_ENSURE( crs_matrix->isFillComplete() );
+
+        return crs_matrix;
+    }
+
+  private:
+    // Y = beta Y + alpha M^T X. The entries of a row are multiplied by the
+    // entry of X associated with the row and sent back to the owners of their
+    // columns, which sum them.
+    void applyTranspose( const MultiVector &X, MultiVector &Y, Scalar alpha,
+                         Scalar beta ) const
+    {
+        DTK_REQUIRE( _range_map->isSameAs( *( X.getMap() ) ) );
+        DTK_REQUIRE( _domain_map->isSameAs( *( Y.getMap() ) ) );
+
+        int const n_rows = _offset.extent_int( 0 ) - 1;
+        int const num_vec = X.getNumVectors();
+
+        auto offset = _offset;
+        auto values = _values;
+
+        auto x_view = X.getLocalViewDevice();
+        Kokkos::View<Scalar **, DeviceType> contributions(
+            "contributions", _indices.extent( 0 ), num_vec );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "basis_matrix::apply_transpose" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_rows ),
+            KOKKOS_LAMBDA( int const i ) {
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                    for ( int k = 0; k < num_vec; ++k )
+                        contributions( j, k ) =
+                            alpha * values( j ) * x_view( i, k );
+            } );
+
+        Y.scale( beta );
+
+        _plan.push( contributions, Y.getLocalViewDevice() );
+    }
+
+    MPI_Comm _comm;
+    Kokkos::View<int const *, DeviceType> _offset;
+    Kokkos::View<int const *, DeviceType> _ranks;
+    Kokkos::View<int const *, DeviceType> _indices;
+    Kokkos::View<double const *, DeviceType> _values;
+    Details::CommunicationPlan<DeviceType> _plan;
+
+    Teuchos::RCP<const Map> _domain_map;
+    Teuchos::RCP<const Map> _range_map;
+};
+
+} // end namespace DataTransferKit
+
+#endif
@@ -0,0 +1,121 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DETAILS_COINCIDENT_POINTS_HPP
+#define DTK_DETAILS_COINCIDENT_POINTS_HPP
+
+#include <ArborX.hpp>
+#include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <mpi.h>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+
+/**
+ * Detection of the coincident points of a distributed cloud, e.g. the nodes
+ * shared by several elements or the ghosted points owned by several
+ * processors. Every point searches the points within the tolerance, on all
+ * the processors, and represents its cluster unless it finds one with a lower
+ * rank, or the same rank and a lower local index.
+ *
+ * The tolerance is meant to be much smaller than the distance between
+ * distinct points. In a chain of points that are each within the tolerance of
+ * the next one, only the first one is kept.
+ */
+template <typename DeviceType>
+struct CoincidentPointsImpl
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    /**
+     * Return the local indices of the points of this processor that
+     * represent their cluster, in increasing order. @param points are in 3D.
+     * Collective.
+     */
+    static Kokkos::View<int *, DeviceType>
+    findRepresentatives( MPI_Comm comm,
+                         Kokkos::View<Coordinate const **, DeviceType> points,
+                         double tolerance )
+    {
+        DTK_REQUIRE( tolerance > 0. );
+        DTK_REQUIRE( points.extent( 1 ) == 3 );
+
+        int comm_rank;
+        MPI_Comm_rank( comm, &comm_rank );
+
+        int const n_points = points.extent_int( 0 );
+
+        ArborX::DistributedSearchTree<DeviceType> tree( comm, points );
+        Kokkos::View<ArborX::Intersects<ArborX::Sphere> *, DeviceType> queries(
+            "queries", n_points );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "coincident_points::setup_queries" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            KOKKOS_LAMBDA( int i ) {
+                ArborX::Point const point = {
+                    {points( i, 0 ), points( i, 1 ), points( i, 2 )}};
+                queries( i ) =
+                    ArborX::intersects( ArborX::Sphere{point, tolerance} );
+            } );
+        Kokkos::fence();
+        Kokkos::View<int *, DeviceType> indices( "indices", 0 );
+        Kokkos::View<int *, DeviceType> offset( "offset", 0 );
+        Kokkos::View<int *, DeviceType> ranks( "ranks", 0 );
+        tree.query( queries, indices, offset, ranks );
+
+        Kokkos::View<int *, DeviceType> flags( "flags", n_points );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "coincident_points::flag_representatives" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            KOKKOS_LAMBDA( int i ) {
+                flags( i ) = 1;
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                    if ( ranks( j ) < comm_rank ||
+                         ( ranks( j ) == comm_rank && indices( j ) < i ) )
+                        flags( i ) = 0;
+            } );
+
+        Kokkos::View<int *, DeviceType> representative_offset(
+            "offset", n_points + 1 );
+        Kokkos::parallel_scan(
+            DTK_MARK_REGION( "coincident_points::count_representatives" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points + 1 ),
+            KOKKOS_LAMBDA( int i, int &update, bool final_pass ) {
+                if ( final_pass )
+                    representative_offset( i ) = update;
+                if ( i < n_points )
+                    update += flags( i );
+            } );
+        Kokkos::View<int *, DeviceType> representatives(
+            "representatives", ArborX::lastElement( representative_offset ) );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "coincident_points::extract_representatives" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            KOKKOS_LAMBDA( int i ) {
+                if ( flags( i ) )
+                    representatives( representative_offset( i ) ) = i;
+            } );
+        Kokkos::fence();
+
+        return representatives;
+    }
+};
+
+} // namespace Details
+} // namespace DataTransferKit
+
+#endif
@@ -0,0 +1,217 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DETAILS_COMMUNICATION_CONTEXT_HPP
+#define DTK_DETAILS_COMMUNICATION_CONTEXT_HPP
+
+#include <DTK_DBC.hpp>
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+
+/**
+ * Private communicator and message tags of the communication plans built on a
+ * user communicator. The context is created by the first plan built on the
+ * communicator, attached to it (MPI attribute caching), and freed with it, so
+ * that the communicator is duplicated only once.
+ *
+ * The plans exchange their messages on the duplicate so that they never match
+ * the messages of the application, and every plan reserves its own tags so
+ * that the messages of plans in flight at the same time never match each
+ * other. The tags of a plan are given back when its last copy is destroyed
+ * (see TagReservation).
+ */
+class CommunicationContext
+{
+  public:
+    /**
+     * Return the context of @param comm. Collective the first time it is
+     * called on a communicator. The plans are built collectively, so all the
+     * processors reserve the same tags.
+     */
+    static CommunicationContext &get( MPI_Comm comm )
+    {
+        int const key = keyval();
+        CommunicationContext *context;
+        int found;
+        MPI_Comm_get_attr( comm, key, &context, &found );
+        if ( !found )
+        {
+            context = new CommunicationContext( comm );
+            MPI_Comm_set_attr( comm, key, context );
+        }
+        return *context;
+    }
+
+    CommunicationContext( CommunicationContext const & ) = delete;
+    CommunicationContext &operator=( CommunicationContext const & ) = delete;
+
+    // Private duplicate of the user communicator.
+    MPI_Comm getComm() const { return _comm; }
+
+    /**
+     * Reserve @param n consecutive tags that are not reserved on any
+     * processor and return the first one. Collective. The tags are searched
+     * after the last reservation first, then from zero once the upper bound
+     * of the implementation is reached. Throw if there is no such block,
+     * i.e. if too many plans are alive, rather than share tags with a plan
+     * that may have messages in flight.
+     */
+    int reserveTags( int n )
+    {
+        DTK_REQUIRE( n > 0 && n <= _tag_ub );
+        // The processors may have released different tags, e.g. when only
+        // some of them still hold a copy of a plan, so they agree on a block
+        // that is free everywhere. The candidate only increases so the loop
+        // ends.
+        long long const none = _tag_ub + 1LL;
+        long long tag = _next_tag;
+        for ( bool wrapped = false;; )
+        {
+            long long const local = firstFreeTags( tag, n );
+            long long global;
+            MPI_Allreduce( &local, &global, 1, MPI_LONG_LONG, MPI_MAX,
+                           _comm );
+            if ( global == none )
+            {
+                DTK_INSIST( !wrapped );
+                wrapped = true;
+                tag = 0;
+            }
+            else if ( global == tag )
+                break;
+            else
+                tag = global;
+        }
+        _reserved[tag] = n;
+        _next_tag = tag + n;
+        return tag;
+    }
+
+    /**
+     * Give back the tags reserved by the reserveTags() call that returned
+     * @param tag. Not collective.
+     */
+    void releaseTags( int tag ) { _reserved.erase( tag ); }
+
+  private:
+    // First of the @param n consecutive tags from @param first that are not
+    // reserved on this processor, or the upper bound plus one if there is
+    // none.
+    long long firstFreeTags( long long first, int n ) const
+    {
+        // The reserved blocks are sorted by their first tag and do not
+        // overlap.
+        auto it = _reserved.upper_bound( first );
+        if ( it != _reserved.begin() )
+        {
+            auto const previous = std::prev( it );
+            first = std::max<long long>( first,
+                                         previous->first + previous->second );
+        }
+        for ( ; it != _reserved.end() && it->first < first + n; ++it )
+            first = std::max<long long>( first, it->first + it->second );
+        return first + n - 1 <= _tag_ub ? first : _tag_ub + 1LL;
+    }
+
+    explicit CommunicationContext( MPI_Comm comm )
+        : _next_tag( 0 )
+    {
+        MPI_Comm_dup( comm, &_comm );
+        int *tag_ub;
+        int found;
+        MPI_Comm_get_attr( _comm, MPI_TAG_UB, &tag_ub, &found );
+        // The standard guarantees at least 32767.
+        _tag_ub = found ? *tag_ub : 32767;
+    }
+
+    ~CommunicationContext()
+    {
+        MPI_Comm_free( &_comm );
+    }
+
+    static int deleteAttribute( MPI_Comm, int, void *attribute, void * )
+    {
+        delete static_cast<CommunicationContext *>( attribute );
+        return MPI_SUCCESS;
+    }
+
+    static int keyval()
+    {
+        static int key = MPI_KEYVAL_INVALID;
+        if ( key == MPI_KEYVAL_INVALID )
+            MPI_Comm_create_keyval( MPI_COMM_NULL_COPY_FN,
+                                    &CommunicationContext::deleteAttribute,
+                                    &key, nullptr );
+        return key;
+    }
+
+    MPI_Comm _comm;
+    int _tag_ub;
+    long long _next_tag;
+    // First tag and number of tags of the blocks in use.
+    std::map<int, int> _reserved;
+
+    friend class TagReservation;
+};
+
+/**
+ * Block of tags reserved on the context of a communicator, which is released
+ * when this object is destroyed. The copies of a plan share it.
+ */
+class TagReservation
+{
+  public:
+    // Collective over @param comm.
+    TagReservation( MPI_Comm comm, int n )
+        : _comm( comm )
+        , _tag( CommunicationContext::get( comm ).reserveTags( n ) )
+    {
+    }
+
+    TagReservation( TagReservation const & ) = delete;
+    TagReservation &operator=( TagReservation const & ) = delete;
+
+    ~TagReservation()
+    {
+        // The context goes away with the communicator.
+        int finalized;
+        MPI_Finalized( &finalized );
+        if ( finalized )
+            return;
+        CommunicationContext *context;
+        int found;
+        MPI_Comm_get_attr( _comm, CommunicationContext::keyval(), &context,
+                           &found );
+        if ( found )
+            context->releaseTags( _tag );
+    }
+
+    int getTag() const { return _tag; }
+
+  private:
+    MPI_Comm _comm;
+    int _tag;
+};
+
+} // namespace Details
+} // namespace DataTransferKit
+
+#endif
@@ -0,0 +1,707 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DETAILS_COMMUNICATION_PLAN_HPP
+#define DTK_DETAILS_COMMUNICATION_PLAN_HPP
+
+#include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+#include <DTK_DetailsCommunicationContext.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+
+/**
+ * Values in flight between CommunicationPlan::fetchBegin() and
+ * CommunicationPlan::fetchEnd(). The host buffers must outlive the MPI
+ * requests, hence they are owned by this object.
+ */
+template <typename ValueType>
+struct PendingFetch
+{
+    Kokkos::View<ValueType **, Kokkos::LayoutRight, Kokkos::HostSpace>
+        export_buffer;
+    Kokkos::View<ValueType **, Kokkos::LayoutRight, Kokkos::HostSpace>
+        import_buffer;
+    std::vector<MPI_Request> requests;
+};
+
+/**
+ * Persistent communication pattern to retrieve values that live on other
+ * processors.
+ *
+ * The plan is built once from a list of (rank, index) pairs. Every pair
+ * designates an entry owned by processor `rank` at position `index` in its
+ * local array. The constructor is collective: it exchanges the requested
+ * indices so that each owner knows what it must send and to whom. Afterwards,
+ * fetch() only moves the values around, using point-to-point messages with
+ * the neighboring processors. This is the same operation as
+ * NearestNeighborOperatorImpl::fetch() without rebuilding the communication
+ * pattern and shipping the indices on every call. A pair that appears several
+ * times, e.g. a source point that is a neighbor of many target points, is
+ * only transferred once and expanded on the receiving side.
+ *
+ * fetch() is also available in split phase: fetchBegin() packs the values and
+ * posts non-blocking sends and receives, fetchEnd() waits for the messages
+ * and unpacks them. The caller can do useful work in between.
+ *
+ * The messages go through a private duplicate of the communicator with tags
+ * that belong to the plan (see CommunicationContext), so the exchanges of
+ * several plans can be in flight at the same time, in any order, alongside
+ * the messages of the application. fetchSubset() and push() have their own
+ * tags so they may be called while a fetch of the same plan is in flight.
+ * The tags are released when the last copy of the plan is destroyed.
+ *
+ * push() goes the other way: it sends one value per pair back to the owner,
+ * which adds it to the corresponding entry. It is used to apply the transpose
+ * of the operators.
+ */
+template <typename DeviceType>
+class CommunicationPlan
+{
+  public:
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    CommunicationPlan()
+        : _comm( MPI_COMM_NULL )
+        , _plan_comm( MPI_COMM_NULL )
+        , _tag( 0 )
+        , _n_requests( 0 )
+        , _export_indices( "export_indices", 0 )
+        , _import_positions( "import_positions", 0 )
+        , _import_indices( "import_indices", 0 )
+        , _import_owners( "import_owners", 0 )
+    {
+    }
+
+    /**
+     * Build the plan that fetches the entries designated by the (rank, index)
+     * pairs @param ranks and @param indices.
+     */
+    CommunicationPlan( MPI_Comm comm,
+                       Kokkos::View<int const *, DeviceType> ranks,
+                       Kokkos::View<int const *, DeviceType> indices )
+        : _comm( comm )
+        , _n_requests( ranks.extent( 0 ) )
+        , _export_indices( "export_indices", 0 )
+        , _import_positions( "import_positions", 0 )
+        , _import_indices( "import_indices", 0 )
+        , _import_owners( "import_owners", 0 )
+    {
+        DTK_REQUIRE( ranks.extent( 0 ) == indices.extent( 0 ) );
+
+        auto &context = CommunicationContext::get( _comm );
+        _plan_comm = context.getComm();
+        _tags = std::make_shared<TagReservation>( _comm, n_tags );
+        _tag = _tags->getTag();
+
+        int comm_size;
+        MPI_Comm_size( _comm, &comm_size );
+
+        auto ranks_host =
+            Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, ranks );
+        auto indices_host =
+            Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, indices );
+
+        // Group the requests by owning processor and, within a processor, by
+        // local index. A value that is requested several times, which is
+        // typical when neighborhoods overlap, is transferred only once and
+        // then copied to all the positions where it was requested.
+        std::vector<int> order( _n_requests );
+        std::iota( order.begin(), order.end(), 0 );
+        std::sort( order.begin(), order.end(), [&]( int i, int j ) {
+            return ranks_host( i ) < ranks_host( j ) ||
+                   ( ranks_host( i ) == ranks_host( j ) &&
+                     indices_host( i ) < indices_host( j ) );
+        } );
+
+        std::vector<int> import_counts( comm_size, 0 );
+        std::vector<int> requested_indices;
+        requested_indices.reserve( _n_requests );
+        std::vector<int> requested_ranks;
+        requested_ranks.reserve( _n_requests );
+        Kokkos::realloc( _import_positions, _n_requests );
+        auto import_positions_host =
+            Kokkos::create_mirror_view( _import_positions );
+        for ( int k = 0; k < _n_requests; ++k )
+        {
+            int const i = order[k];
+            DTK_REQUIRE( ranks_host( i ) >= 0 && ranks_host( i ) < comm_size );
+            bool const is_duplicate =
+                k > 0 && ranks_host( order[k - 1] ) == ranks_host( i ) &&
+                indices_host( order[k - 1] ) == indices_host( i );
+            if ( !is_duplicate )
+            {
+                requested_indices.push_back( indices_host( i ) );
+                requested_ranks.push_back( ranks_host( i ) );
+                ++import_counts[ranks_host( i )];
+            }
+            import_positions_host( i ) = requested_indices.size() - 1;
+        }
+        Kokkos::deep_copy( _import_positions, import_positions_host );
+        Kokkos::realloc( _import_indices, requested_indices.size() );
+        Kokkos::deep_copy(
+            _import_indices,
+            Kokkos::View<int const *, Kokkos::HostSpace,
+                         Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+                requested_indices.data(), requested_indices.size() ) );
+        Kokkos::realloc( _import_owners, requested_ranks.size() );
+        Kokkos::deep_copy(
+            _import_owners,
+            Kokkos::View<int const *, Kokkos::HostSpace,
+                         Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+                requested_ranks.data(), requested_ranks.size() ) );
+        std::vector<int> import_offsets( comm_size + 1, 0 );
+        for ( int r = 0; r < comm_size; ++r )
+            import_offsets[r + 1] = import_offsets[r] + import_counts[r];
+
+        // Let the owners know how many values each processor needs.
+        std::vector<int> export_counts( comm_size, 0 );
+        MPI_Alltoall( import_counts.data(), 1, MPI_INT, export_counts.data(),
+                      1, MPI_INT, _plan_comm );
+
+        for ( int r = 0; r < comm_size; ++r )
+        {
+            if ( import_counts[r] > 0 )
+            {
+                _import_ranks.push_back( r );
+                _import_offsets.push_back( import_offsets[r + 1] );
+            }
+            if ( export_counts[r] > 0 )
+            {
+                _export_ranks.push_back( r );
+                _export_offsets.push_back( _export_offsets.back() +
+                                           export_counts[r] );
+            }
+        }
+
+        // Send the indices of the requested values to their owners. This is
+        // the only time indices are communicated.
+        Kokkos::realloc( _export_indices, _export_offsets.back() );
+        auto export_indices_host =
+            Kokkos::create_mirror_view( _export_indices );
+        exchange( requested_indices.data(), export_indices_host.data(), 1,
+                  /* reverse = */ true, _tag + values_tag );
+        Kokkos::deep_copy( _export_indices, export_indices_host );
+    }
+
+    MPI_Comm getComm() const { return _comm; }
+
+    /**
+     * Number of entries that this processor sends on every fetch.
+     */
+    int getNumberOfExports() const { return _export_offsets.back(); }
+
+    /**
+     * Number of entries that this processor receives on every fetch. Values
+     * requested several times are only received once so this is the number
+     * of unique (rank, index) pairs that the plan was built from.
+     */
+    int getNumberOfImports() const { return _import_offsets.back(); }
+
+    /**
+     * Number of (rank, index) pairs that the plan was built from.
+     */
+    int getNumberOfRequests() const { return _n_requests; }
+
+    /**
+     * Position of each request in the imported values.
+     */
+    Kokkos::View<int const *, DeviceType> getImportPositions() const
+    {
+        return _import_positions;
+    }
+
+    /**
+     * Rank of the owner of each imported value, in the order in which they
+     * are received.
+     */
+    Kokkos::View<int const *, DeviceType> getImportRanks() const
+    {
+        return _import_owners;
+    }
+
+    /**
+     * Local index on its owner of each imported value, in the order in which
+     * they are received.
+     */
+    Kokkos::View<int const *, DeviceType> getImportIndices() const
+    {
+        return _import_indices;
+    }
+
+    /**
+     * Retrieve the values associated with the (rank, index) pairs given at
+     * construction. @param values is a rank-1 or rank-2 view whose first
+     * dimension is indexed by the local indices. The returned view has as
+     * many rows as there are requests and the same number of columns as
+     * @param values.
+     */
+    template <typename View>
+    typename View::non_const_type fetch( View values ) const
+    {
+        int const n_components = values.extent( 1 );
+
+        auto pending = fetchBegin( values );
+
+        auto values_out =
+            View::rank == 1
+                ? typename View::non_const_type( values.label(), _n_requests )
+                : typename View::non_const_type( values.label(), _n_requests,
+                                                 n_components );
+        fetchEnd( pending, values_out );
+
+        return values_out;
+    }
+
+    /**
+     * Start retrieving @param values. The returned object must be passed to
+     * fetchEnd() to complete the operation. @param values may be modified as
+     * soon as this function returns.
+     */
+    template <typename View>
+    PendingFetch<typename View::non_const_value_type>
+    fetchBegin( View values ) const
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "fetch() requires rank-1 or rank-2 view arguments" );
+
+        using ValueType = typename View::non_const_value_type;
+        using BufferType = Kokkos::View<ValueType **, Kokkos::LayoutRight,
+                                        typename View::memory_space>;
+
+        int const n_components = values.extent( 1 );
+        int const n_exports = _export_indices.extent( 0 );
+
+        // Pack the values the other processors asked for.
+        BufferType export_buffer( "export_buffer", n_exports, n_components );
+        auto export_indices = _export_indices;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "communication_plan::pack" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_exports ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int j = 0; j < n_components; ++j )
+                    export_buffer( i, j ) =
+                        values.access( export_indices( i ), j );
+            } );
+        Kokkos::fence();
+
+        PendingFetch<ValueType> pending;
+        pending.export_buffer = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{}, export_buffer );
+        pending.import_buffer = decltype( pending.import_buffer )(
+            "import_buffer", getNumberOfImports(), n_components );
+        pending.requests = exchangeBegin(
+            pending.export_buffer.data(), _export_offsets,
+            pending.import_buffer.data(), _import_offsets, n_components,
+            /* reverse = */ false, _tag + values_tag );
+
+        return pending;
+    }
+
+    /**
+     * Wait for the values requested by fetchBegin() and write them in
+     * @param values_out, in the order of the (rank, index) pairs given at
+     * construction.
+     */
+    template <typename View>
+    void fetchEnd( PendingFetch<typename View::non_const_value_type> &pending,
+                   View values_out ) const
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "fetch() requires rank-1 or rank-2 view arguments" );
+
+        int const n_components = pending.import_buffer.extent( 1 );
+        DTK_REQUIRE( values_out.extent_int( 0 ) == _n_requests );
+        DTK_REQUIRE( values_out.extent_int( 1 ) == n_components );
+
+        MPI_Waitall( pending.requests.size(), pending.requests.data(),
+                     MPI_STATUSES_IGNORE );
+
+        auto import_buffer = Kokkos::create_mirror_view_and_copy(
+            typename View::memory_space{}, pending.import_buffer );
+
+        // Unpack the values in the order in which they were requested.
+        auto import_positions = _import_positions;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "communication_plan::unpack" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, _n_requests ),
+            KOKKOS_LAMBDA( int i ) {
+                // TODO Using Kokkos::View::access() is a workaround.
+                // We should write specializations for rank-1 and rank-2
+                // objects.
+                for ( int j = 0; j < n_components; ++j )
+                    values_out.access( i, j ) =
+                        import_buffer( import_positions( i ), j );
+            } );
+        Kokkos::fence();
+    }
+
+    /**
+     * Same as fetch() but only retrieve the values of the requests whose
+     * positions in the (rank, index) pairs given at construction are listed in
+     * @param requests. The returned view has one row per entry of
+     * @param requests. The owners are first told which of their exports are
+     * needed, so only these values are transferred. All the neighbors of the
+     * plan must call this function, even with no request.
+     */
+    template <typename View>
+    typename View::non_const_type
+    fetchSubset( View values,
+                 Kokkos::View<int const *, DeviceType> requests ) const
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "fetch() requires rank-1 or rank-2 view arguments" );
+
+        using ValueType = typename View::non_const_value_type;
+        using BufferType = Kokkos::View<ValueType **, Kokkos::LayoutRight,
+                                        typename View::memory_space>;
+
+        int const n_components = values.extent( 1 );
+        int const n_selected = requests.extent( 0 );
+        int const n_imports = getNumberOfImports();
+        int const n_exports = getNumberOfExports();
+
+        // Mark the imported values that the selected requests need.
+        Kokkos::View<char *, DeviceType> import_mask( "import_mask",
+                                                      n_imports );
+        auto import_positions = _import_positions;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "communication_plan::mask" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_selected ),
+            KOKKOS_LAMBDA( int i ) {
+                import_mask( import_positions( requests( i ) ) ) = 1;
+            } );
+        Kokkos::fence();
+        auto import_mask_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{}, import_mask );
+
+        // Tell the owners which of their exports are needed.
+        std::vector<char> export_mask( n_exports );
+        auto requests_mask = exchangeBegin(
+            import_mask_host.data(), _import_offsets, export_mask.data(),
+            _export_offsets, 1, /* reverse = */ true, _tag + mask_tag );
+        MPI_Waitall( requests_mask.size(), requests_mask.data(),
+                     MPI_STATUSES_IGNORE );
+
+        // The selected values are sent back to back. The offsets of the
+        // blocks of each neighbor follow from the masks on both sides.
+        auto const compact = []( char const *mask, int n ) {
+            std::vector<int> positions( n + 1, 0 );
+            for ( int i = 0; i < n; ++i )
+                positions[i + 1] = positions[i] + mask[i];
+            return positions;
+        };
+        auto const import_compact =
+            compact( import_mask_host.data(), n_imports );
+        auto const export_compact = compact( export_mask.data(), n_exports );
+        std::vector<int> import_offsets;
+        for ( int offset : _import_offsets )
+            import_offsets.push_back( import_compact[offset] );
+        std::vector<int> export_offsets;
+        for ( int offset : _export_offsets )
+            export_offsets.push_back( export_compact[offset] );
+
+        // Pack the selected exports.
+        Kokkos::View<int *, Kokkos::HostSpace> selected_exports_host(
+            "selected_exports", export_offsets.back() );
+        for ( int i = 0; i < n_exports; ++i )
+            if ( export_mask[i] )
+                selected_exports_host( export_compact[i] ) = i;
+        auto selected_exports = Kokkos::create_mirror_view_and_copy(
+            typename DeviceType::memory_space{}, selected_exports_host );
+        BufferType export_buffer( "export_buffer", export_offsets.back(),
+                                  n_components );
+        auto export_indices = _export_indices;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "communication_plan::pack" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, export_offsets.back() ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int j = 0; j < n_components; ++j )
+                    export_buffer( i, j ) = values.access(
+                        export_indices( selected_exports( i ) ), j );
+            } );
+        Kokkos::fence();
+
+        auto export_buffer_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{}, export_buffer );
+        Kokkos::View<ValueType **, Kokkos::LayoutRight, Kokkos::HostSpace>
+            import_buffer_host( "import_buffer", import_offsets.back(),
+                                n_components );
+        auto requests_values = exchangeBegin(
+            export_buffer_host.data(), export_offsets,
+            import_buffer_host.data(), import_offsets, n_components,
+            /* reverse = */ false, _tag + subset_tag );
+        MPI_Waitall( requests_values.size(), requests_values.data(),
+                     MPI_STATUSES_IGNORE );
+        auto import_buffer = Kokkos::create_mirror_view_and_copy(
+            typename View::memory_space{}, import_buffer_host );
+
+        // Unpack the values in the order of the selected requests.
+        Kokkos::View<int *, DeviceType> compact_positions(
+            "compact_positions", n_imports + 1 );
+        Kokkos::deep_copy(
+            compact_positions,
+            Kokkos::View<int const *, Kokkos::HostSpace,
+                         Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+                import_compact.data(), import_compact.size() ) );
+        auto values_out =
+            View::rank == 1
+                ? typename View::non_const_type( values.label(), n_selected )
+                : typename View::non_const_type( values.label(), n_selected,
+                                                 n_components );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "communication_plan::unpack" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_selected ),
+            KOKKOS_LAMBDA( int i ) {
+                int const k =
+                    compact_positions( import_positions( requests( i ) ) );
+                for ( int j = 0; j < n_components; ++j )
+                    values_out.access( i, j ) = import_buffer( k, j );
+            } );
+        Kokkos::fence();
+
+        return values_out;
+    }
+
+    /**
+     * Same as fetch() but return each imported value once, in the order of
+     * getImportRanks() and getImportIndices(), instead of one value per
+     * request. The values are returned as a two-dimensional view with one
+     * column per component and contiguous rows.
+     */
+    template <typename View>
+    Kokkos::View<typename View::non_const_value_type **, Kokkos::LayoutRight,
+                 DeviceType>
+    fetchImports( View values ) const
+    {
+        auto pending = fetchBegin( values );
+        MPI_Waitall( pending.requests.size(), pending.requests.data(),
+                     MPI_STATUSES_IGNORE );
+
+        Kokkos::View<typename View::non_const_value_type **,
+                     Kokkos::LayoutRight, DeviceType>
+            imported_values( values.label(), pending.import_buffer.extent( 0 ),
+                             pending.import_buffer.extent( 1 ) );
+        Kokkos::deep_copy( imported_values, pending.import_buffer );
+        return imported_values;
+    }
+
+    /**
+     * Reverse of fetch(). @param values has one row per (rank, index) pair
+     * given at construction and each row is added to the entry of
+     * @param values_out designated by its pair, on the processor that owns
+     * it. @param values_out is not zeroed. The contributions to the same
+     * entry are summed on this processor before being sent so that, as in
+     * fetch(), every entry is transferred at most once per processor.
+     */
+    template <typename View, typename OutView>
+    void push( View values, OutView values_out ) const
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "push() requires rank-1 or rank-2 view arguments" );
+        static_assert( static_cast<int>( View::rank ) ==
+                           static_cast<int>( OutView::rank ),
+                       "push() requires views of the same rank" );
+
+        using ValueType = typename OutView::non_const_value_type;
+        using BufferType = Kokkos::View<ValueType **, Kokkos::LayoutRight,
+                                        typename OutView::memory_space>;
+
+        int const n_components = values.extent( 1 );
+        DTK_REQUIRE( values.extent_int( 0 ) == _n_requests );
+        DTK_REQUIRE( values_out.extent_int( 1 ) == n_components );
+
+        // Sum the contributions to the same entry.
+        BufferType import_buffer( "import_buffer", getNumberOfImports(),
+                                  n_components );
+        auto import_positions = _import_positions;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "communication_plan::combine" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, _n_requests ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int j = 0; j < n_components; ++j )
+                    Kokkos::atomic_add(
+                        &import_buffer( import_positions( i ), j ),
+                        static_cast<ValueType>( values.access( i, j ) ) );
+            } );
+        Kokkos::fence();
+
+        // Send the sums back to the owners.
+        auto import_buffer_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{}, import_buffer );
+        Kokkos::View<ValueType **, Kokkos::LayoutRight, Kokkos::HostSpace>
+            export_buffer_host( "export_buffer", getNumberOfExports(),
+                                n_components );
+        exchange( import_buffer_host.data(), export_buffer_host.data(),
+                  n_components, /* reverse = */ true, _tag + push_tag );
+        auto export_buffer = Kokkos::create_mirror_view_and_copy(
+            typename OutView::memory_space{}, export_buffer_host );
+
+        // An entry that was requested by several processors receives several
+        // contributions.
+        auto export_indices = _export_indices;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "communication_plan::scatter_add" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, getNumberOfExports() ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int j = 0; j < n_components; ++j )
+                    Kokkos::atomic_add(
+                        &values_out.access( export_indices( i ), j ),
+                        export_buffer( i, j ) );
+            } );
+        Kokkos::fence();
+    }
+
+  private:
+    // Offsets from _tag of the tags of the messages of the plan.
+    enum
+    {
+        values_tag,
+        mask_tag,
+        subset_tag,
+        push_tag,
+        n_tags
+    };
+
+    // Exchange contiguous blocks of values with the neighbors on @param tag.
+    // In the forward direction, owners send the exported values and we
+    // receive the imported ones. In the reverse direction, the roles are
+    // swapped (this is used to send the requested indices to the owners at
+    // construction).
+    template <typename ValueType>
+    void exchange( ValueType const *send_buffer, ValueType *recv_buffer,
+                   int n_components, bool reverse, int tag ) const
+    {
+        auto requests = exchangeBegin(
+            send_buffer, reverse ? _import_offsets : _export_offsets,
+            recv_buffer, reverse ? _export_offsets : _import_offsets,
+            n_components, reverse, tag );
+        MPI_Waitall( requests.size(), requests.data(), MPI_STATUSES_IGNORE );
+    }
+
+    // Post the messages of exchange() and return without waiting for them to
+    // complete. The buffers must not be touched until the requests are done.
+    // The block of the k-th neighbor starts at row @param send_offsets[k] of
+    // the send buffer and ends at row @param send_offsets[k+1], and likewise
+    // for the receive buffer.
+    template <typename ValueType>
+    std::vector<MPI_Request>
+    exchangeBegin( ValueType const *send_buffer,
+                   std::vector<int> const &send_offsets, ValueType *recv_buffer,
+                   std::vector<int> const &recv_offsets, int n_components,
+                   bool reverse, int tag ) const
+    {
+        auto const &send_ranks = reverse ? _import_ranks : _export_ranks;
+        auto const &recv_ranks = reverse ? _export_ranks : _import_ranks;
+
+        int comm_rank;
+        MPI_Comm_rank( _comm, &comm_rank );
+
+        // Row offsets are multiplied in std::size_t to not overflow.
+        std::size_t const n = n_components;
+        std::size_t const packet_size = n * sizeof( ValueType );
+
+        std::vector<MPI_Request> requests;
+        requests.reserve( send_ranks.size() + recv_ranks.size() );
+        for ( unsigned int k = 0; k < recv_ranks.size(); ++k )
+            if ( recv_ranks[k] != comm_rank )
+            {
+                requests.emplace_back();
+                MPI_Irecv( recv_buffer + recv_offsets[k] * n,
+                           messageSize( recv_offsets[k], recv_offsets[k + 1],
+                                        packet_size ),
+                           MPI_BYTE, recv_ranks[k], tag, _plan_comm,
+                           &requests.back() );
+            }
+        for ( unsigned int k = 0; k < send_ranks.size(); ++k )
+            if ( send_ranks[k] != comm_rank )
+            {
+                requests.emplace_back();
+                MPI_Isend( send_buffer + send_offsets[k] * n,
+                           messageSize( send_offsets[k], send_offsets[k + 1],
+                                        packet_size ),
+                           MPI_BYTE, send_ranks[k], tag, _plan_comm,
+                           &requests.back() );
+            }
+
+        // Values that stay on this processor do not go through MPI.
+        auto const send_self =
+            std::find( send_ranks.begin(), send_ranks.end(), comm_rank );
+        auto const recv_self =
+            std::find( recv_ranks.begin(), recv_ranks.end(), comm_rank );
+        if ( send_self != send_ranks.end() )
+        {
+            DTK_CHECK( recv_self != recv_ranks.end() );
+            auto const ks = send_self - send_ranks.begin();
+            auto const kr = recv_self - recv_ranks.begin();
+            std::copy( send_buffer + send_offsets[ks] * n,
+                       send_buffer + send_offsets[ks + 1] * n,
+                       recv_buffer + recv_offsets[kr] * n );
+        }
+
+        return requests;
+    }
+
+    // Size in bytes of the message made of the rows [first, last) of a
+    // buffer with @param packet_size bytes per row. It is computed in
+    // std::size_t and must fit in the int count of MPI.
+    static int messageSize( int first, int last, std::size_t packet_size )
+    {
+        std::size_t const size =
+            static_cast<std::size_t>( last - first ) * packet_size;
+        DTK_INSIST( size <= static_cast<std::size_t>(
+                                std::numeric_limits<int>::max() ) );
+        return static_cast<int>( size );
+    }
+
+    MPI_Comm _comm;
+    // Duplicate of _comm on which the messages of the plan are exchanged.
+    MPI_Comm _plan_comm;
+    // Tags of the messages of the plan, shared by its copies, and the first
+    // of them.
+    std::shared_ptr<TagReservation const> _tags;
+    int _tag;
+    int _n_requests;
+
+    // Local indices of the values that we send to the other processors,
+    // grouped by destination.
+    Kokkos::View<int *, DeviceType> _export_indices;
+    std::vector<int> _export_ranks;
+    std::vector<int> _export_offsets = {0};
+
+    // Position in the received values of each request. The received values
+    // are grouped by source and do not contain duplicates.
+    Kokkos::View<int *, DeviceType> _import_positions;
+    // Local index on their owner and rank of the owner of the received
+    // values.
+    Kokkos::View<int *, DeviceType> _import_indices;
+    Kokkos::View<int *, DeviceType> _import_owners;
+    std::vector<int> _import_ranks;
+    std::vector<int> _import_offsets = {0};
+};
+
+} // namespace Details
+} // namespace DataTransferKit
+
+#endif
@@ -16,6 +16,10 @@
 #include <ArborX_DetailsKokkosExt.hpp> // ArithmeticTraits
 #include <DTK_CompactlySupportedRadialBasisFunctions.hpp>
 #include <DTK_DetailsSVDImpl.hpp>
+#include <DTK_PointCloudSearchTree.hpp>
+
+#include <cstddef>
+#include <type_traits>
 
 namespace DataTransferKit
 {
@@ -38,19 +42,107 @@ struct MovingLeastSquaresOperatorImpl
             DTK_MARK_REGION( "setup_queries" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
             KOKKOS_LAMBDA( int i ) {
-                queries( i ) = nearest(
-                    ArborX::Point{{target_points( i, 0 ), target_points( i, 1 ),
-                                   target_points( i, 2 )}},
-                    n_neighbors );
+                queries( i ) =
+                    nearest( makePoint( target_points, i ), n_neighbors );
             } );
         Kokkos::fence();
         return queries;
     }
 
+    static Kokkos::View<ArborX::Intersects<ArborX::Sphere> *, DeviceType>
+    makeRadiusQueries(
+        typename Kokkos::View<Coordinate **, DeviceType>::const_type
+            target_points,
+        double radius )
+    {
+        auto const n_points = target_points.extent( 0 );
+        Kokkos::View<ArborX::Intersects<ArborX::Sphere> *, DeviceType> queries(
+            "queries", n_points );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "setup_queries" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            KOKKOS_LAMBDA( int i ) {
+                queries( i ) = ArborX::intersects(
+                    ArborX::Sphere{makePoint( target_points, i ), radius} );
+            } );
+        Kokkos::fence();
+        return queries;
+    }
+
+    // Search the neighbors of the target points: their n_neighbors closest
+    // source points if support_radius is zero, and all the source points
+    // within support_radius otherwise.
+    static void findNeighbors(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        typename Kokkos::View<Coordinate **, DeviceType>::const_type
+            target_points,
+        unsigned int n_neighbors, double support_radius,
+        Kokkos::View<int *, DeviceType> &indices,
+        Kokkos::View<int *, DeviceType> &offset,
+        Kokkos::View<int *, DeviceType> &ranks )
+    {
+        DTK_REQUIRE( support_radius >= 0. );
+        if ( support_radius > 0. )
+            search_tree.query(
+                makeRadiusQueries( target_points, support_radius ), indices,
+                offset, ranks );
+        else
+            search_tree.query( makeKNNQueries( target_points, n_neighbors ),
+                               indices, offset, ranks );
+    }
+
+    // Convert the values to another scalar type on the device. The view is
+    // returned as is if it already holds values of that type.
+    template <typename Scalar, typename View>
+    static typename std::enable_if<
+        std::is_same<Scalar, typename View::non_const_value_type>::value,
+        View>::type
+    convertValues( View const &values )
+    {
+        return values;
+    }
+
+    template <typename Scalar, typename View>
+    static typename std::enable_if<
+        !std::is_same<Scalar, typename View::non_const_value_type>::value,
+        Kokkos::View<typename std::conditional<View::rank == 1, Scalar *,
+                                               Scalar **>::type,
+                     DeviceType>>::type
+    convertValues( View const &values )
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "convertValues() requires rank-1 or rank-2 views" );
+        using ConvertedView =
+            Kokkos::View<typename std::conditional<View::rank == 1, Scalar *,
+                                                   Scalar **>::type,
+                         DeviceType>;
+        int const n = values.extent_int( 0 );
+        int const n_components = values.extent( 1 );
+        auto converted =
+            View::rank == 1
+                ? ConvertedView( values.label(), n )
+                : ConvertedView( values.label(), n, n_components );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "convert_values" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int j = 0; j < n_components; ++j )
+                    converted.access( i, j ) =
+                        static_cast<Scalar>( values.access( i, j ) );
+            } );
+        Kokkos::fence();
+
+        return converted;
+    }
+
+    // The coefficients and the source values may be stored in single
+    // precision but the target values are always accumulated in double
+    // precision.
+    template <typename CoefficientType, typename ValueType>
     static Kokkos::View<double *, DeviceType> computeTargetValues(
         Kokkos::View<int const *, DeviceType> offset,
-        Kokkos::View<double const *, DeviceType> polynomial_coeffs,
-        Kokkos::View<double const *, DeviceType> source_values )
+        Kokkos::View<CoefficientType const *, DeviceType> polynomial_coeffs,
+        Kokkos::View<ValueType const *, DeviceType> source_values )
     {
         auto const n_target_points = offset.extent_int( 0 ) - 1;
         Kokkos::View<double *, DeviceType> target_values(
@@ -60,142 +152,192 @@ struct MovingLeastSquaresOperatorImpl
             DTK_MARK_REGION( "compute_values" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
             KOKKOS_LAMBDA( const int i ) {
-                target_values( i ) = 0.;
+                double value = 0.;
                 for ( int j = offset( i ); j < offset( i + 1 ); ++j )
-                    target_values( i ) +=
-                        polynomial_coeffs( j ) * source_values( j );
+                    value += static_cast<double>( polynomial_coeffs( j ) ) *
+                             static_cast<double>( source_values( j ) );
+                target_values( i ) = value;
             } );
         Kokkos::fence();
 
         return target_values;
     }
 
-    static Kokkos::View<Coordinate **, DeviceType> transformSourceCoordinates(
-        Kokkos::View<Coordinate const **, DeviceType> source_points,
+    template <typename CoefficientType, typename ValueType>
+    static Kokkos::View<double **, DeviceType> computeTargetValues(
         Kokkos::View<int const *, DeviceType> offset,
-        Kokkos::View<Coordinate const **, DeviceType> target_points )
+        Kokkos::View<CoefficientType const *, DeviceType> polynomial_coeffs,
+        Kokkos::View<ValueType const **, DeviceType> source_values )
     {
-        auto const n_source_points = source_points.extent( 0 );
-        auto const n_target_points = target_points.extent( 0 );
+        auto const n_target_points = offset.extent_int( 0 ) - 1;
+        auto const n_fields = source_values.extent_int( 1 );
+        Kokkos::View<double **, DeviceType> target_values(
+            std::string( "target_" ) + source_values.label(), n_target_points,
+            n_fields );
 
-        int const spatial_dim = 3;
-        DTK_REQUIRE( source_points.extent_int( 1 ) == spatial_dim );
-        DTK_REQUIRE( offset.extent( 0 ) == n_target_points + 1 );
+        // All the fields share the same coefficients so they are computed in
+        // the same kernel.
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "compute_values" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
+            KOKKOS_LAMBDA( const int i ) {
+                for ( int k = 0; k < n_fields; ++k )
+                    target_values( i, k ) = 0.;
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                {
+                    double const coeff =
+                        static_cast<double>( polynomial_coeffs( j ) );
+                    for ( int k = 0; k < n_fields; ++k )
+                        target_values( i, k ) +=
+                            coeff *
+                            static_cast<double>( source_values( j, k ) );
+                }
+            } );
+        Kokkos::fence();
+
+        return target_values;
+    }
+
+    // Transpose of computeTargetValues(): the contribution of the i-th target
+    // point to each of its neighbors. There is one row per neighbor, in the
+    // same order as the coefficients.
+    template <typename CoefficientType>
+    static Kokkos::View<double *, DeviceType> computeSourceContributions(
+        Kokkos::View<int const *, DeviceType> offset,
+        Kokkos::View<CoefficientType const *, DeviceType> polynomial_coeffs,
+        Kokkos::View<double const *, DeviceType> target_values )
+    {
+        auto const n_target_points = offset.extent_int( 0 ) - 1;
+        Kokkos::View<double *, DeviceType> contributions(
+            std::string( "source_" ) + target_values.label(),
+            polynomial_coeffs.extent( 0 ) );
 
-        // Change the coordinates of the source points to relative position to
-        // the target points
-        Kokkos::View<Coordinate **, DeviceType> new_source_points(
-            "transformed_source_coords", n_source_points, spatial_dim );
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "transform" ),
+            DTK_MARK_REGION( "compute_contributions" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
             KOKKOS_LAMBDA( const int i ) {
-                for ( int j = offset( i ); j < offset( i + 1 ); j++ )
-                    for ( int k = 0; k < spatial_dim; k++ )
-                        new_source_points( j, k ) =
-                            source_points( j, k ) - target_points( i, k );
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                    contributions( j ) =
+                        static_cast<double>( polynomial_coeffs( j ) ) *
+                        target_values( i );
             } );
+        Kokkos::fence();
 
-        return new_source_points;
+        return contributions;
     }
 
-    static Kokkos::View<double *, DeviceType>
-    computeRadius( Kokkos::View<Coordinate const **, DeviceType> source_points,
-                   Kokkos::View<int const *, DeviceType> offset )
+    template <typename CoefficientType>
+    static Kokkos::View<double **, DeviceType> computeSourceContributions(
+        Kokkos::View<int const *, DeviceType> offset,
+        Kokkos::View<CoefficientType const *, DeviceType> polynomial_coeffs,
+        Kokkos::View<double const **, DeviceType> target_values )
     {
-        unsigned int const n_target_points = offset.extent( 0 ) - 1;
-        Kokkos::View<double *, DeviceType> radius( "radius",
-                                                   source_points.extent( 0 ) );
+        auto const n_target_points = offset.extent_int( 0 ) - 1;
+        auto const n_fields = target_values.extent_int( 1 );
+        Kokkos::View<double **, DeviceType> contributions(
+            std::string( "source_" ) + target_values.label(),
+            polynomial_coeffs.extent( 0 ), n_fields );
 
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_radius" ),
+            DTK_MARK_REGION( "compute_contributions" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
-            KOKKOS_LAMBDA( int const i ) {
-                // If the source point and the target point are at the same
-                // position, the radius will be zero. This is a problem since we
-                // divide by the radius in the calculation of the radial basis
-                // function. To avoid this problem, the radius has a minimal
-                // positive value.
-                double distance =
-                    10. * KokkosExt::ArithmeticTraits::epsilon<double>::value;
+            KOKKOS_LAMBDA( const int i ) {
                 for ( int j = offset( i ); j < offset( i + 1 ); ++j )
                 {
-                    double new_distance = ArborX::Details::distance(
-                        ArborX::Point{{source_points( j, 0 ),
-                                       source_points( j, 1 ),
-                                       source_points( j, 2 )}},
-                        {0., 0., 0.} );
-
-                    if ( new_distance > distance )
-                        distance = new_distance;
+                    double const coeff =
+                        static_cast<double>( polynomial_coeffs( j ) );
+                    for ( int k = 0; k < n_fields; ++k )
+                        contributions( j, k ) = coeff * target_values( i, k );
                 }
-                // If a point is exactly on the boundary of the compact domain,
-                // its weight will be zero so we need to make sure that no point
-                // is exactly on the boundary.
-                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
-                    radius( j ) = 1.1 * distance;
             } );
+        Kokkos::fence();
 
-        return radius;
+        return contributions;
     }
 
-    // We need the third argument because otherwise the compiler cannot do the
+    // Radius of the support of the radial basis function associated with the
+    // target point i. It is support_radius if it is positive and it is
+    // computed from the coordinates of the neighbors otherwise.
+    KOKKOS_INLINE_FUNCTION static double
+    computeRadius( double const support_radius,
+                   Kokkos::View<int const *, DeviceType> const &offset,
+                   Kokkos::View<Coordinate const **, DeviceType> const
+                       &source_points,
+                   ArborX::Point const &target, int const i )
+    {
+        // The neighbors come from a search within support_radius so they are
+        // all in the support, but the weight of those exactly on its boundary
+        // is zero.
+        if ( support_radius > 0. )
+            return support_radius;
+
+        // If the source point and the target point are at the same position,
+        // the radius will be zero. This is a problem since we divide by the
+        // radius in the calculation of the radial basis function. To avoid
+        // this problem, the radius has a minimal positive value.
+        double distance =
+            10. * KokkosExt::ArithmeticTraits::epsilon<double>::value;
+        for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+        {
+            double const new_distance = ArborX::Details::distance(
+                makePoint( source_points, j ), target );
+            if ( new_distance > distance )
+                distance = new_distance;
+        }
+        // If a point is exactly on the boundary of the compact domain, its
+        // weight will be zero so we need to make sure that no point is exactly
+        // on the boundary.
+        return 1.1 * distance;
+    }
+
+    // Compute the weights of the neighbors of each target point, i.e. the
+    // radial basis function evaluated at their distance to the target point.
+    // We need the fourth argument because otherwise the compiler cannot do the
     // template deduction. For some unknown reason, explicitly choosing the
     // value of the template parameter does not work.
     template <typename RBF>
     static Kokkos::View<double *, DeviceType>
-    computeWeights( Kokkos::View<Coordinate const **, DeviceType> source_points,
-                    Kokkos::View<double const *, DeviceType> radius,
-                    RBF const & )
+    computeWeights( Kokkos::View<int const *, DeviceType> offset,
+                    Kokkos::View<Coordinate const **, DeviceType> source_points,
+                    Kokkos::View<Coordinate const **, DeviceType> target_points,
+                    double support_radius, RBF const & )
     {
-        auto const n_source_points = source_points.extent( 0 );
-
-        DTK_REQUIRE( source_points.extent_int( 1 ) == 3 );
+        auto const n_target_points = offset.extent_int( 0 ) - 1;
+        DTK_REQUIRE( target_points.extent_int( 0 ) == n_target_points );
+        DTK_REQUIRE( source_points.extent_int( 0 ) ==
+                     ArborX::lastElement( offset ) );
+        DTK_REQUIRE( source_points.extent( 1 ) == target_points.extent( 1 ) );
 
-        // The argument of rbf is a distance because we have changed the
-        // coordinate system such the target point is the origin of the new
-        // coordinate system.
-        Kokkos::View<double *, DeviceType> phi( "weights", n_source_points );
+        Kokkos::View<double *, DeviceType> phi( "weights",
+                                                source_points.extent( 0 ) );
         Kokkos::parallel_for(
             DTK_MARK_REGION( "compute_weights" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, n_source_points ),
-            KOKKOS_LAMBDA( int i ) {
-                RadialBasisFunction<RBF> rbf( radius( i ) );
-                phi( i ) = rbf( ArborX::Details::distance(
-                    ArborX::Point{{source_points( i, 0 ), source_points( i, 1 ),
-                                   source_points( i, 2 )}},
-                    {0., 0., 0.} ) );
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
+            KOKKOS_LAMBDA( int const i ) {
+                ArborX::Point const target = makePoint( target_points, i );
+                RadialBasisFunction<RBF> rbf( computeRadius(
+                    support_radius, offset, source_points, target, i ) );
+                // Store the distances first and evaluate the function on
+                // all of them at once.
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                    phi( j ) = ArborX::Details::distance(
+                        makePoint( source_points, j ), target );
+                int const n_neighbors = offset( i + 1 ) - offset( i );
+                if ( n_neighbors > 0 )
+                    rbf( &phi( offset( i ) ), &phi( offset( i ) ),
+                         n_neighbors );
             } );
         Kokkos::fence();
         return phi;
     }
 
-    template <typename PolynomialBasis>
-    static Kokkos::View<double *, DeviceType>
-    computeVandermonde( Kokkos::View<Coordinate const **, DeviceType> points,
-                        PolynomialBasis const &polynomial_basis )
-    {
-        auto const n_points = points.extent( 0 );
-        auto constexpr size_polynomial_basis = PolynomialBasis::size;
-        Kokkos::View<double *, DeviceType> p(
-            "vandermonde", n_points * size_polynomial_basis );
-        Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_polynomial_basis" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
-            KOKKOS_LAMBDA( int i ) {
-                auto const tmp = polynomial_basis( ArborX::Point{
-                    {points( i, 0 ), points( i, 1 ), points( i, 2 )}} );
-                for ( int j = 0; j < size_polynomial_basis; ++j )
-                    p( i * size_polynomial_basis + j ) = tmp[j];
-            } );
-        return p;
-    }
-
     template <typename PolynomialBasis>
     static Kokkos::View<double **, DeviceType>
     computeVandermonde2( Kokkos::View<Coordinate const **, DeviceType> points,
                          PolynomialBasis const &polynomial_basis )
     {
+        DTK_REQUIRE( points.extent_int( 1 ) == PolynomialBasis::dimension );
+
         auto const n_points = points.extent( 0 );
         auto constexpr size_polynomial_basis = PolynomialBasis::size;
         Kokkos::View<double **, DeviceType> p( "vandermonde", n_points,
@@ -204,137 +346,263 @@ struct MovingLeastSquaresOperatorImpl
             DTK_MARK_REGION( "compute_polynomial_basis" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
             KOKKOS_LAMBDA( int i ) {
-                auto const tmp = polynomial_basis( ArborX::Point{
-                    {points( i, 0 ), points( i, 1 ), points( i, 2 )}} );
+                auto const tmp = polynomial_basis( makePoint( points, i ) );
                 for ( int j = 0; j < size_polynomial_basis; ++j )
                     p( i, j ) = tmp[j];
             } );
         return p;
     }
 
-    static Kokkos::View<double *, DeviceType>
-    computeMoments( Kokkos::View<int const *, DeviceType> offset,
-                    Kokkos::View<double const *, DeviceType> p,
-                    Kokkos::View<double const *, DeviceType> phi )
+    // Classify the target points after they moved: 0 if they did not move, 1
+    // if their neighbors can be kept and only the coefficients need to be
+    // recomputed, and 2 if they must be searched again because they moved
+    // farther than the tolerance or because one of their neighbors would fall
+    // out of the support of the radial basis function that was used so far.
+    // With a fixed @param support_radius, every target that moved is searched
+    // again since source points that were outside of its ball may now be
+    // inside.
+    static Kokkos::View<int *, DeviceType> classifyMovedTargets(
+        Kokkos::View<int const *, DeviceType> offset,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> old_target_points,
+        Kokkos::View<Coordinate const **, DeviceType> new_target_points,
+        double tolerance, double support_radius )
     {
         auto const n_target_points = offset.extent_int( 0 ) - 1;
-        auto const n_source_points = phi.extent_int( 0 );
-        DTK_REQUIRE( n_source_points == ArborX::lastElement( offset ) );
-        if ( n_source_points == 0 )
-            return Kokkos::View<double *, DeviceType>( "moments", 0 );
-        auto const size_polynomial_basis = p.extent_int( 0 ) / n_source_points;
-        auto const size_polynomial_basis_squared =
-            size_polynomial_basis * size_polynomial_basis;
-        Kokkos::View<double *, DeviceType> a(
-            "moments", n_target_points * size_polynomial_basis_squared );
+        DTK_REQUIRE( old_target_points.extent_int( 0 ) == n_target_points );
+        DTK_REQUIRE( new_target_points.extent_int( 0 ) == n_target_points );
+
+        Kokkos::View<int *, DeviceType> status( "status", n_target_points );
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_moments" ),
+            DTK_MARK_REGION( "classify_moved_targets" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
-            KOKKOS_LAMBDA( int i ) {
-                auto p_i = Kokkos::subview(
-                    p, Kokkos::make_pair( offset( i ) * size_polynomial_basis,
-                                          offset( i + 1 ) *
-                                              size_polynomial_basis ) );
-                auto phi_i = Kokkos::subview(
-                    phi, Kokkos::make_pair( offset( i ), offset( i + 1 ) ) );
-                auto a_i = Kokkos::subview(
-                    a, Kokkos::make_pair( i * size_polynomial_basis_squared,
-                                          ( i + 1 ) *
-                                              size_polynomial_basis_squared ) );
-                for ( int j = 0; j < size_polynomial_basis; ++j )
-                    for ( int k = 0; k < size_polynomial_basis; ++k )
-                    {
-                        double tmp = 0.;
-                        for ( int l = 0; l < offset( i + 1 ) - offset( i );
-                              ++l )
-                            // Compute value (j,k)
-                            tmp += p_i( l * size_polynomial_basis + j ) *
-                                   phi_i( l ) *
-                                   p_i( l * size_polynomial_basis + k );
-                        a_i( j * size_polynomial_basis + k ) = tmp;
-                    }
+            KOKKOS_LAMBDA( int const i ) {
+                ArborX::Point const old_target =
+                    makePoint( old_target_points, i );
+                ArborX::Point const new_target =
+                    makePoint( new_target_points, i );
+                double const displacement =
+                    ArborX::Details::distance( old_target, new_target );
+                if ( displacement == 0. )
+                {
+                    status( i ) = 0;
+                    return;
+                }
+                if ( displacement > tolerance || support_radius > 0. )
+                {
+                    status( i ) = 2;
+                    return;
+                }
+
+                double const radius = computeRadius(
+                    support_radius, offset, source_points, old_target, i );
+
+                status( i ) = 1;
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                    if ( ArborX::Details::distance(
+                             makePoint( source_points, j ), new_target ) >=
+                         radius )
+                        status( i ) = 2;
             } );
         Kokkos::fence();
 
-        return a;
+        return status;
     }
 
-    // Matrix pseudo-inversion using SVD
-    // Takes in a 1D array of matrices of size NxN, and returns a 1D array of
-    // matrices of the same size containing corresponding pseudo-inverses
-    static std::tuple<Kokkos::View<double *, DeviceType>, size_t>
-    invertMoments( Kokkos::View<double const *, DeviceType> a,
-                   const int size_polynomial_basis )
+    // Call f( l, p_l, phi_l ) for each neighbor l of the i-th target point,
+    // where p_l is the polynomial basis evaluated at the coordinates of the
+    // neighbor relative to the target and phi_l is its weight.
+    template <typename RBF, typename PolynomialBasis, typename Functor>
+    KOKKOS_INLINE_FUNCTION static void forEachNeighbor(
+        Kokkos::View<int const *, DeviceType> offset,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        double support_radius, PolynomialBasis const &polynomial_basis, int i,
+        Functor const &f )
     {
-        Kokkos::View<double *, DeviceType> inv_a( "inv_a", a.extent( 0 ) );
-
-        auto num_matrices =
-            a.extent( 0 ) / ( size_polynomial_basis * size_polynomial_basis );
-
-        // We request auxiliary space for matrices E, U, and V (thus, 3) that
-        // we need inside SVD. Single level parallelism does not provide access
-        // to scratch space (or, at the least, I don't know how to access it).
-        // So we preallocate it here, and pass to the functor. We use 2D array
-        // as we would like to use 2D matrices inside SVD, and there is no way
-        // to reshape.
-        Kokkos::View<double **, DeviceType> aux( "aux", size_polynomial_basis,
-                                                 3 * num_matrices *
-                                                     size_polynomial_basis );
-
-        SVDFunctor<DeviceType> svdFunctor( size_polynomial_basis, a, inv_a,
-                                           aux );
-        size_t num_underdetermined = 0;
-        Kokkos::parallel_reduce(
-            DTK_MARK_REGION( "compute_svd_inverse" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, num_matrices ), svdFunctor,
-            num_underdetermined );
+        ArborX::Point const target = makePoint( target_points, i );
+        RadialBasisFunction<RBF> rbf( computeRadius(
+            support_radius, offset, source_points, target, i ) );
+        for ( int l = offset( i ); l < offset( i + 1 ); ++l )
+        {
+            // The missing coordinates are zero.
+            ArborX::Point x_l = makePoint( source_points, l );
+            for ( int d = 0; d < 3; ++d )
+                x_l[d] -= target[d];
+            f( l, polynomial_basis( x_l ),
+               rbf( ArborX::Details::distance( x_l, {0., 0., 0.} ) ) );
+        }
+    }
 
-        return std::make_tuple( inv_a, num_underdetermined );
+    // Same as above but the neighbors are distributed over the threads of
+    // @param team.
+    template <typename RBF, typename PolynomialBasis, typename Functor>
+    KOKKOS_INLINE_FUNCTION static void forEachNeighbor(
+        typename Kokkos::TeamPolicy<ExecutionSpace>::member_type const &team,
+        Kokkos::View<int const *, DeviceType> offset,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        double support_radius, PolynomialBasis const &polynomial_basis, int i,
+        Functor const &f )
+    {
+        ArborX::Point const target = makePoint( target_points, i );
+        RadialBasisFunction<RBF> rbf( computeRadius(
+            support_radius, offset, source_points, target, i ) );
+        Kokkos::parallel_for(
+            Kokkos::TeamThreadRange( team, offset( i ), offset( i + 1 ) ),
+            [&]( int l ) {
+                // The missing coordinates are zero.
+                ArborX::Point x_l = makePoint( source_points, l );
+                for ( int d = 0; d < 3; ++d )
+                    x_l[d] -= target[d];
+                f( l, polynomial_basis( x_l ),
+                   rbf( ArborX::Details::distance( x_l, {0., 0., 0.} ) ) );
+            } );
     }
 
-    static Kokkos::View<double *, DeviceType> computePolynomialCoefficients(
+    // Compute the coefficients of the moving least squares approximation
+    // directly from the coordinates of the neighbors of each target point.
+    // By default, the thread that handles a target point computes on the fly
+    // the weights, the Vandermonde matrix P, the moment matrix A = P^T PHI P,
+    // and the first row of the pseudo-inverse of A. These quantities have a
+    // size known at compile time and live on the stack so only the
+    // coefficients are written to global memory. With @param team_svd, which
+    // is the default on devices where the stack of a thread is small, each
+    // target point is handled by a team of threads instead, and the moment
+    // matrix and the SVD live in team scratch memory. Return the coefficients
+    // and the number of underdetermined systems.
+    // NOTE: This assumes that the polynomial basis evaluated at the origin is
+    // going to be [1, 0, 0, ..., 0]^T.
+    template <typename RBF, typename PolynomialBasis>
+    static std::tuple<Kokkos::View<double *, DeviceType>, size_t>
+    computeCoefficients(
         Kokkos::View<int const *, DeviceType> offset,
-        Kokkos::View<double const *, DeviceType> inv_a,
-        Kokkos::View<double const *, DeviceType> p,
-        Kokkos::View<double const *, DeviceType> phi,
-        const int size_polynomial_basis )
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        double support_radius, RBF const &,
+        PolynomialBasis const &polynomial_basis,
+        bool team_svd = !Kokkos::SpaceAccessibility<
+            ExecutionSpace, Kokkos::HostSpace>::accessible )
     {
-        auto const size_polynomial_basis_squared =
-            size_polynomial_basis * size_polynomial_basis;
+        int constexpr n = PolynomialBasis::size;
+        using SVD = SVDFixedSize<DeviceType, n>;
+        using matrix_type = typename SVD::matrix_type;
+        using vector_type = typename SVD::vector_type;
+        using basis_type = Kokkos::Array<double, n>;
 
-        auto num_matrices = inv_a.extent( 0 ) / size_polynomial_basis_squared;
+        auto const n_target_points = offset.extent_int( 0 ) - 1;
+        DTK_REQUIRE( target_points.extent_int( 0 ) == n_target_points );
+        DTK_REQUIRE( source_points.extent_int( 0 ) ==
+                     ArborX::lastElement( offset ) );
+        DTK_REQUIRE( source_points.extent_int( 1 ) ==
+                     PolynomialBasis::dimension );
+        DTK_REQUIRE( target_points.extent_int( 1 ) ==
+                     PolynomialBasis::dimension );
 
         Kokkos::View<double *, DeviceType> coeffs( "polynomial_coeffs",
-                                                   phi.extent( 0 ) );
+                                                   source_points.extent( 0 ) );
 
-        Kokkos::parallel_for(
+        size_t num_underdetermined = 0;
+        if ( !team_svd )
+        {
+            Kokkos::parallel_reduce(
+                DTK_MARK_REGION( "compute_polynomial_coeffs" ),
+                Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
+                KOKKOS_LAMBDA( const int i, size_t &underdetermined ) {
+                    // Build A (moment matrix)
+                    matrix_type a;
+                    for ( int j = 0; j < n; ++j )
+                        for ( int k = 0; k < n; ++k )
+                            a[j][k] = 0.;
+                    forEachNeighbor<RBF>(
+                        offset, source_points, target_points, support_radius,
+                        polynomial_basis, i,
+                        [&]( int, basis_type const &p_l, double phi_l ) {
+                            for ( int j = 0; j < n; ++j )
+                                for ( int k = 0; k < n; ++k )
+                                    a[j][k] += p_l[j] * phi_l * p_l[k];
+                        } );
+
+                    // Only the first row of the pseudo-inverse is needed.
+                    vector_type inv_a;
+                    if ( SVD::pseudo_inverse_first_row( a, inv_a ) )
+                        ++underdetermined;
+
+                    // coeffs = [1 0 ... 0] * a_inv * p^T * phi
+                    forEachNeighbor<RBF>(
+                        offset, source_points, target_points, support_radius,
+                        polynomial_basis, i,
+                        [&]( int l, basis_type const &p_l, double phi_l ) {
+                            coeffs( l ) = 0.;
+                            for ( int j = 0; j < n; ++j )
+                                coeffs( l ) += inv_a[j] * p_l[j] * phi_l;
+                        } );
+                },
+                num_underdetermined );
+            return std::make_tuple( coeffs, num_underdetermined );
+        }
+
+        using TeamSVD = SVDTeam<DeviceType>;
+        using member_type = typename TeamSVD::member_type;
+        using scratch_matrix_type = typename TeamSVD::scratch_matrix_type;
+        using scratch_vector_type = typename TeamSVD::scratch_vector_type;
+        std::size_t const scratch_size =
+            scratch_matrix_type::shmem_size( n, n ) +
+            scratch_vector_type::shmem_size( n ) + TeamSVD::shmem_size( n, 1 );
+        Kokkos::parallel_reduce(
             DTK_MARK_REGION( "compute_polynomial_coeffs" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, num_matrices ),
-            KOKKOS_LAMBDA( const int i ) {
-                auto p_i = Kokkos::subview(
-                    p, Kokkos::make_pair( offset( i ) * size_polynomial_basis,
-                                          offset( i + 1 ) *
-                                              size_polynomial_basis ) );
-                auto phi_i = Kokkos::subview(
-                    phi, Kokkos::make_pair( offset( i ), offset( i + 1 ) ) );
-                auto inv_a_i = Kokkos::subview(
-                    inv_a, Kokkos::make_pair(
-                               i * size_polynomial_basis_squared,
-                               ( i + 1 ) * size_polynomial_basis_squared ) );
-                auto coeffs_i = Kokkos::subview(
-                    coeffs, Kokkos::make_pair( offset( i ), offset( i + 1 ) ) );
+            Kokkos::TeamPolicy<ExecutionSpace>( n_target_points, Kokkos::AUTO )
+                .set_scratch_size( 0, Kokkos::PerTeam( scratch_size ) ),
+            KOKKOS_LAMBDA( member_type const &team, size_t &underdetermined ) {
+                int const i = team.league_rank();
+                scratch_matrix_type a( team.team_scratch( 0 ), n, n );
+                scratch_vector_type inv_a( team.team_scratch( 0 ), n );
+
+                // Build A (moment matrix), one row per thread.
+                Kokkos::parallel_for(
+                    Kokkos::TeamThreadRange( team, n ), [&]( int j ) {
+                        Kokkos::parallel_for(
+                            Kokkos::ThreadVectorRange( team, n ),
+                            [&]( int k ) { a( j, k ) = 0.; } );
+                        forEachNeighbor<RBF>(
+                            offset, source_points, target_points,
+                            support_radius, polynomial_basis, i,
+                            [&]( int, basis_type const &p_l, double phi_l ) {
+                                Kokkos::parallel_for(
+                                    Kokkos::ThreadVectorRange( team, n ),
+                                    [&]( int k ) {
+                                        a( j, k ) += p_l[j] * phi_l * p_l[k];
+                                    } );
+                            } );
+                    } );
+                team.team_barrier();
+
+                // Only the first row of the pseudo-inverse is needed.
+                bool const undetermined = TeamSVD::pseudo_inverse(
+                    team, a, 1,
+                    [&]( int, int j, double value ) { inv_a( j ) = value; } );
+                team.team_barrier();
 
                 // coeffs = [1 0 ... 0] * a_inv * p^T * phi
-                for ( int k = 0; k < offset( i + 1 ) - offset( i ); k++ )
-                {
-                    coeffs_i( k ) = 0.;
-                    for ( int j = 0; j < size_polynomial_basis; j++ )
-                        coeffs_i( k ) +=
-                            inv_a_i( 0 * size_polynomial_basis + j ) *
-                            p_i( k * size_polynomial_basis + j ) * phi_i( k );
-                }
-            } );
-        return coeffs;
+                forEachNeighbor<RBF>(
+                    team, offset, source_points, target_points, support_radius,
+                    polynomial_basis, i,
+                    [&]( int l, basis_type const &p_l, double phi_l ) {
+                        double value = 0.;
+                        for ( int j = 0; j < n; ++j )
+                            value += inv_a( j ) * p_l[j] * phi_l;
+                        Kokkos::single( Kokkos::PerThread( team ),
+                                        [&]() { coeffs( l ) = value; } );
+                    } );
+
+                Kokkos::single( Kokkos::PerTeam( team ), [&]() {
+                    if ( undetermined )
+                        ++underdetermined;
+                } );
+            },
+            num_underdetermined );
+
+        return std::make_tuple( coeffs, num_underdetermined );
     }
 };
 
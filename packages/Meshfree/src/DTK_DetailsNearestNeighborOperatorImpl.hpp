@@ -14,6 +14,7 @@
 
 #include <ArborX.hpp>
 #include <DTK_DBC.hpp>
+#include <DTK_PointCloudSearchTree.hpp>
 
 namespace DataTransferKit
 {
@@ -36,14 +37,36 @@ struct NearestNeighborOperatorImpl
             DTK_MARK_REGION( "setup_queries" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
             KOKKOS_LAMBDA( int i ) {
-                nearest_queries( i ) = nearest(
-                    ArborX::Point{{target_points( i, 0 ), target_points( i, 1 ),
-                                   target_points( i, 2 )}} );
+                nearest_queries( i ) =
+                    nearest( makePoint( target_points, i ) );
             } );
         Kokkos::fence();
         return nearest_queries;
     }
 
+    // Flag the target points that moved farther than the tolerance.
+    static Kokkos::View<int *, DeviceType> classifyMovedTargets(
+        Kokkos::View<Coordinate const **, DeviceType> old_target_points,
+        Kokkos::View<Coordinate const **, DeviceType> new_target_points,
+        double tolerance )
+    {
+        int const n_target_points = old_target_points.extent( 0 );
+        DTK_REQUIRE( new_target_points.extent_int( 0 ) == n_target_points );
+
+        Kokkos::View<int *, DeviceType> status( "status", n_target_points );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "classify_moved_targets" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
+            KOKKOS_LAMBDA( int i ) {
+                double const displacement = ArborX::Details::distance(
+                    makePoint( old_target_points, i ),
+                    makePoint( new_target_points, i ) );
+                status( i ) = displacement > tolerance ? 1 : 0;
+            } );
+        Kokkos::fence();
+        return status;
+    }
+
     template <typename View>
     static void
     pullSourceValues( MPI_Comm comm, View source_values,
@@ -0,0 +1,230 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DETAILS_OPERATOR_ARCHIVE_IMPL_HPP
+#define DTK_DETAILS_OPERATOR_ARCHIVE_IMPL_HPP
+
+#include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include <mpi.h>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+
+/**
+ * Helpers to save the state of an operator to binary files and to load it
+ * back. Every processor writes its own file, whose name is the prefix given
+ * by the user, a dot, and the rank of the processor. A file starts with a
+ * header that identifies the operator type, the number of processors, and the
+ * source and target points the operator was built for, so that it is never
+ * loaded into an operator it does not describe. The views follow, each one as
+ * its extents and its raw data.
+ *
+ * Reading is collective: the read functions do not throw, and checkRead()
+ * tells all the processors whether any of them ran out of data, so that they
+ * all throw instead of leaving the others waiting.
+ *
+ * The files are meant to be read back on the same kind of machine, they are
+ * not portable across endianness.
+ */
+template <typename DeviceType>
+struct OperatorArchiveImpl
+{
+    struct Header
+    {
+        std::uint64_t magic;
+        std::uint64_t operator_type;
+        std::uint64_t comm_size;
+        std::uint64_t source_points;
+        std::uint64_t target_points;
+    };
+
+    // 64-bit FNV-1a hash.
+    static std::uint64_t hash( void const *data, std::size_t size,
+                               std::uint64_t h = 14695981039346656037ull )
+    {
+        auto bytes = static_cast<unsigned char const *>( data );
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+            h ^= bytes[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    static std::uint64_t
+    hashPoints( Kokkos::View<Coordinate const **, DeviceType> points )
+    {
+        auto points_host =
+            Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, points );
+        std::uint64_t const extents[2] = {points.extent( 0 ),
+                                          points.extent( 1 )};
+        return hash( points_host.data(),
+                     points_host.span() * sizeof( Coordinate ),
+                     hash( extents, sizeof( extents ) ) );
+    }
+
+    static Header
+    makeHeader( MPI_Comm comm, std::string const &operator_type,
+                Kokkos::View<Coordinate const **, DeviceType> source_points,
+                Kokkos::View<Coordinate const **, DeviceType> target_points )
+    {
+        return makeHeader( comm, operator_type, source_points,
+                           hashPoints( target_points ) );
+    }
+
+    // Same as above with the hash of the target points.
+    static Header
+    makeHeader( MPI_Comm comm, std::string const &operator_type,
+                Kokkos::View<Coordinate const **, DeviceType> source_points,
+                std::uint64_t target_points_hash )
+    {
+        int comm_size;
+        MPI_Comm_size( comm, &comm_size );
+
+        Header header;
+        // "DTKOPARC" on little-endian machines.
+        header.magic = 0x435241504f4b5444ull;
+        header.operator_type =
+            hash( operator_type.data(), operator_type.size() );
+        header.comm_size = comm_size;
+        header.source_points = hashPoints( source_points );
+        header.target_points = target_points_hash;
+        return header;
+    }
+
+    static std::string fileName( MPI_Comm comm, std::string const &prefix )
+    {
+        int comm_rank;
+        MPI_Comm_rank( comm, &comm_rank );
+        return prefix + "." + std::to_string( comm_rank );
+    }
+
+    static std::ofstream openForWriting( MPI_Comm comm,
+                                         std::string const &prefix,
+                                         Header const &header )
+    {
+        std::ofstream stream( fileName( comm, prefix ),
+                              std::ios::binary | std::ios::trunc );
+        if ( !stream )
+            throw DataTransferKitException( "Cannot open " +
+                                            fileName( comm, prefix ) +
+                                            " for writing" );
+        stream.write( reinterpret_cast<char const *>( &header ),
+                      sizeof( Header ) );
+        return stream;
+    }
+
+    // Collective. All the processors throw if any file is missing or does not
+    // match the header.
+    static std::ifstream openForReading( MPI_Comm comm,
+                                         std::string const &prefix,
+                                         Header const &header )
+    {
+        std::ifstream stream( fileName( comm, prefix ), std::ios::binary );
+        Header file_header;
+        int valid =
+            stream &&
+            stream.read( reinterpret_cast<char *>( &file_header ),
+                         sizeof( Header ) ) &&
+            file_header.magic == header.magic &&
+            file_header.operator_type == header.operator_type &&
+            file_header.comm_size == header.comm_size &&
+            file_header.source_points == header.source_points &&
+            file_header.target_points == header.target_points;
+        MPI_Allreduce( MPI_IN_PLACE, &valid, 1, MPI_INT, MPI_MIN, comm );
+        if ( !valid )
+            throw DataTransferKitException(
+                "The files " + prefix +
+                ".* do not describe this operator, its points, or the "
+                "number of processors" );
+        return stream;
+    }
+
+    template <typename T>
+    static void writeValue( std::ostream &stream, T const &value )
+    {
+        stream.write( reinterpret_cast<char const *>( &value ), sizeof( T ) );
+        if ( !stream )
+            throw DataTransferKitException( "Failed to write operator data" );
+    }
+
+    // Once the stream failed, the reads leave the values unspecified and the
+    // views empty until checkRead() is called.
+    template <typename T>
+    static void readValue( std::istream &stream, T &value )
+    {
+        stream.read( reinterpret_cast<char *>( &value ), sizeof( T ) );
+    }
+
+    template <typename View>
+    static void write( std::ostream &stream, View const &view )
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "write() requires rank-1 or rank-2 views" );
+        using ValueType = typename View::non_const_value_type;
+
+        std::uint64_t const extents[2] = {view.extent( 0 ), view.extent( 1 )};
+        stream.write( reinterpret_cast<char const *>( extents ),
+                      sizeof( extents ) );
+        auto view_host =
+            Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, view );
+        stream.write( reinterpret_cast<char const *>( view_host.data() ),
+                      view_host.span() * sizeof( ValueType ) );
+        if ( !stream )
+            throw DataTransferKitException( "Failed to write operator data" );
+    }
+
+    // Reallocate @param view and fill it with the next view in the stream.
+    template <typename View>
+    static void read( std::istream &stream, View &view )
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "read() requires rank-1 or rank-2 views" );
+        using ValueType = typename View::non_const_value_type;
+
+        std::uint64_t extents[2];
+        stream.read( reinterpret_cast<char *>( extents ), sizeof( extents ) );
+        if ( !stream )
+            extents[0] = extents[1] = 0;
+        view = View::rank == 1
+                   ? View( view.label(), extents[0] )
+                   : View( view.label(), extents[0], extents[1] );
+        auto view_host = Kokkos::create_mirror_view( view );
+        stream.read( reinterpret_cast<char *>( view_host.data() ),
+                     view_host.span() * sizeof( ValueType ) );
+        Kokkos::deep_copy( view, view_host );
+    }
+
+    // Collective. All the processors throw if any of them could not read all
+    // the data it expected.
+    static void checkRead( MPI_Comm comm, std::istream const &stream )
+    {
+        int valid = static_cast<bool>( stream );
+        MPI_Allreduce( MPI_IN_PLACE, &valid, 1, MPI_INT, MPI_MIN, comm );
+        if ( !valid )
+            throw DataTransferKitException( "Truncated operator data" );
+    }
+};
+
+} // namespace Details
+} // namespace DataTransferKit
+
+#endif
@@ -0,0 +1,248 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DETAILS_OPERATOR_UPDATE_IMPL_HPP
+#define DTK_DETAILS_OPERATOR_UPDATE_IMPL_HPP
+
+#include <ArborX.hpp>
+#include <DTK_DBC.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <tuple>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+
+/**
+ * Helpers to update the neighbor lists of an operator when only some of the
+ * target points need to be searched again. The neighbor lists are stored in
+ * CRS format: the neighbors of the i-th target are in [offset(i),
+ * offset(i+1)).
+ */
+template <typename DeviceType>
+struct OperatorUpdateImpl
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    // Return the (sorted) ids of the target points whose status is at least
+    // min_status.
+    static Kokkos::View<int *, DeviceType>
+    selectTargets( Kokkos::View<int const *, DeviceType> status,
+                   int min_status )
+    {
+        int const n_targets = status.extent_int( 0 );
+        int n_selected = 0;
+        Kokkos::parallel_reduce(
+            DTK_MARK_REGION( "count_selected_targets" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_targets ),
+            KOKKOS_LAMBDA( int i, int &count ) {
+                if ( status( i ) >= min_status )
+                    ++count;
+            },
+            n_selected );
+
+        Kokkos::View<int *, DeviceType> ids( "selected_targets", n_selected );
+        Kokkos::parallel_scan(
+            DTK_MARK_REGION( "select_targets" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_targets ),
+            KOKKOS_LAMBDA( int i, int &update, bool final_pass ) {
+                if ( status( i ) >= min_status )
+                {
+                    if ( final_pass )
+                        ids( update ) = i;
+                    ++update;
+                }
+            } );
+        Kokkos::fence();
+
+        return ids;
+    }
+
+    // Extract the rows ids of a rank-1 or rank-2 view.
+    template <typename View>
+    static typename View::non_const_type
+    gatherRows( View values, Kokkos::View<int const *, DeviceType> ids )
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "gatherRows() requires rank-1 or rank-2 views" );
+        int const n = ids.extent_int( 0 );
+        int const n_components = values.extent( 1 );
+        auto gathered =
+            View::rank == 1
+                ? typename View::non_const_type( values.label(), n )
+                : typename View::non_const_type( values.label(), n,
+                                                 n_components );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "gather_rows" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int k = 0; k < n_components; ++k )
+                    gathered.access( i, k ) = values.access( ids( i ), k );
+            } );
+        Kokkos::fence();
+
+        return gathered;
+    }
+
+    // Copy the rows of a rank-1 or rank-2 view back to the positions ids.
+    template <typename View, typename ScatteredView>
+    static void scatterRows( View values,
+                             Kokkos::View<int const *, DeviceType> ids,
+                             ScatteredView scattered )
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "scatterRows() requires rank-1 or rank-2 views" );
+        DTK_REQUIRE( values.extent( 0 ) == ids.extent( 0 ) );
+        DTK_REQUIRE( values.extent( 1 ) == scattered.extent( 1 ) );
+        int const n_components = values.extent( 1 );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "scatter_rows" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, ids.extent( 0 ) ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int k = 0; k < n_components; ++k )
+                    scattered.access( ids( i ), k ) = values.access( i, k );
+            } );
+        Kokkos::fence();
+    }
+
+    // Extract the neighbor lists of the targets ids. Return the offset of the
+    // sub-lists and the position of their entries in the full lists.
+    static std::tuple<Kokkos::View<int *, DeviceType>,
+                      Kokkos::View<int *, DeviceType>>
+    extractLists( Kokkos::View<int const *, DeviceType> offset,
+                  Kokkos::View<int const *, DeviceType> ids )
+    {
+        int const n = ids.extent_int( 0 );
+        Kokkos::View<int *, DeviceType> sub_offset( "offset", n + 1 );
+        Kokkos::parallel_scan(
+            DTK_MARK_REGION( "extract_offset" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n + 1 ),
+            KOKKOS_LAMBDA( int i, int &update, bool final_pass ) {
+                if ( final_pass )
+                    sub_offset( i ) = update;
+                if ( i < n )
+                    update += offset( ids( i ) + 1 ) - offset( ids( i ) );
+            } );
+
+        Kokkos::View<int *, DeviceType> entries(
+            "entries", ArborX::lastElement( sub_offset ) );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "extract_entries" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+            KOKKOS_LAMBDA( int i ) {
+                int const shift = offset( ids( i ) ) - sub_offset( i );
+                for ( int j = sub_offset( i ); j < sub_offset( i + 1 ); ++j )
+                    entries( j ) = j + shift;
+            } );
+        Kokkos::fence();
+
+        return std::make_tuple( sub_offset, entries );
+    }
+
+    // Merge the neighbor lists of the targets ids, which come from a new
+    // search with offset new_offset, into the current lists. Return the
+    // offset of the merged lists and the origin of each of their entries:
+    // origin(j) >= 0 is an entry of the current lists and origin(j) < 0 is the
+    // entry -origin(j)-1 of the new lists.
+    static std::tuple<Kokkos::View<int *, DeviceType>,
+                      Kokkos::View<int *, DeviceType>>
+    mergeLists( Kokkos::View<int const *, DeviceType> offset,
+                Kokkos::View<int const *, DeviceType> ids,
+                Kokkos::View<int const *, DeviceType> new_offset )
+    {
+        int const n_targets = offset.extent_int( 0 ) - 1;
+        DTK_REQUIRE( new_offset.extent( 0 ) == ids.extent( 0 ) + 1 );
+
+        // Position of the target in ids or -1 if its neighbors are kept.
+        Kokkos::View<int *, DeviceType> position( "position", n_targets );
+        Kokkos::deep_copy( position, -1 );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "find_position" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, ids.extent( 0 ) ),
+            KOKKOS_LAMBDA( int k ) { position( ids( k ) ) = k; } );
+
+        Kokkos::View<int *, DeviceType> merged_offset( "offset",
+                                                       n_targets + 1 );
+        Kokkos::parallel_scan(
+            DTK_MARK_REGION( "merge_offset" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_targets + 1 ),
+            KOKKOS_LAMBDA( int i, int &update, bool final_pass ) {
+                if ( final_pass )
+                    merged_offset( i ) = update;
+                if ( i < n_targets )
+                {
+                    int const k = position( i );
+                    update += ( k < 0 ) ? offset( i + 1 ) - offset( i )
+                                        : new_offset( k + 1 ) - new_offset( k );
+                }
+            } );
+
+        Kokkos::View<int *, DeviceType> origin(
+            "origin", ArborX::lastElement( merged_offset ) );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "merge_entries" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_targets ),
+            KOKKOS_LAMBDA( int i ) {
+                int const k = position( i );
+                int const n_neighbors =
+                    merged_offset( i + 1 ) - merged_offset( i );
+                for ( int l = 0; l < n_neighbors; ++l )
+                    origin( merged_offset( i ) + l ) =
+                        ( k < 0 ) ? offset( i ) + l
+                                  : -( new_offset( k ) + l ) - 1;
+            } );
+        Kokkos::fence();
+
+        return std::make_tuple( merged_offset, origin );
+    }
+
+    // Assemble the values associated with the entries of the merged lists
+    // from the values of the current lists and of the new lists.
+    template <typename View, typename NewView>
+    static typename View::non_const_type
+    mergeValues( Kokkos::View<int const *, DeviceType> origin,
+                 View const &values, NewView const &new_values )
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "mergeValues() requires rank-1 or rank-2 views" );
+        static_assert( static_cast<int>( View::rank ) ==
+                           static_cast<int>( NewView::rank ),
+                       "mergeValues() requires views of the same rank" );
+        int const n = origin.extent_int( 0 );
+        int const n_components = values.extent( 1 );
+        auto merged =
+            View::rank == 1
+                ? typename View::non_const_type( values.label(), n )
+                : typename View::non_const_type( values.label(), n,
+                                                 n_components );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "merge_values" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+            KOKKOS_LAMBDA( int j ) {
+                int const o = origin( j );
+                for ( int k = 0; k < n_components; ++k )
+                    merged.access( j, k ) =
+                        ( o >= 0 ) ? values.access( o, k )
+                                   : new_values.access( -o - 1, k );
+            } );
+        Kokkos::fence();
+
+        return merged;
+    }
+};
+
+} // namespace Details
+} // namespace DataTransferKit
+
+#endif
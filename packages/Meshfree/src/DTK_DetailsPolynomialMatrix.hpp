@@ -34,8 +34,6 @@
 #include <mpi.h>
 #endif
 
-#include <Tpetra_Export.hpp>
-
 namespace DataTransferKit
 {
 
@@ -72,8 +70,12 @@ class PolynomialMatrix
            Scalar alpha = Teuchos::ScalarTraits<Scalar>::one(),
            Scalar beta = Teuchos::ScalarTraits<Scalar>::zero() ) const override
     {
-        DTK_REQUIRE( _domain_map->isSameAs( *( X.getMap() ) ) );
-        DTK_REQUIRE( _range_map->isSameAs( *( Y.getMap() ) ) );
+        DTK_REQUIRE( mode == Teuchos::NO_TRANS || mode == Teuchos::TRANS );
+        bool const transpose = mode == Teuchos::TRANS;
+        DTK_REQUIRE( ( transpose ? _range_map : _domain_map )
+                         ->isSameAs( *( X.getMap() ) ) );
+        DTK_REQUIRE( ( transpose ? _domain_map : _range_map )
+                         ->isSameAs( *( Y.getMap() ) ) );
         DTK_REQUIRE( X.getNumVectors() == Y.getNumVectors() );
 
         using ExecutionSpace = typename DeviceType::execution_space;
@@ -134,14 +136,9 @@ class PolynomialMatrix
         }
         else if ( mode == Teuchos::TRANS )
         {
-            // Export X to the polynomial decomposition.
-            MultiVector work( _range_map, num_vec );
-            Tpetra::Export<LocalOrdinal, GlobalOrdinal, Node> exporter(
-                _domain_map, _range_map );
-            work.doExport( X, exporter, Tpetra::INSERT );
-
-            // Do the local mat-vec.
-            auto work_view = work.getLocalViewDevice();
+            // Do the local mat-vec. X is distributed like the rows of the
+            // Vandermonde matrix.
+            auto work_view = X.getLocalViewDevice();
             Kokkos::View<double **, DeviceType> products( "products", poly_size,
                                                           num_vec );
             {
@@ -177,18 +174,21 @@ class PolynomialMatrix
             product_sums = products;
 #endif
 
-            // Assign the values to Y on the root rank.
+            // Add the values to Y on the root rank.
             // Note: no alpha here as we used it above.
             if ( 0 == comm->getRank() )
             {
                 auto y_view = Y.getLocalViewDevice();
 
-                auto const n = y_view.extent( 0 );
-                Kokkos::deep_copy(
-                    Kokkos::subview( y_view,
-                                     Kokkos::make_pair( n - poly_size, n ),
-                                     Kokkos::ALL ),
-                    product_sums );
+                int const n = y_view.extent( 0 );
+                Kokkos::parallel_for(
+                    DTK_MARK_REGION( "polynomial_matrix::apply::trans_sums" ),
+                    Kokkos::RangePolicy<ExecutionSpace>( 0, poly_size ),
+                    KOKKOS_LAMBDA( int const p ) {
+                        for ( int j = 0; j < num_vec; ++j )
+                            y_view( n - poly_size + p, j ) +=
+                                product_sums( p, j );
+                    } );
             }
         }
     }
@@ -18,6 +18,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 
 namespace DataTransferKit
 {
@@ -34,83 +35,22 @@ KOKKOS_INLINE_FUNCTION int sgn( T x )
     return ( x > 0 ) - ( x < 0 );
 }
 
-// The original version of this functor was taken from Trilinos mini-tensor
-// package. It was adapted to work in a batched mode where matrices are given
-// in a flat 1D array. It also explicitly solves 2x2 singular-value
-// decomposition (svd) problems.
-template <typename DeviceType>
-struct SVDFunctor
+// Singular value decomposition of 2x2 matrices, which provides the Givens
+// rotations of the Jacobi iterations of the kernels below. The original version
+// was taken from Trilinos mini-tensor package.
+struct SVD2x2
 {
-  public:
-    using ExecutionSpace = typename DeviceType::execution_space;
-
-    // We use 1D view of the matrices here to make it as generic as possible.
-    // This should allow for a certain flexibility later, like using different
-    // sized matrices, or using some batching.
-    // NOTE pass flat::matrix_type and matrix_type by value (or typename
-    // matrix_type::const_type) but pass matrix_2x2_type by reference (or const
-    // &)
-    using flat_matrix_type = Kokkos::View<double *, DeviceType>;
-    using matrix_type = Kokkos::View<double **, DeviceType>;
     using matrix_2x2_type = Kokkos::Array<Kokkos::Array<double, 2>, 2>;
 
-  public:
-    SVDFunctor( int n, typename flat_matrix_type::const_type As,
-                flat_matrix_type pseudoAs, matrix_type aux )
-        : _n( n )
-        , _As( As )
-        , _pseudoAs( pseudoAs )
-        , _aux( aux )
-    {
-    }
-
-    KOKKOS_INLINE_FUNCTION
-    void givens_left( matrix_type A, double c, double s, int i, int k ) const
-    {
-        auto n = A.extent_int( 0 );
-
-        for ( int j = 0; j < n; j++ )
-        {
-            auto aij = A( i, j );
-            auto akj = A( k, j );
-            A( i, j ) = c * aij - s * akj;
-            A( k, j ) = s * aij + c * akj;
-        }
-    }
-
-    KOKKOS_INLINE_FUNCTION
-    void givens_right( matrix_type A, double c, double s, int i, int k ) const
-    {
-        auto n = A.extent_int( 0 );
-
-        for ( int j = 0; j < n; ++j )
-        {
-            auto aji = A( j, i );
-            auto ajk = A( j, k );
-            A( j, i ) = c * aji - s * ajk;
-            A( j, k ) = s * aji + c * ajk;
-        }
-    }
-
     KOKKOS_INLINE_FUNCTION
-    void trans_2x2( matrix_2x2_type const &A, matrix_2x2_type &B ) const
+    static void trans_2x2( matrix_2x2_type const &A, matrix_2x2_type &B )
     {
         B = {{{{A[0][0], A[1][0]}}, {{A[0][1], A[1][1]}}}};
     }
 
     KOKKOS_INLINE_FUNCTION
-    void trans_nxn( typename matrix_type::const_type A, matrix_type &B ) const
-    {
-        auto n = A.extent( 0 );
-
-        for ( int i = 0; i < n; i++ )
-            for ( int j = 0; j < n; j++ )
-                B( i, j ) = A( j, i );
-    }
-
-    KOKKOS_INLINE_FUNCTION
-    void mult_2x2( matrix_2x2_type const &A, matrix_2x2_type const &B,
-                   matrix_2x2_type &C ) const
+    static void mult_2x2( matrix_2x2_type const &A, matrix_2x2_type const &B,
+                          matrix_2x2_type &C )
     {
         C = {{{{A[0][0] * B[0][0] + A[0][1] * B[1][0],
                 A[0][0] * B[0][1] + A[0][1] * B[1][1]}},
@@ -119,8 +59,8 @@ struct SVDFunctor
     }
 
     KOKKOS_INLINE_FUNCTION
-    void svd_2x2( matrix_2x2_type const &A, matrix_2x2_type &U,
-                  matrix_2x2_type &E, matrix_2x2_type &V ) const
+    static void svd_2x2( matrix_2x2_type const &A, matrix_2x2_type &U,
+                         matrix_2x2_type &E, matrix_2x2_type &V )
     {
         matrix_2x2_type At, AAt, AtA;
         trans_2x2( A, At );
@@ -162,89 +102,81 @@ struct SVDFunctor
 
         mult_2x2( W, C, V );
     }
+};
+
+// Compute the first row of the pseudo-inverse of a single N x N matrix, which
+// is all that the moving least squares operator needs. The Jacobi iterations
+// eliminate the largest off-diagonal entry first. They are performed in place
+// and only the left singular vectors and the first column of V^T are
+// accumulated. The size is known at compile time so that the matrices are
+// stored in Kokkos::Array on the stack of the calling thread and the loops can
+// be unrolled.
+template <typename DeviceType, int N>
+struct SVDFixedSize
+{
+    using matrix_type = Kokkos::Array<Kokkos::Array<double, N>, N>;
+    using vector_type = Kokkos::Array<double, N>;
+    using matrix_2x2_type = SVD2x2::matrix_2x2_type;
 
     KOKKOS_INLINE_FUNCTION
-    void argmax_off_diagonal( typename matrix_type::const_type A, int &p,
-                              int &q ) const
+    static void argmax_off_diagonal( matrix_type const &A, int &p, int &q )
     {
-        const auto n = A.extent_int( 0 );
-
         p = -1;
         q = -1;
         double max = -1;
 
-        for ( int i = 0; i < n; i++ )
-            for ( int j = 0; j < n; j++ )
-                if ( i != j && std::abs( A( i, j ) ) > max )
+        for ( int i = 0; i < N; i++ )
+            for ( int j = 0; j < N; j++ )
+                if ( i != j && std::abs( A[i][j] ) > max )
                 {
                     p = i;
                     q = j;
-                    max = std::abs( A( i, j ) );
+                    max = std::abs( A[i][j] );
                 }
     }
 
     KOKKOS_INLINE_FUNCTION
-    double norm_F_wo_diag( typename matrix_type::const_type A ) const
+    static double norm_F( matrix_type const &A, bool with_diagonal )
     {
-        const auto n = A.extent_int( 0 );
-
         double norm = 0.0;
-        for ( int i = 0; i < n; i++ )
-            for ( int j = 0; j < n; j++ )
-                norm += ( ( i != j ) ? A( i, j ) * A( i, j ) : 0 );
+        for ( int i = 0; i < N; i++ )
+            for ( int j = 0; j < N; j++ )
+                if ( with_diagonal || i != j )
+                    norm += A[i][j] * A[i][j];
 
         return std::sqrt( norm );
     }
 
+    // Compute the first row of the pseudo-inverse of @param E. The matrix is
+    // overwritten. Return true if the matrix is rank deficient.
     KOKKOS_INLINE_FUNCTION
-    void operator()( const int matrix_id, size_t &num_underdetermined ) const
+    static bool pseudo_inverse_first_row( matrix_type &E,
+                                          vector_type &first_row )
     {
-        // TODO: This code (for getting A and pseudoA) can be updated later
-        // to work with offsets so that we can solve for matrices of
-        // different sizes. However, it is unclear what the best batched
-        // approach is. It could be that instead the matrices should be
-        // pre-sorted by size.
-        auto A = Kokkos::subview(
-            _As, Kokkos::make_pair( matrix_id * _n * _n,
-                                    ( matrix_id + 1 ) * _n * _n ) );
-        auto pseudoA = Kokkos::subview(
-            _pseudoAs, Kokkos::make_pair( matrix_id * _n * _n,
-                                          ( matrix_id + 1 ) * _n * _n ) );
-
-        auto E = Kokkos::subview(
-            _aux, Kokkos::ALL(),
-            Kokkos::make_pair( 3 * matrix_id * _n, 3 * matrix_id * _n + _n ) );
-        auto U =
-            Kokkos::subview( _aux, Kokkos::ALL(),
-                             Kokkos::make_pair( 3 * matrix_id * _n + _n,
-                                                3 * matrix_id * _n + 2 * _n ) );
-        auto V =
-            Kokkos::subview( _aux, Kokkos::ALL(),
-                             Kokkos::make_pair( 3 * matrix_id * _n + 2 * _n,
-                                                3 * matrix_id * _n + 3 * _n ) );
-
-        for ( int i = 0; i < _n; i++ )
-            for ( int j = 0; j < _n; j++ )
-            {
-                E( i, j ) = A( i * _n + j );
-            }
-        for ( int i = 0; i < _n; i++ )
-            for ( int j = 0; j < _n; j++ )
-            {
-                U( i, j ) = ( i == j ? 1.0 : 0.0 );
-                V( i, j ) = ( i == j ? 1.0 : 0.0 );
-            }
-
-        auto norm = norm_F_wo_diag( E );
-        auto tol = KokkosExt::ArithmeticTraits::epsilon<double>::value;
+        matrix_type U;
+        // First column of V^T
+        vector_type v;
+        for ( int i = 0; i < N; i++ )
+        {
+            for ( int j = 0; j < N; j++ )
+                U[i][j] = ( i == j ? 1.0 : 0.0 );
+            v[i] = ( i == 0 ? 1.0 : 0.0 );
+        }
 
-        while ( norm > tol )
+        // Same stopping criterion as SVDTeamFunctor so that both kernels
+        // agree on which systems are underdetermined. A sweep is one rotation
+        // per off-diagonal pair.
+        auto const tol = KokkosExt::ArithmeticTraits::epsilon<double>::value;
+        auto const threshold = N * tol * norm_F( E, true );
+        auto norm = norm_F( E, false );
+        int const max_rotations = 100 * N * ( N - 1 ) / 2;
+        for ( int rotation = 0; rotation < max_rotations && norm > threshold;
+              ++rotation )
         {
             // Find largest off-diagonal entry
             int p, q;
             argmax_off_diagonal( E, p, q );
             assert( p != -1 && q != -1 );
-            // TODO: it is unclear whether this permutation is necessary.
             if ( p > q )
             {
                 auto t = p;
@@ -254,60 +186,349 @@ struct SVDFunctor
 
             // Obtain left and right Givens rotations by using 2x2 SVD
             matrix_2x2_type Apq = {
-                {{{E( p, p ), E( p, q )}}, {{E( q, p ), E( q, q )}}}};
+                {{{E[p][p], E[p][q]}}, {{E[q][p], E[q][q]}}}};
             matrix_2x2_type L, D, R;
 
-            svd_2x2( Apq, L, D, R );
+            SVD2x2::svd_2x2( Apq, L, D, R );
 
             auto cl = L[0][0];
             auto sl = L[0][1];
             auto cr = R[0][0];
             auto sr = ( sgn( R[0][1] ) == sgn( R[1][0] ) ) ? -R[0][1] : R[0][1];
 
-            // Apply both Givens rotations to matrices that are converging to
-            // singular values and singular vectors
-            givens_left( E, cl, sl, p, q );
-            givens_right( E, cr, sr, p, q );
+            for ( int j = 0; j < N; ++j )
+            {
+                auto epj = E[p][j];
+                auto eqj = E[q][j];
+                E[p][j] = cl * epj - sl * eqj;
+                E[q][j] = sl * epj + cl * eqj;
+            }
+            for ( int j = 0; j < N; ++j )
+            {
+                auto ejp = E[j][p];
+                auto ejq = E[j][q];
+                E[j][p] = cr * ejp - sr * ejq;
+                E[j][q] = sr * ejp + cr * ejq;
+
+                auto ujp = U[j][p];
+                auto ujq = U[j][q];
+                U[j][p] = cl * ujp - sl * ujq;
+                U[j][q] = sl * ujp + cl * ujq;
+            }
+            auto vp = v[p];
+            auto vq = v[q];
+            v[p] = cr * vp - sr * vq;
+            v[q] = sr * vp + cr * vq;
 
-            givens_right( U, cl, sl, p, q );
-            givens_left( V, cr, sr, p, q );
+            norm = norm_F( E, false );
+        }
 
-            norm = norm_F_wo_diag( E );
+        bool undetermined = false;
+        for ( int j = 0; j < N; j++ )
+        {
+            double value = 0;
+            for ( int k = 0; k < N; k++ )
+            {
+                if ( std::abs( E[k][k] ) >= threshold )
+                    value += v[k] * U[j][k] / E[k][k];
+                else
+                    undetermined = true;
+            }
+            first_row[j] = value;
         }
 
-        // Compute pseudo-inverse (pseudoA = V pseudoE U^T)
-        // NOTE: the V stored above is actually V^T, but we don't explicitly
-        // transpose it. Instead, we modify the MxM loop below to do (pseudoA =
-        // V^T pseudoE U^T)
-        size_t local_undetermined = 0;
-        for ( int i = 0; i < _n; i++ )
-            for ( int j = 0; j < _n; j++ )
+        return undetermined;
+    }
+};
+
+// SVD pseudo-inversion of a single matrix by a team of threads. Contrary to
+// SVDFixedSize, the Jacobi iterations use a parallel (round-robin) ordering
+// instead of searching for the largest off-diagonal entry. In each of the n-1
+// rounds of a sweep, the indices are split into n/2 disjoint pairs, so the
+// rotations of a round can be computed and applied concurrently by the
+// threads of the team while the vector lanes work on the rows and columns.
+// The working matrices live in team scratch memory, and only the rows of V^T
+// that are needed for the requested rows of the pseudo-inverse are
+// accumulated.
+template <typename DeviceType>
+struct SVDTeam
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    using member_type =
+        typename Kokkos::TeamPolicy<ExecutionSpace>::member_type;
+    using scratch_matrix_type =
+        Kokkos::View<double **, Kokkos::LayoutRight,
+                     typename ExecutionSpace::scratch_memory_space,
+                     Kokkos::MemoryUnmanaged>;
+    using scratch_vector_type =
+        Kokkos::View<double *, typename ExecutionSpace::scratch_memory_space,
+                     Kokkos::MemoryUnmanaged>;
+    using matrix_2x2_type = SVD2x2::matrix_2x2_type;
+
+    // Scratch memory used by pseudo_inverse() for an n x n matrix, in
+    // addition to the matrix itself: U, the first @param n_rows columns of V,
+    // and the rotations of a round.
+    static size_t shmem_size( int n, int n_rows )
+    {
+        int const n_pairs = ( n + 1 ) / 2;
+        return scratch_matrix_type::shmem_size( n, n ) +
+               scratch_matrix_type::shmem_size( n, n_rows ) +
+               4 * scratch_vector_type::shmem_size( n_pairs );
+    }
+
+    // Return the k-th pair (p < q) of the given round for m indices (m even).
+    // Index m-1 stays in place while the others rotate, so that every pair
+    // appears exactly once in m-1 rounds.
+    KOKKOS_INLINE_FUNCTION
+    static void round_robin_pair( int m, int round, int k, int &p, int &q )
+    {
+        if ( k == 0 )
+        {
+            p = round;
+            q = m - 1;
+        }
+        else
+        {
+            p = ( round + k ) % ( m - 1 );
+            q = ( round - k + m - 1 ) % ( m - 1 );
+        }
+        if ( p > q )
+        {
+            auto t = p;
+            p = q;
+            q = t;
+        }
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    static double norm_F( member_type const &team,
+                          scratch_matrix_type const &A, bool with_diagonal )
+    {
+        int const n = A.extent( 0 );
+        double norm = 0.;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange( team, n ),
+            [&]( int i, double &team_sum ) {
+                double row_sum = 0.;
+                Kokkos::parallel_reduce(
+                    Kokkos::ThreadVectorRange( team, n ),
+                    [&]( int j, double &vector_sum ) {
+                        if ( with_diagonal || i != j )
+                            vector_sum += A( i, j ) * A( i, j );
+                    },
+                    row_sum );
+                team_sum += row_sum;
+            },
+            norm );
+
+        return std::sqrt( norm );
+    }
+
+    // Compute the first @param n_rows rows of the pseudo-inverse of the n x n
+    // matrix @param E, which is in team scratch memory and is overwritten.
+    // Each entry is passed to f( i, j, value ). Return true if the matrix is
+    // rank deficient. Must be called by all the threads of the team.
+    template <typename Functor>
+    KOKKOS_INLINE_FUNCTION static bool
+    pseudo_inverse( member_type const &team, scratch_matrix_type const &E,
+                    int n_rows, Functor const &f )
+    {
+        int const n = E.extent( 0 );
+        // Pad to an even number of indices. Pairs involving the extra index
+        // are skipped.
+        int const m = n + n % 2;
+        int const n_pairs = m / 2;
+
+        scratch_matrix_type U( team.team_scratch( 0 ), n, n );
+        // First columns of V, i.e. first rows of V^T
+        scratch_matrix_type V( team.team_scratch( 0 ), n, n_rows );
+        scratch_vector_type cl( team.team_scratch( 0 ), n_pairs );
+        scratch_vector_type sl( team.team_scratch( 0 ), n_pairs );
+        scratch_vector_type cr( team.team_scratch( 0 ), n_pairs );
+        scratch_vector_type sr( team.team_scratch( 0 ), n_pairs );
+
+        Kokkos::parallel_for( Kokkos::TeamThreadRange( team, n ), [&]( int i ) {
+            Kokkos::parallel_for(
+                Kokkos::ThreadVectorRange( team, n ),
+                [&]( int j ) { U( i, j ) = ( i == j ? 1.0 : 0.0 ); } );
+            Kokkos::parallel_for(
+                Kokkos::ThreadVectorRange( team, n_rows ),
+                [&]( int j ) { V( i, j ) = ( i == j ? 1.0 : 0.0 ); } );
+        } );
+        team.team_barrier();
+
+        // The tolerance is relative to the norm of the matrix. Cyclic sweeps
+        // do not bring the off-diagonal entries down to exactly zero, and the
+        // singular values that should be zero are only zero up to rounding.
+        auto const tol = KokkosExt::ArithmeticTraits::epsilon<double>::value;
+        auto const threshold = n * tol * norm_F( team, E, true );
+        auto norm = norm_F( team, E, false );
+        int const max_sweeps = 100;
+        for ( int sweep = 0; sweep < max_sweeps && norm > threshold; ++sweep )
+        {
+            for ( int round = 0; round < m - 1; ++round )
             {
-                double value = 0;
-                for ( int k = 0; k < _n; k++ )
-                {
-                    // TODO: We use machine tolerance here to indicate that all
-                    // diagonal values less than that are considered to be 0. It
-                    // is unclear the numerical implications of such approach
-                    // for matrices where singular values are small nonzeros.
-                    if ( std::abs( E( k, k ) ) >= tol )
-                        value += V( k, i ) * U( j, k ) / E( k, k );
-                    else
-                        local_undetermined = 1;
-                }
-                pseudoA( i * _n + j ) = value;
+                // Obtain left and right Givens rotations of all the pairs by
+                // using 2x2 SVD
+                Kokkos::parallel_for(
+                    Kokkos::TeamThreadRange( team, n_pairs ), [&]( int k ) {
+                        int p, q;
+                        round_robin_pair( m, round, k, p, q );
+                        if ( q >= n )
+                            return;
+
+                        matrix_2x2_type Apq = {{{{E( p, p ), E( p, q )}},
+                                                {{E( q, p ), E( q, q )}}}};
+                        matrix_2x2_type L, D, R;
+                        SVD2x2::svd_2x2( Apq, L, D, R );
+
+                        Kokkos::single( Kokkos::PerThread( team ), [&]() {
+                            cl( k ) = L[0][0];
+                            sl( k ) = L[0][1];
+                            cr( k ) = R[0][0];
+                            sr( k ) = ( sgn( R[0][1] ) == sgn( R[1][0] ) )
+                                          ? -R[0][1]
+                                          : R[0][1];
+                        } );
+                    } );
+                team.team_barrier();
+
+                // Rows of E and V
+                Kokkos::parallel_for(
+                    Kokkos::TeamThreadRange( team, n_pairs ), [&]( int k ) {
+                        int p, q;
+                        round_robin_pair( m, round, k, p, q );
+                        if ( q >= n )
+                            return;
+                        Kokkos::parallel_for(
+                            Kokkos::ThreadVectorRange( team, n ),
+                            [&]( int j ) {
+                                auto epj = E( p, j );
+                                auto eqj = E( q, j );
+                                E( p, j ) = cl( k ) * epj - sl( k ) * eqj;
+                                E( q, j ) = sl( k ) * epj + cl( k ) * eqj;
+                            } );
+                        Kokkos::parallel_for(
+                            Kokkos::ThreadVectorRange( team, n_rows ),
+                            [&]( int j ) {
+                                auto vpj = V( p, j );
+                                auto vqj = V( q, j );
+                                V( p, j ) = cr( k ) * vpj - sr( k ) * vqj;
+                                V( q, j ) = sr( k ) * vpj + cr( k ) * vqj;
+                            } );
+                    } );
+                team.team_barrier();
+
+                // Columns of E and U
+                Kokkos::parallel_for(
+                    Kokkos::TeamThreadRange( team, n_pairs ), [&]( int k ) {
+                        int p, q;
+                        round_robin_pair( m, round, k, p, q );
+                        if ( q >= n )
+                            return;
+                        Kokkos::parallel_for(
+                            Kokkos::ThreadVectorRange( team, n ),
+                            [&]( int j ) {
+                                auto ejp = E( j, p );
+                                auto ejq = E( j, q );
+                                E( j, p ) = cr( k ) * ejp - sr( k ) * ejq;
+                                E( j, q ) = sr( k ) * ejp + cr( k ) * ejq;
+
+                                auto ujp = U( j, p );
+                                auto ujq = U( j, q );
+                                U( j, p ) = cl( k ) * ujp - sl( k ) * ujq;
+                                U( j, q ) = sl( k ) * ujp + cl( k ) * ujq;
+                            } );
+                    } );
+                team.team_barrier();
             }
-        // TODO: when the kernel is switched to multiple threads per team, this
-        // should be fixed. For example, could be an atomic update (as local
-        // counts are not shared).
-        num_underdetermined += local_undetermined;
+
+            norm = norm_F( team, E, false );
+        }
+
+        // Compute pseudo-inverse (pseudoA = V^T pseudoE U^T)
+        Kokkos::parallel_for(
+            Kokkos::TeamThreadRange( team, n_rows ), [&]( int i ) {
+                Kokkos::parallel_for(
+                    Kokkos::ThreadVectorRange( team, n ), [&]( int j ) {
+                        double value = 0;
+                        for ( int k = 0; k < n; k++ )
+                            if ( std::abs( E( k, k ) ) >= threshold )
+                                value += V( k, i ) * U( j, k ) / E( k, k );
+                        f( i, j, value );
+                    } );
+            } );
+
+        bool undetermined = false;
+        for ( int k = 0; k < n; k++ )
+            if ( std::abs( E( k, k ) ) < threshold )
+                undetermined = true;
+        return undetermined;
+    }
+};
+
+// Batched SVD pseudo-inversion of the row-major matrices stored one after the
+// other in a flat view, with one team per matrix.
+//
+// Use with Kokkos::TeamPolicy<ExecutionSpace>( n_matrices, Kokkos::AUTO ).
+// The amount of scratch memory is given by team_shmem_size().
+template <typename DeviceType>
+struct SVDTeamFunctor
+{
+  public:
+    using SVD = SVDTeam<DeviceType>;
+    using member_type = typename SVD::member_type;
+    using flat_matrix_type = Kokkos::View<double *, DeviceType>;
+    using scratch_matrix_type = typename SVD::scratch_matrix_type;
+
+  public:
+    SVDTeamFunctor( int n, typename flat_matrix_type::const_type As,
+                    flat_matrix_type pseudoAs )
+        : _n( n )
+        , _As( As )
+        , _pseudoAs( pseudoAs )
+    {
+    }
+
+    // Scratch memory for E and for the SVD.
+    size_t team_shmem_size( int /*team_size*/ ) const
+    {
+        return scratch_matrix_type::shmem_size( _n, _n ) +
+               SVD::shmem_size( _n, _n );
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()( member_type const &team,
+                     size_t &num_underdetermined ) const
+    {
+        int const n = _n;
+        // The matrices of large batches overflow int indices.
+        std::size_t const offset =
+            static_cast<std::size_t>( team.league_rank() ) * n * n;
+
+        scratch_matrix_type E( team.team_scratch( 0 ), n, n );
+        Kokkos::parallel_for( Kokkos::TeamThreadRange( team, n ), [&]( int i ) {
+            Kokkos::parallel_for(
+                Kokkos::ThreadVectorRange( team, n ),
+                [&]( int j ) { E( i, j ) = _As( offset + i * n + j ); } );
+        } );
+        team.team_barrier();
+
+        bool const undetermined = SVD::pseudo_inverse(
+            team, E, n, [&]( int i, int j, double value ) {
+                _pseudoAs( offset + i * n + j ) = value;
+            } );
+
+        Kokkos::single( Kokkos::PerTeam( team ), [&]() {
+            if ( undetermined )
+                ++num_underdetermined;
+        } );
     }
 
   private:
     int _n;
     typename flat_matrix_type::const_type _As;
     flat_matrix_type _pseudoAs;
-    matrix_type _aux;
 };
 
 } // end namespace Details
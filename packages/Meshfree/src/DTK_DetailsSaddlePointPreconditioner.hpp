@@ -0,0 +1,399 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_SADDLE_POINT_PRECONDITIONER_HPP
+#define DTK_SADDLE_POINT_PRECONDITIONER_HPP
+
+#include <DTK_DBC.hpp>
+#include <DTK_Types.h>
+
+#include <Teuchos_RCP.hpp>
+
+#include <Tpetra_Map.hpp>
+#include <Tpetra_MultiVector.hpp>
+#include <Tpetra_Operator.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+namespace DataTransferKit
+{
+
+/**
+ * Preconditioner for the saddle point system C = [M V; V^T 0] of the spline
+ * interpolation, where M is the radial basis function block over the source
+ * points and V is the Vandermonde matrix of the polynomial basis. The
+ * polynomial degrees of freedom are the last rows on processor 0.
+ *
+ * The preconditioner is the block lower triangular matrix [M~ 0; V^T S~]
+ * where M~ is the block Jacobi approximation of M, each processor keeping the
+ * incomplete LU factorization ILU(0) of its diagonal block, and S~ = -V^T
+ * M~^-1 V is the corresponding Schur complement. Both are factored once at
+ * construction and reused by every apply(). The factorization and the
+ * triangular solves are sequential and run on the host. The same factors are
+ * used to apply the transpose of the preconditioner.
+ */
+template <typename Scalar, typename LocalOrdinal, typename GlobalOrdinal,
+          typename Node>
+class SaddlePointPreconditioner
+    : public Tpetra::Operator<Scalar, LocalOrdinal, GlobalOrdinal, Node>
+{
+    using DeviceType = typename Node::device_type;
+    using Map = Tpetra::Map<LocalOrdinal, GlobalOrdinal, Node>;
+    using MultiVector =
+        Tpetra::MultiVector<Scalar, LocalOrdinal, GlobalOrdinal, Node>;
+
+  public:
+    // The neighbor lists and the values of M are given in the format of
+    // BasisMatrix, the local index of a neighbor being its row in the map.
+    SaddlePointPreconditioner(
+        MPI_Comm comm, Kokkos::View<int const *, DeviceType> offset,
+        Kokkos::View<int const *, DeviceType> ranks,
+        Kokkos::View<int const *, DeviceType> indices,
+        Kokkos::View<double const *, DeviceType> values,
+        Kokkos::View<double const **, DeviceType> vandermonde,
+        const Teuchos::RCP<const Map> &map )
+        : _comm( comm )
+        , _map( map )
+    {
+        int comm_rank;
+        MPI_Comm_rank( _comm, &comm_rank );
+
+        _n_points = vandermonde.extent( 0 );
+        _poly_size = vandermonde.extent( 1 );
+        DTK_REQUIRE( offset.extent_int( 0 ) <= _n_points + 1 );
+        DTK_REQUIRE( static_cast<int>( _map->getNodeNumElements() ) ==
+                     _n_points + ( comm_rank == 0 ? _poly_size : 0 ) );
+
+        auto vandermonde_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{}, vandermonde );
+        _vandermonde.resize( _n_points * _poly_size );
+        for ( int i = 0; i < _n_points; ++i )
+            for ( int p = 0; p < _poly_size; ++p )
+                _vandermonde[i * _poly_size + p] = vandermonde_host( i, p );
+
+        factorDiagonalBlock( offset, ranks, indices, values, comm_rank );
+        factorSchurComplement();
+    }
+
+    Teuchos::RCP<const Map> getDomainMap() const override { return _map; }
+
+    Teuchos::RCP<const Map> getRangeMap() const override { return _map; }
+
+    void
+    apply( const MultiVector &X, MultiVector &Y,
+           Teuchos::ETransp mode = Teuchos::NO_TRANS,
+           Scalar alpha = Teuchos::ScalarTraits<Scalar>::one(),
+           Scalar beta = Teuchos::ScalarTraits<Scalar>::zero() ) const override
+    {
+        DTK_REQUIRE( _map->isSameAs( *( X.getMap() ) ) );
+        DTK_REQUIRE( _map->isSameAs( *( Y.getMap() ) ) );
+        DTK_REQUIRE( X.getNumVectors() == Y.getNumVectors() );
+        DTK_REQUIRE( mode == Teuchos::NO_TRANS || mode == Teuchos::TRANS );
+
+        int comm_rank;
+        MPI_Comm_rank( _comm, &comm_rank );
+        int const num_vec = X.getNumVectors();
+
+        auto x = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{},
+                                                      X.getLocalViewDevice() );
+        auto y = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{},
+                                                      Y.getLocalViewDevice() );
+
+        if ( mode == Teuchos::TRANS )
+        {
+            applyTranspose( x, y, alpha, beta, comm_rank );
+            Kokkos::deep_copy( Y.getLocalViewDevice(), y );
+            return;
+        }
+
+        std::vector<double> z( _n_points );
+        std::vector<double> residual( _poly_size * num_vec, 0. );
+        for ( int k = 0; k < num_vec; ++k )
+        {
+            // z = M~^-1 x
+            for ( int i = 0; i < _n_points; ++i )
+                z[i] = x( i, k );
+            solveDiagonalBlock( z.data() );
+
+            for ( int i = 0; i < _n_points; ++i )
+            {
+                y( i, k ) = beta * y( i, k ) + alpha * z[i];
+                for ( int p = 0; p < _poly_size; ++p )
+                    residual[k * _poly_size + p] +=
+                        _vandermonde[i * _poly_size + p] * z[i];
+            }
+        }
+
+        // The polynomial part of the solution is S~^-1 (x - V^T z).
+        MPI_Allreduce( MPI_IN_PLACE, residual.data(), _poly_size * num_vec,
+                       MPI_DOUBLE, MPI_SUM, _comm );
+        if ( comm_rank == 0 )
+            for ( int k = 0; k < num_vec; ++k )
+                for ( int p = 0; p < _poly_size; ++p )
+                {
+                    double y_p = 0.;
+                    for ( int q = 0; q < _poly_size; ++q )
+                        y_p += _inv_schur[p * _poly_size + q] *
+                               ( x( _n_points + q, k ) -
+                                 residual[k * _poly_size + q] );
+                    y( _n_points + p, k ) =
+                        beta * y( _n_points + p, k ) + alpha * y_p;
+                }
+
+        Kokkos::deep_copy( Y.getLocalViewDevice(), y );
+    }
+
+    bool hasTransposeApply() const override { return true; }
+
+  private:
+    // The transpose [M~^T V; 0 S~^T] is block upper triangular. The
+    // polynomial part is computed first, y_p = S~^-T x_p, and broadcast to
+    // all the processors, then y = M~^-T (x - V y_p).
+    template <typename XView, typename YView>
+    void applyTranspose( XView x, YView y, Scalar alpha, Scalar beta,
+                         int comm_rank ) const
+    {
+        int const num_vec = x.extent( 1 );
+
+        std::vector<double> y_poly( _poly_size * num_vec, 0. );
+        if ( comm_rank == 0 )
+            for ( int k = 0; k < num_vec; ++k )
+                for ( int p = 0; p < _poly_size; ++p )
+                    for ( int q = 0; q < _poly_size; ++q )
+                        y_poly[k * _poly_size + p] +=
+                            _inv_schur[q * _poly_size + p] *
+                            x( _n_points + q, k );
+        MPI_Bcast( y_poly.data(), _poly_size * num_vec, MPI_DOUBLE, 0, _comm );
+
+        std::vector<double> z( _n_points );
+        for ( int k = 0; k < num_vec; ++k )
+        {
+            for ( int i = 0; i < _n_points; ++i )
+            {
+                z[i] = x( i, k );
+                for ( int p = 0; p < _poly_size; ++p )
+                    z[i] -= _vandermonde[i * _poly_size + p] *
+                            y_poly[k * _poly_size + p];
+            }
+            solveTransposedDiagonalBlock( z.data() );
+
+            for ( int i = 0; i < _n_points; ++i )
+                y( i, k ) = beta * y( i, k ) + alpha * z[i];
+            if ( comm_rank == 0 )
+                for ( int p = 0; p < _poly_size; ++p )
+                    y( _n_points + p, k ) = beta * y( _n_points + p, k ) +
+                                            alpha * y_poly[k * _poly_size + p];
+        }
+    }
+
+    // Extract the block of M that couples the points owned by this processor
+    // and compute its ILU(0) factorization in place. A missing or zero pivot
+    // is replaced by one.
+    void factorDiagonalBlock( Kokkos::View<int const *, DeviceType> offset,
+                              Kokkos::View<int const *, DeviceType> ranks,
+                              Kokkos::View<int const *, DeviceType> indices,
+                              Kokkos::View<double const *, DeviceType> values,
+                              int comm_rank )
+    {
+        auto offset_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{}, offset );
+        auto ranks_host =
+            Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, ranks );
+        auto indices_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{}, indices );
+        auto values_host =
+            Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, values );
+        int const n_rows = offset.extent_int( 0 ) - 1;
+
+        // Sorted rows with a diagonal entry and without duplicated columns.
+        _row_ptrs.assign( _n_points + 1, 0 );
+        _columns.clear();
+        _values.clear();
+        _diagonal.resize( _n_points );
+        std::vector<std::pair<int, double>> row;
+        for ( int i = 0; i < _n_points; ++i )
+        {
+            row.clear();
+            row.emplace_back( i, 0. );
+            if ( i < n_rows )
+                for ( int j = offset_host( i ); j < offset_host( i + 1 ); ++j )
+                    if ( ranks_host( j ) == comm_rank )
+                        row.emplace_back( indices_host( j ), values_host( j ) );
+            std::sort( row.begin(), row.end(),
+                       []( std::pair<int, double> const &a,
+                           std::pair<int, double> const &b ) {
+                           return a.first < b.first;
+                       } );
+            for ( auto const &entry : row )
+            {
+                if ( static_cast<int>( _columns.size() ) > _row_ptrs[i] &&
+                     _columns.back() == entry.first )
+                {
+                    _values.back() += entry.second;
+                    continue;
+                }
+                if ( entry.first == i )
+                    _diagonal[i] = _columns.size();
+                _columns.push_back( entry.first );
+                _values.push_back( entry.second );
+            }
+            _row_ptrs[i + 1] = _columns.size();
+        }
+
+        // ILU(0), IKJ variant.
+        std::vector<int> position( _n_points, -1 );
+        for ( int i = 0; i < _n_points; ++i )
+        {
+            for ( int p = _row_ptrs[i]; p < _row_ptrs[i + 1]; ++p )
+                position[_columns[p]] = p;
+            for ( int p = _row_ptrs[i]; p < _diagonal[i]; ++p )
+            {
+                int const k = _columns[p];
+                _values[p] /= _values[_diagonal[k]];
+                for ( int q = _diagonal[k] + 1; q < _row_ptrs[k + 1]; ++q )
+                    if ( position[_columns[q]] >= 0 )
+                        _values[position[_columns[q]]] -=
+                            _values[p] * _values[q];
+            }
+            for ( int p = _row_ptrs[i]; p < _row_ptrs[i + 1]; ++p )
+                position[_columns[p]] = -1;
+            if ( std::abs( _values[_diagonal[i]] ) <
+                 std::numeric_limits<double>::epsilon() )
+                _values[_diagonal[i]] = 1.;
+        }
+    }
+
+    // Solve L U z = b in place.
+    void solveDiagonalBlock( double *z ) const
+    {
+        for ( int i = 0; i < _n_points; ++i )
+            for ( int p = _row_ptrs[i]; p < _diagonal[i]; ++p )
+                z[i] -= _values[p] * z[_columns[p]];
+        for ( int i = _n_points - 1; i >= 0; --i )
+        {
+            for ( int p = _diagonal[i] + 1; p < _row_ptrs[i + 1]; ++p )
+                z[i] -= _values[p] * z[_columns[p]];
+            z[i] /= _values[_diagonal[i]];
+        }
+    }
+
+    // Solve (L U)^T z = U^T L^T z = b in place. The factors are stored by
+    // rows so the triangular solves go through them by columns.
+    void solveTransposedDiagonalBlock( double *z ) const
+    {
+        for ( int i = 0; i < _n_points; ++i )
+        {
+            z[i] /= _values[_diagonal[i]];
+            for ( int p = _diagonal[i] + 1; p < _row_ptrs[i + 1]; ++p )
+                z[_columns[p]] -= _values[p] * z[i];
+        }
+        for ( int i = _n_points - 1; i >= 0; --i )
+            for ( int p = _row_ptrs[i]; p < _diagonal[i]; ++p )
+                z[_columns[p]] -= _values[p] * z[i];
+    }
+
+    // Compute S~ = -V^T M~^-1 V and its inverse by Gauss-Jordan elimination
+    // with partial pivoting. If S~ is singular, e.g. because the source
+    // points are coplanar, only its diagonal is inverted.
+    void factorSchurComplement()
+    {
+        int const n = _poly_size;
+        std::vector<double> schur( n * n, 0. );
+        std::vector<double> z( _n_points );
+        for ( int q = 0; q < n; ++q )
+        {
+            for ( int i = 0; i < _n_points; ++i )
+                z[i] = _vandermonde[i * n + q];
+            solveDiagonalBlock( z.data() );
+            for ( int i = 0; i < _n_points; ++i )
+                for ( int p = 0; p < n; ++p )
+                    schur[p * n + q] -= _vandermonde[i * n + p] * z[i];
+        }
+        MPI_Allreduce( MPI_IN_PLACE, schur.data(), n * n, MPI_DOUBLE, MPI_SUM,
+                       _comm );
+
+        double max_entry = 0.;
+        for ( double const s : schur )
+            max_entry = std::max( max_entry, std::abs( s ) );
+        double const threshold =
+            max_entry * n * std::numeric_limits<double>::epsilon();
+
+        std::vector<double> a = schur;
+        _inv_schur.assign( n * n, 0. );
+        for ( int p = 0; p < n; ++p )
+            _inv_schur[p * n + p] = 1.;
+        for ( int c = 0; c < n; ++c )
+        {
+            int pivot = c;
+            for ( int r = c + 1; r < n; ++r )
+                if ( std::abs( a[r * n + c] ) > std::abs( a[pivot * n + c] ) )
+                    pivot = r;
+            if ( !( std::abs( a[pivot * n + c] ) > threshold ) )
+            {
+                _inv_schur.assign( n * n, 0. );
+                for ( int p = 0; p < n; ++p )
+                    _inv_schur[p * n + p] =
+                        std::abs( schur[p * n + p] ) > threshold
+                            ? 1. / schur[p * n + p]
+                            : 1.;
+                return;
+            }
+            for ( int k = 0; k < n; ++k )
+            {
+                std::swap( a[c * n + k], a[pivot * n + k] );
+                std::swap( _inv_schur[c * n + k], _inv_schur[pivot * n + k] );
+            }
+            double const inv_pivot = 1. / a[c * n + c];
+            for ( int k = 0; k < n; ++k )
+            {
+                a[c * n + k] *= inv_pivot;
+                _inv_schur[c * n + k] *= inv_pivot;
+            }
+            for ( int r = 0; r < n; ++r )
+                if ( r != c )
+                {
+                    double const factor = a[r * n + c];
+                    for ( int k = 0; k < n; ++k )
+                    {
+                        a[r * n + k] -= factor * a[c * n + k];
+                        _inv_schur[r * n + k] -= factor * _inv_schur[c * n + k];
+                    }
+                }
+        }
+    }
+
+    MPI_Comm _comm;
+    Teuchos::RCP<const Map> _map;
+    int _n_points;
+    int _poly_size;
+    // Vandermonde matrix, row-major.
+    std::vector<double> _vandermonde;
+    // ILU(0) factors of the diagonal block in CRS format. The unit diagonal
+    // of L is not stored.
+    std::vector<int> _row_ptrs;
+    std::vector<int> _columns;
+    std::vector<double> _values;
+    std::vector<int> _diagonal;
+    // Inverse of the Schur complement, row-major.
+    std::vector<double> _inv_schur;
+};
+
+} // end namespace DataTransferKit
+
+#endif
@@ -0,0 +1,160 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DETAILS_SPACE_FILLING_CURVE_IMPL_HPP
+#define DTK_DETAILS_SPACE_FILLING_CURVE_IMPL_HPP
+
+#include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_Sort.hpp>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+
+/**
+ * Ordering of point clouds along the Z-order (Morton) curve. Points that are
+ * close in this order are close in space, so processing the target points of
+ * an operator in this order instead of the order chosen by the user improves
+ * the locality of the accesses to the search tree and to the neighbor data.
+ */
+template <typename DeviceType>
+struct SpaceFillingCurveImpl
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    // Insert two zeros between each of the 10 lowest bits of v.
+    KOKKOS_INLINE_FUNCTION static unsigned int expandBits( unsigned int v )
+    {
+        v = ( v * 0x00010001u ) & 0xFF0000FFu;
+        v = ( v * 0x00000101u ) & 0x0F00F00Fu;
+        v = ( v * 0x00000011u ) & 0xC30C30C3u;
+        v = ( v * 0x00000005u ) & 0x49249249u;
+        return v;
+    }
+
+    // Position of u in [0, 1] on a grid of 1024 cells.
+    KOKKOS_INLINE_FUNCTION static unsigned int quantize( double u )
+    {
+        double const cell = u * 1024.;
+        if ( cell < 0. )
+            return 0u;
+        if ( cell > 1023. )
+            return 1023u;
+        return static_cast<unsigned int>( cell );
+    }
+
+    // 30-bit Morton code of a point of the unit cube.
+    KOKKOS_INLINE_FUNCTION static unsigned int mortonCode( double x, double y,
+                                                           double z )
+    {
+        return 4 * expandBits( quantize( x ) ) +
+               2 * expandBits( quantize( y ) ) + expandBits( quantize( z ) );
+    }
+
+    /**
+     * Return the permutation that sorts @param points along the Z-order curve
+     * of their bounding box: the k-th point in Z-order is
+     * points(permutation(k)). Points with the same Morton code stay in their
+     * original order so that the permutation is deterministic.
+     */
+    static Kokkos::View<int *, DeviceType>
+    sortAlongZOrder( Kokkos::View<Coordinate const **, DeviceType> points )
+    {
+        int const n_points = points.extent_int( 0 );
+        int const dim = points.extent_int( 1 );
+        DTK_REQUIRE( dim <= 3 );
+
+        // Map the bounding box of the points to the unit cube. A flat
+        // dimension does not contribute to the codes.
+        double origin[3] = {0., 0., 0.};
+        double scale[3] = {0., 0., 0.};
+        for ( int d = 0; d < dim; ++d )
+        {
+            double min_coord = 0.;
+            double max_coord = 0.;
+            Kokkos::parallel_reduce(
+                DTK_MARK_REGION( "z_order::min_coordinate" ),
+                Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+                KOKKOS_LAMBDA( int i, double &m ) {
+                    if ( points( i, d ) < m )
+                        m = points( i, d );
+                },
+                Kokkos::Min<double>( min_coord ) );
+            Kokkos::parallel_reduce(
+                DTK_MARK_REGION( "z_order::max_coordinate" ),
+                Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+                KOKKOS_LAMBDA( int i, double &m ) {
+                    if ( points( i, d ) > m )
+                        m = points( i, d );
+                },
+                Kokkos::Max<double>( max_coord ) );
+            origin[d] = min_coord;
+            scale[d] = max_coord > min_coord ? 1. / ( max_coord - min_coord )
+                                             : 0.;
+        }
+
+        // The code of a point is stored in the high bits of its key and its
+        // index in the low bits so that sorting the keys sorts the points.
+        Kokkos::View<unsigned long long *, DeviceType> keys( "z_order_keys",
+                                                             n_points );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "z_order::compute_keys" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            KOKKOS_LAMBDA( int i ) {
+                double u[3] = {0., 0., 0.};
+                for ( int d = 0; d < dim; ++d )
+                    u[d] = ( points( i, d ) - origin[d] ) * scale[d];
+                keys( i ) = ( static_cast<unsigned long long>(
+                                  mortonCode( u[0], u[1], u[2] ) )
+                              << 32 ) |
+                            static_cast<unsigned long long>( i );
+            } );
+        if ( n_points > 1 )
+            Kokkos::sort( keys );
+
+        Kokkos::View<int *, DeviceType> permutation( "z_order_permutation",
+                                                     n_points );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "z_order::extract_permutation" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            KOKKOS_LAMBDA( int k ) {
+                permutation( k ) =
+                    static_cast<int>( keys( k ) & 0xFFFFFFFFull );
+            } );
+        Kokkos::fence();
+
+        return permutation;
+    }
+
+    // Return the position of the i-th point in the sorted order.
+    static Kokkos::View<int *, DeviceType>
+    invertPermutation( Kokkos::View<int const *, DeviceType> permutation )
+    {
+        int const n = permutation.extent_int( 0 );
+        Kokkos::View<int *, DeviceType> inverse( "inverse_permutation", n );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "z_order::invert_permutation" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+            KOKKOS_LAMBDA( int k ) { inverse( permutation( k ) ) = k; } );
+        Kokkos::fence();
+
+        return inverse;
+    }
+};
+
+} // namespace Details
+} // namespace DataTransferKit
+
+#endif
@@ -90,8 +90,12 @@ class SplineProlongationOperator
            Scalar alpha = Teuchos::ScalarTraits<Scalar>::one(),
            Scalar beta = Teuchos::ScalarTraits<Scalar>::zero() ) const override
     {
-        DTK_REQUIRE( _domain_map->isSameAs( *( X.getMap() ) ) );
-        DTK_REQUIRE( _range_map->isSameAs( *( Y.getMap() ) ) );
+        DTK_REQUIRE( mode == Teuchos::NO_TRANS || mode == Teuchos::TRANS );
+        bool const transpose = mode == Teuchos::TRANS;
+        DTK_REQUIRE( ( transpose ? _range_map : _domain_map )
+                         ->isSameAs( *( X.getMap() ) ) );
+        DTK_REQUIRE( ( transpose ? _domain_map : _range_map )
+                         ->isSameAs( *( Y.getMap() ) ) );
         DTK_REQUIRE( X.getNumVectors() == Y.getNumVectors() );
 
         using DeviceType = typename Node::device_type;
@@ -102,6 +106,8 @@ class SplineProlongationOperator
 
         auto const num_vectors = x_view.extent_int( 1 );
 
+        // The polynomial coefficients are the last rows of the range. The
+        // prolongation leaves them untouched and its transpose drops them.
         Y.scale( beta );
         Kokkos::parallel_for( DTK_MARK_REGION( "spline_prolongation::apply" ),
                               Kokkos::RangePolicy<ExecutionSpace>( 0, _lda ),
@@ -112,7 +118,7 @@ class SplineProlongationOperator
     }
     /// \brief Whether this operator supports applying the transpose or
     /// conjugate transpose.
-    bool hasTransposeApply() const override { return false; }
+    bool hasTransposeApply() const override { return true; }
 
   private:
     int _lda;
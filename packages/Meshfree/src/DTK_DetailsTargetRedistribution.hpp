@@ -0,0 +1,274 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DETAILS_TARGET_REDISTRIBUTION_HPP
+#define DTK_DETAILS_TARGET_REDISTRIBUTION_HPP
+
+#include <ArborX.hpp>
+#include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+#include <DTK_DetailsOperatorUpdateImpl.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+
+#include <mpi.h>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+
+/**
+ * Redistribution of the target points of an operator so that every processor
+ * sets up the same number of them. When some processors own many more target
+ * points than the others, they are the bottleneck of the setup. The balance
+ * is on the number of targets only: the neighbors are not known before the
+ * redistribution, so a target with many neighbors, e.g. in a dense region
+ * with a radius search, weighs as much as one with few.
+ *
+ * The targets of the whole communicator are numbered processor by processor,
+ * in the order of each processor, and split into consecutive chunks of the
+ * same size, one per processor. A chunk is thus made of the end of the
+ * targets of a processor followed by the beginning of those of the next
+ * ones. Its targets are only close to each other if the user ordered them
+ * so, and the parts that come from different processors need not be close
+ * at all.
+ *
+ * The constructor sends the targets to their new processor. The operator
+ * searches the neighbors of getTargetPoints() and computes their weights
+ * there, then sendListsBack() and sendValuesBack() return the neighbor lists
+ * and the values associated with their entries to the processors that own
+ * the targets. The lists come back in the order of the targets given at
+ * construction.
+ *
+ * When the redistribution is disabled, no data is exchanged and the views are
+ * returned as they are.
+ */
+template <typename DeviceType>
+class TargetRedistribution
+{
+  public:
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    // Collective.
+    TargetRedistribution(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        bool enabled )
+        : _comm( comm )
+        , _enabled( enabled )
+        , _n_targets( target_points.extent_int( 0 ) )
+        , _target_points( target_points )
+        , _origin_ranks( "origin_ranks", 0 )
+        , _origin_indices( "origin_indices", 0 )
+        , _return_distributor( comm )
+        , _return_positions( "return_positions", 0 )
+    {
+        if ( !_enabled )
+            return;
+
+        int comm_rank;
+        MPI_Comm_rank( _comm, &comm_rank );
+        int comm_size;
+        MPI_Comm_size( _comm, &comm_size );
+
+        long long n_local = _n_targets;
+        long long first = 0;
+        MPI_Exscan( &n_local, &first, 1, MPI_LONG_LONG, MPI_SUM, _comm );
+        if ( comm_rank == 0 )
+            first = 0;
+        long long n_global = n_local;
+        MPI_Allreduce( MPI_IN_PLACE, &n_global, 1, MPI_LONG_LONG, MPI_SUM,
+                       _comm );
+
+        Kokkos::View<int *, DeviceType> destinations( "destinations",
+                                                      _n_targets );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "assign_targets" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, _n_targets ),
+            KOKKOS_LAMBDA( int i ) {
+                destinations( i ) = static_cast<int>(
+                    ( ( first + i ) * comm_size ) / n_global );
+            } );
+        Kokkos::fence();
+
+        ArborX::Details::Distributor<DeviceType> distributor( _comm );
+        int const n_imports =
+            distributor.createFromSends( ExecutionSpace{}, destinations );
+
+        Kokkos::View<Coordinate **, DeviceType> imported_points(
+            "target_points", n_imports, target_points.extent( 1 ) );
+        ArborX::Details::DistributedSearchTreeImpl<
+            DeviceType>::sendAcrossNetwork( ExecutionSpace{}, distributor,
+                                            target_points, imported_points );
+        _target_points = imported_points;
+
+        // Remember where the targets come from to send the results back.
+        Kokkos::View<int *, DeviceType> export_ranks( "ranks", _n_targets );
+        Kokkos::deep_copy( export_ranks, comm_rank );
+        Kokkos::realloc( _origin_ranks, n_imports );
+        ArborX::Details::DistributedSearchTreeImpl<
+            DeviceType>::sendAcrossNetwork( ExecutionSpace{}, distributor,
+                                            export_ranks, _origin_ranks );
+
+        Kokkos::View<int *, DeviceType> export_indices( "indices",
+                                                        _n_targets );
+        ArborX::iota( ExecutionSpace{}, export_indices );
+        Kokkos::realloc( _origin_indices, n_imports );
+        ArborX::Details::DistributedSearchTreeImpl<
+            DeviceType>::sendAcrossNetwork( ExecutionSpace{}, distributor,
+                                            export_indices, _origin_indices );
+    }
+
+    /**
+     * Target points that this processor must set up.
+     */
+    Kokkos::View<Coordinate const **, DeviceType> getTargetPoints() const
+    {
+        return _target_points;
+    }
+
+    /**
+     * Send the neighbor lists of getTargetPoints(), in CRS format with offset
+     * @param offset, back to the processors that own the targets and return
+     * the offset of the lists of the targets given at construction. The
+     * entries of a list keep their order. Collective.
+     */
+    Kokkos::View<int *, DeviceType>
+    sendListsBack( Kokkos::View<int *, DeviceType> offset )
+    {
+        DTK_REQUIRE( offset.extent_int( 0 ) ==
+                     _target_points.extent_int( 0 ) + 1 );
+        if ( !_enabled )
+            return offset;
+
+        int const n_imports = _origin_ranks.extent( 0 );
+        int const n_entries = ArborX::lastElement( offset );
+        Kokkos::View<int *, DeviceType> destinations( "destinations",
+                                                      n_entries );
+        Kokkos::View<int *, DeviceType> export_targets( "targets", n_entries );
+        Kokkos::View<int *, DeviceType> export_positions( "positions",
+                                                          n_entries );
+        auto origin_ranks = _origin_ranks;
+        auto origin_indices = _origin_indices;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "prepare_lists_return" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+            KOKKOS_LAMBDA( int i ) {
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                {
+                    destinations( j ) = origin_ranks( i );
+                    export_targets( j ) = origin_indices( i );
+                    export_positions( j ) = j - offset( i );
+                }
+            } );
+        Kokkos::fence();
+
+        int const n_returns = _return_distributor.createFromSends(
+            ExecutionSpace{}, destinations );
+        Kokkos::View<int *, DeviceType> import_targets( "targets", n_returns );
+        ArborX::Details::DistributedSearchTreeImpl<
+            DeviceType>::sendAcrossNetwork( ExecutionSpace{},
+                                            _return_distributor,
+                                            export_targets, import_targets );
+        Kokkos::View<int *, DeviceType> import_positions( "positions",
+                                                          n_returns );
+        ArborX::Details::DistributedSearchTreeImpl<
+            DeviceType>::sendAcrossNetwork( ExecutionSpace{},
+                                            _return_distributor,
+                                            export_positions,
+                                            import_positions );
+
+        // The entries arrive in no particular order. Count the entries of
+        // each target and place every entry at its position in its list.
+        Kokkos::View<int *, DeviceType> returned_offset( "offset",
+                                                         _n_targets + 1 );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "count_returned_entries" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_returns ),
+            KOKKOS_LAMBDA( int k ) {
+                Kokkos::atomic_add( &returned_offset( import_targets( k ) ),
+                                    1 );
+            } );
+        ArborX::exclusivePrefixSum( ExecutionSpace{}, returned_offset );
+
+        Kokkos::realloc( _return_positions, n_returns );
+        auto return_positions = _return_positions;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "position_returned_entries" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_returns ),
+            KOKKOS_LAMBDA( int k ) {
+                return_positions( k ) = returned_offset( import_targets( k ) ) +
+                                        import_positions( k );
+            } );
+        Kokkos::fence();
+
+        return returned_offset;
+    }
+
+    /**
+     * Send the values associated with the entries of the lists passed to
+     * sendListsBack() to the processors that own the targets. @param values
+     * is a rank-1 or rank-2 view with one row per entry. Collective.
+     */
+    template <typename View>
+    View sendValuesBack( View values ) const
+    {
+        static_assert( View::rank == 1 || View::rank == 2,
+                       "sendValuesBack() requires rank-1 or rank-2 views" );
+        static_assert(
+            std::is_same<typename View::value_type,
+                         typename View::non_const_value_type>::value,
+            "sendValuesBack() requires views of non-const values" );
+        if ( !_enabled )
+            return values;
+
+        int const n_returns = _return_positions.extent( 0 );
+        auto imported_values =
+            View::rank == 1
+                ? View( values.label(), n_returns )
+                : View( values.label(), n_returns, values.extent( 1 ) );
+        ArborX::Details::DistributedSearchTreeImpl<
+            DeviceType>::sendAcrossNetwork( ExecutionSpace{},
+                                            _return_distributor, values,
+                                            imported_values );
+
+        auto returned_values =
+            View::rank == 1
+                ? View( values.label(), n_returns )
+                : View( values.label(), n_returns, values.extent( 1 ) );
+        OperatorUpdateImpl<DeviceType>::scatterRows(
+            imported_values, _return_positions, returned_values );
+
+        return returned_values;
+    }
+
+  private:
+    MPI_Comm _comm;
+    bool _enabled;
+    int _n_targets;
+    Kokkos::View<Coordinate const **, DeviceType> _target_points;
+    // Processor that owns the i-th target of getTargetPoints() and its local
+    // index on that processor.
+    Kokkos::View<int *, DeviceType> _origin_ranks;
+    Kokkos::View<int *, DeviceType> _origin_indices;
+    // Built by sendListsBack(). The k-th returned entry goes to the position
+    // _return_positions(k) of the lists.
+    ArborX::Details::Distributor<DeviceType> _return_distributor;
+    Kokkos::View<int *, DeviceType> _return_positions;
+};
+
+} // namespace Details
+} // namespace DataTransferKit
+
+#endif
@@ -0,0 +1,171 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DISTRIBUTED_CRS_MATRIX_HPP
+#define DTK_DISTRIBUTED_CRS_MATRIX_HPP
+
+#include <DTK_DBC.hpp>
+#include <DTK_DetailsCommunicationPlan.hpp>
+
+#include <Kokkos_Core.hpp>
+
+namespace DataTransferKit
+{
+
+/**
+ * Explicit representation of a PointCloudOperator as a sparse matrix. The
+ * rows are the local target points and the columns are the source points
+ * that at least one local target point depends on, each of them appearing
+ * once (the halo). The matrix is stored in CRS format with local column
+ * indices. The owner of the j-th column and its local index on that
+ * processor are getColumnRanks()(j) and getColumnIndices()(j).
+ *
+ * apply() gathers the halo with a single exchange of data and multiplies it
+ * by the matrix on the device. The matrix can also be extracted with the
+ * getters to be fed to another linear algebra package.
+ */
+template <typename DeviceType>
+class DistributedCrsMatrix
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+  public:
+    /**
+     * The j-th entry of the matrix is associated with the j-th (rank, index)
+     * pair that @param plan was built from. Entries that refer to the same
+     * source point are not merged.
+     */
+    DistributedCrsMatrix( Details::CommunicationPlan<DeviceType> const &plan,
+                          Kokkos::View<int const *, DeviceType> row_ptrs,
+                          Kokkos::View<double const *, DeviceType> values )
+        : DistributedCrsMatrix( plan, row_ptrs, plan.getImportPositions(),
+                                values )
+    {
+    }
+
+    /**
+     * Same as above when the entries of the matrix are not in the order of
+     * the requests of @param plan. The j-th entry is in the column
+     * @param columns (j).
+     */
+    DistributedCrsMatrix( Details::CommunicationPlan<DeviceType> const &plan,
+                          Kokkos::View<int const *, DeviceType> row_ptrs,
+                          Kokkos::View<int const *, DeviceType> columns,
+                          Kokkos::View<double const *, DeviceType> values )
+        : _plan( plan )
+        , _row_ptrs( row_ptrs )
+        , _columns( columns )
+        , _values( values )
+    {
+        DTK_REQUIRE( _row_ptrs.extent( 0 ) > 0 );
+        DTK_REQUIRE( _values.extent_int( 0 ) == _plan.getNumberOfRequests() );
+        DTK_REQUIRE( _columns.extent( 0 ) == _values.extent( 0 ) );
+    }
+
+    MPI_Comm getComm() const { return _plan.getComm(); }
+
+    int getNumberOfRows() const { return _row_ptrs.extent_int( 0 ) - 1; }
+
+    int getNumberOfColumns() const { return _plan.getNumberOfImports(); }
+
+    Kokkos::View<int const *, DeviceType> getRowPtrs() const
+    {
+        return _row_ptrs;
+    }
+
+    Kokkos::View<int const *, DeviceType> getColumns() const
+    {
+        return _columns;
+    }
+
+    Kokkos::View<double const *, DeviceType> getValues() const
+    {
+        return _values;
+    }
+
+    Kokkos::View<int const *, DeviceType> getColumnRanks() const
+    {
+        return _plan.getImportRanks();
+    }
+
+    Kokkos::View<int const *, DeviceType> getColumnIndices() const
+    {
+        return _plan.getImportIndices();
+    }
+
+    /**
+     * Compute the product of the matrix with the source values. Collective.
+     */
+    void apply( Kokkos::View<double const *, DeviceType> source_values,
+                Kokkos::View<double *, DeviceType> target_values ) const
+    {
+        DTK_REQUIRE( target_values.extent_int( 0 ) == getNumberOfRows() );
+
+        auto x = _plan.fetchImports( source_values );
+
+        // To avoid capturing *this
+        auto row_ptrs = _row_ptrs;
+        auto columns = _columns;
+        auto values = _values;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "distributed_crs_matrix::spmv" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, getNumberOfRows() ),
+            KOKKOS_LAMBDA( int const i ) {
+                double sum = 0.;
+                for ( int j = row_ptrs( i ); j < row_ptrs( i + 1 ); ++j )
+                    sum += values( j ) * x( columns( j ), 0 );
+                target_values( i ) = sum;
+            } );
+    }
+
+    /**
+     * Compute the product of the matrix with several fields at once, one per
+     * column of the views. The halo values of all the fields of a source
+     * point are contiguous so that the innermost loop runs over the fields.
+     */
+    void apply( Kokkos::View<double const **, DeviceType> source_values,
+                Kokkos::View<double **, DeviceType> target_values ) const
+    {
+        DTK_REQUIRE( target_values.extent_int( 0 ) == getNumberOfRows() );
+        DTK_REQUIRE( target_values.extent( 1 ) == source_values.extent( 1 ) );
+
+        auto x = _plan.fetchImports( source_values );
+
+        int const n_fields = source_values.extent( 1 );
+        auto row_ptrs = _row_ptrs;
+        auto columns = _columns;
+        auto values = _values;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "distributed_crs_matrix::spmm" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, getNumberOfRows() ),
+            KOKKOS_LAMBDA( int const i ) {
+                for ( int k = 0; k < n_fields; ++k )
+                    target_values( i, k ) = 0.;
+                for ( int j = row_ptrs( i ); j < row_ptrs( i + 1 ); ++j )
+                {
+                    double const value = values( j );
+                    int const column = columns( j );
+                    for ( int k = 0; k < n_fields; ++k )
+                        target_values( i, k ) += value * x( column, k );
+                }
+            } );
+    }
+
+  private:
+    Details::CommunicationPlan<DeviceType> _plan;
+    Kokkos::View<int const *, DeviceType> _row_ptrs;
+    Kokkos::View<int const *, DeviceType> _columns;
+    Kokkos::View<double const *, DeviceType> _values;
+};
+
+} // end namespace DataTransferKit
+
+#endif
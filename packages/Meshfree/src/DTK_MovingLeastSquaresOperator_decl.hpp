@@ -13,8 +13,13 @@
 #define DTK_MOVING_LEAST_SQUARES_OPERATOR_DECL_HPP
 
 #include <DTK_CompactlySupportedRadialBasisFunctions.hpp>
+#include <DTK_DetailsCommunicationPlan.hpp>
 #include <DTK_MultivariatePolynomialBasis.hpp>
 #include <DTK_PointCloudOperator.hpp>
+#include <DTK_PointCloudSearchTree.hpp>
+
+#include <string>
+#include <type_traits>
 
 #include <mpi.h>
 
@@ -31,35 +36,194 @@ namespace DataTransferKit
  * The class is templated on the DeviceType, the radial basis function
  * (Wendland<0>, Wendland<2>, Wendland<4>, Wendland<6>, Wu<2>, Wu<4>,
  * Buhmann<2>, Buhmann<3>, or Buhmann<4>) and polynonial basis (<Constant, DIM>,
- * <Linear, DIM>, or <Quadratic, DIM>).
+ * <Linear, DIM>, <Quadratic, DIM>, <Cubic, DIM>, or <Degree<N>, DIM>). The
+ * points live in dimension DIM, which is 1, 2, or 3.
+ *
+ * The last template parameter is the type in which the coefficients are
+ * stored and in which the source values are exchanged between the processors
+ * (double or float). The coefficients are always computed and the target
+ * values always accumulated in double precision. With float, the memory
+ * footprint of the operator and the traffic of apply() are halved at the cost
+ * of a relative error of about 1e-7 on the target values.
+ *
+ * Internally, the target points are processed along a Z-order curve rather
+ * than in the order given by the user so that nearby targets, which share
+ * most of their neighbors, are handled together. The target values are
+ * returned in the order of the user.
  */
 template <typename DeviceType,
           typename CompactlySupportedRadialBasisFunction = Wendland<0>,
-          typename PolynomialBasis = MultivariatePolynomialBasis<Linear, 3>>
+          typename PolynomialBasis = MultivariatePolynomialBasis<Linear, 3>,
+          typename Scalar = double>
 class MovingLeastSquaresOperator : public PointCloudOperator<DeviceType>
 {
+    static_assert( std::is_same<Scalar, double>::value ||
+                       std::is_same<Scalar, float>::value,
+                   "The coefficients must be stored as double or float" );
+
   public:
     using device_type = DeviceType;
     using ExecutionSpace = typename DeviceType::execution_space;
     using polynomial_basis = PolynomialBasis;
     using radial_basis_function = CompactlySupportedRadialBasisFunction;
+    using ApplyHandle = typename PointCloudOperator<DeviceType>::ApplyHandle;
 
     MovingLeastSquaresOperator(
         MPI_Comm comm,
         Kokkos::View<Coordinate const **, DeviceType> source_points,
         Kokkos::View<Coordinate const **, DeviceType> target_points );
 
+    /**
+     * Same as above but reuse a search tree that was built over the source
+     * points.
+     */
+    MovingLeastSquaresOperator(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points );
+
+    /**
+     * Same as above but the neighbors of a target point are all the source
+     * points within @param support_radius of it instead of its
+     * PolynomialBasis::size closest source points, and the radial basis
+     * function has the same support for all the target points. If the
+     * support radius is not positive, it is estimated from the density of the
+     * source points. Spatial searches are cheaper than nearest neighbor
+     * searches on quasi-uniform point clouds, but a target point whose ball
+     * contains too few source points yields an underdetermined system.
+     */
+    MovingLeastSquaresOperator(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        double support_radius );
+
+    /**
+     * Load an operator that was saved with save(). No search and no local
+     * least squares problem are solved, only the communication pattern is
+     * rebuilt. The source points, the target points, and the number of
+     * processors must be the same as when the operator was saved, otherwise
+     * all the processors throw. This function is collective.
+     */
+    MovingLeastSquaresOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        std::string const &prefix );
+
     void
     apply( Kokkos::View<double const *, DeviceType> source_values,
            Kokkos::View<double *, DeviceType> target_values ) const override;
 
+    void
+    apply( Kokkos::View<double const **, DeviceType> source_values,
+           Kokkos::View<double **, DeviceType> target_values ) const override;
+
+    /**
+     * Only the values of the neighbors of the selected targets are exchanged,
+     * using the communication plan of apply(). Nothing is searched or
+     * recomputed.
+     */
+    void applySubset(
+        Kokkos::View<double const *, DeviceType> source_values,
+        Kokkos::View<int const *, DeviceType> target_indices,
+        Kokkos::View<double *, DeviceType> target_values ) const override;
+
+    void applySubset(
+        Kokkos::View<double const **, DeviceType> source_values,
+        Kokkos::View<int const *, DeviceType> target_indices,
+        Kokkos::View<double **, DeviceType> target_values ) const override;
+
+    ApplyHandle applyBegin(
+        Kokkos::View<double const *, DeviceType> source_values ) const override;
+
+    void applyEnd( ApplyHandle &handle,
+                   Kokkos::View<double *, DeviceType> target_values )
+        const override;
+
+    ApplyHandle applyBegin(
+        Kokkos::View<double const **, DeviceType> source_values )
+        const override;
+
+    void applyEnd( ApplyHandle &handle,
+                   Kokkos::View<double **, DeviceType> target_values )
+        const override;
+
+    /**
+     * Each target value is multiplied by the coefficients of the neighbors of
+     * its target point and sent back to them. The neighbor lists and the
+     * coefficients are the ones used by apply(), nothing is recomputed. The
+     * values are exchanged in double precision whatever the type of the
+     * coefficients.
+     */
+    void applyTranspose(
+        Kokkos::View<double const *, DeviceType> target_values,
+        Kokkos::View<double *, DeviceType> source_values ) const override;
+
+    void applyTranspose(
+        Kokkos::View<double const **, DeviceType> target_values,
+        Kokkos::View<double **, DeviceType> source_values ) const override;
+
+    /**
+     * The i-th row holds the coefficients of the neighbors of the i-th target
+     * point. The matrix is not modified by update().
+     */
+    DistributedCrsMatrix<DeviceType> getCrsMatrix() const override;
+
+    /**
+     * Update the operator after the target points moved. The number of target
+     * points must not change. The neighbors of a target point are searched
+     * again only if it moved farther than @param tolerance or if one of its
+     * neighbors would fall out of the support of the radial basis function.
+     * Otherwise, its neighbors are kept and only its coefficients are
+     * recomputed. With a fixed support radius, every target point that moved
+     * is searched again since other source points may have entered its ball.
+     * Nothing is recomputed for the target points that did not move. This
+     * function is collective.
+     *
+     * The source points that were used to build the operator must not have
+     * been modified. The targets keep the position along the Z-order curve
+     * they were given at construction, so an update() that moves the targets
+     * far from their initial positions degrades the locality of apply().
+     */
+    void update( Kokkos::View<Coordinate const **, DeviceType> target_points,
+                 double tolerance );
+
+    /**
+     * Write the neighbor lists and the coefficients of the operator to binary
+     * files, one per processor, named `<prefix>.<rank>` where `<prefix>` is
+     * @param prefix and `<rank>` the rank of the processor, e.g. `mls.0`. The
+     * files can be loaded with the constructor above to skip the setup on
+     * restart.
+     */
+    void save( std::string const &prefix ) const;
+
   private:
+    void setup( Kokkos::View<Coordinate const **, DeviceType> target_points );
+
+    // Body of the rank-1 and rank-2 versions of applySubset().
+    template <typename SourceView, typename TargetView>
+    void applySubsetImpl( SourceView source_values,
+                          Kokkos::View<int const *, DeviceType> target_indices,
+                          TargetView target_values ) const;
+
     MPI_Comm _comm;
     unsigned int const _n_source_points;
+    PointCloudSearchTree<DeviceType> _search_tree;
+    // Zero for the nearest neighbor search.
+    double _support_radius;
+    // The i-th target point in Z-order is the target _permutation(i) of the
+    // user. All the views below follow the Z-order.
+    Kokkos::View<int *, DeviceType> _permutation;
+    // Position along the Z-order of the i-th target of the user.
+    Kokkos::View<int *, DeviceType> _inverse_permutation;
+    // Coordinates of the target points and of their neighbors. They are only
+    // used by update().
+    Kokkos::View<Coordinate **, DeviceType> _target_points;
+    Kokkos::View<Coordinate **, DeviceType> _source_points;
     Kokkos::View<int *, DeviceType> _offset;
     Kokkos::View<int *, DeviceType> _ranks;
     Kokkos::View<int *, DeviceType> _indices;
-    Kokkos::View<double *, DeviceType> _coeffs;
+    Kokkos::View<Scalar *, DeviceType> _coeffs;
+    Details::CommunicationPlan<DeviceType> _plan;
 };
 
 } // end namespace DataTransferKit
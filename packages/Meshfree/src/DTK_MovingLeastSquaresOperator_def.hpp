@@ -15,87 +15,231 @@
 #include <ArborX.hpp>
 #include <DTK_DBC.hpp>
 #include <DTK_DetailsMovingLeastSquaresOperatorImpl.hpp>
-#include <DTK_DetailsNearestNeighborOperatorImpl.hpp> // fetch
+#include <DTK_DetailsOperatorArchiveImpl.hpp>
+#include <DTK_DetailsOperatorUpdateImpl.hpp>
+#include <DTK_DetailsSpaceFillingCurveImpl.hpp>
+#include <DTK_DetailsTargetRedistribution.hpp>
+
+#include <tuple>
+#include <typeinfo>
 
 namespace DataTransferKit
 {
 
 template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
-          typename PolynomialBasis>
+          typename PolynomialBasis, typename Scalar>
 MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
-                           PolynomialBasis>::
+                           PolynomialBasis, Scalar>::
     MovingLeastSquaresOperator(
         MPI_Comm comm,
         Kokkos::View<Coordinate const **, DeviceType> source_points,
         Kokkos::View<Coordinate const **, DeviceType> target_points )
+    : MovingLeastSquaresOperator(
+          PointCloudSearchTree<DeviceType>( comm, source_points ),
+          target_points )
+{
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                           PolynomialBasis, Scalar>::
+    MovingLeastSquaresOperator(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points )
+    : _comm( search_tree.getComm() )
+    , _n_source_points( search_tree.getSourcePoints().extent( 0 ) )
+    , _search_tree( search_tree )
+    , _support_radius( 0. )
+    , _permutation( "permutation", 0 )
+    , _inverse_permutation( "inverse_permutation", 0 )
+    , _target_points( "target_points", 0, 0 )
+    , _source_points( "source_points", 0, 0 )
+    , _offset( "offset", 0 )
+    , _ranks( "ranks", 0 )
+    , _indices( "indices", 0 )
+    , _coeffs( "polynomial_coefficients", 0 )
+{
+    setup( target_points );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                           PolynomialBasis, Scalar>::
+    MovingLeastSquaresOperator(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        double support_radius )
+    : _comm( search_tree.getComm() )
+    , _n_source_points( search_tree.getSourcePoints().extent( 0 ) )
+    , _search_tree( search_tree )
+    , _support_radius(
+          support_radius > 0.
+              ? support_radius
+              : search_tree.estimateSupportRadius( PolynomialBasis::size ) )
+    , _permutation( "permutation", 0 )
+    , _inverse_permutation( "inverse_permutation", 0 )
+    , _target_points( "target_points", 0, 0 )
+    , _source_points( "source_points", 0, 0 )
+    , _offset( "offset", 0 )
+    , _ranks( "ranks", 0 )
+    , _indices( "indices", 0 )
+    , _coeffs( "polynomial_coefficients", 0 )
+{
+    setup( target_points );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                           PolynomialBasis, Scalar>::
+    MovingLeastSquaresOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        std::string const &prefix )
     : _comm( comm )
     , _n_source_points( source_points.extent( 0 ) )
+    , _search_tree( comm, source_points )
+    , _support_radius( 0. )
+    , _permutation( "permutation", 0 )
+    , _inverse_permutation( "inverse_permutation", 0 )
+    , _target_points( "target_points", 0, 0 )
+    , _source_points( "source_points", 0, 0 )
     , _offset( "offset", 0 )
     , _ranks( "ranks", 0 )
     , _indices( "indices", 0 )
     , _coeffs( "polynomial_coefficients", 0 )
 {
+    using ArchiveImpl = Details::OperatorArchiveImpl<DeviceType>;
+
+    auto stream = ArchiveImpl::openForReading(
+        _comm, prefix,
+        ArchiveImpl::makeHeader( _comm,
+                                 typeid( MovingLeastSquaresOperator ).name(),
+                                 source_points, target_points ) );
+    ArchiveImpl::readValue( stream, _support_radius );
+    ArchiveImpl::read( stream, _source_points );
+    ArchiveImpl::read( stream, _offset );
+    ArchiveImpl::read( stream, _ranks );
+    ArchiveImpl::read( stream, _indices );
+    ArchiveImpl::read( stream, _coeffs );
+    ArchiveImpl::read( stream, _permutation );
+    ArchiveImpl::checkRead( _comm, stream );
+    DTK_CHECK( _offset.extent( 0 ) == target_points.extent( 0 ) + 1 );
+    DTK_CHECK( _permutation.extent( 0 ) == target_points.extent( 0 ) );
+
+    _inverse_permutation =
+        Details::SpaceFillingCurveImpl<DeviceType>::invertPermutation(
+            _permutation );
+    _target_points = Details::OperatorUpdateImpl<DeviceType>::gatherRows(
+        target_points, _permutation );
+
+    // NOTE: This is the last collective.
+    _plan = Details::CommunicationPlan<DeviceType>( _comm, _ranks, _indices );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    save( std::string const &prefix ) const
+{
+    using ArchiveImpl = Details::OperatorArchiveImpl<DeviceType>;
+
+    // The header identifies the target points in the order of the user.
+    Kokkos::View<Coordinate **, DeviceType> target_points(
+        "target_points", _target_points.extent( 0 ),
+        _target_points.extent( 1 ) );
+    Details::OperatorUpdateImpl<DeviceType>::scatterRows(
+        _target_points, _permutation, target_points );
+
+    auto stream = ArchiveImpl::openForWriting(
+        _comm, prefix,
+        ArchiveImpl::makeHeader( _comm,
+                                 typeid( MovingLeastSquaresOperator ).name(),
+                                 _search_tree.getSourcePoints(),
+                                 target_points ) );
+    ArchiveImpl::writeValue( stream, _support_radius );
+    ArchiveImpl::write( stream, _source_points );
+    ArchiveImpl::write( stream, _offset );
+    ArchiveImpl::write( stream, _ranks );
+    ArchiveImpl::write( stream, _indices );
+    ArchiveImpl::write( stream, _coeffs );
+    ArchiveImpl::write( stream, _permutation );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    setup( Kokkos::View<Coordinate const **, DeviceType> target_points )
+{
+    auto source_points = _search_tree.getSourcePoints();
     DTK_REQUIRE( source_points.extent_int( 1 ) ==
                  target_points.extent_int( 1 ) );
-    // FIXME for now let's assume 3D
-    DTK_REQUIRE( source_points.extent_int( 1 ) == 3 );
+    DTK_REQUIRE( source_points.extent_int( 1 ) ==
+                 PolynomialBasis::dimension );
 
-    // Build distributed search tree over the source points.
-    ArborX::DistributedSearchTree<DeviceType> search_tree( _comm,
-                                                           source_points );
-    DTK_CHECK( !search_tree.empty() );
+    // Sort the target points along the Z-order curve so that the search, the
+    // retrieval of the coordinates of the neighbors and the computation of
+    // the coefficients process nearby targets together. The copy is also used
+    // by update() to tell which targets moved.
+    _permutation =
+        Details::SpaceFillingCurveImpl<DeviceType>::sortAlongZOrder(
+            target_points );
+    _inverse_permutation =
+        Details::SpaceFillingCurveImpl<DeviceType>::invertPermutation(
+            _permutation );
+    _target_points = Details::OperatorUpdateImpl<DeviceType>::gatherRows(
+        target_points, _permutation );
+
+    // The targets are optionally set up on other processors to balance the
+    // work, and the results are sent back.
+    Details::TargetRedistribution<DeviceType> redistribution(
+        _comm, _target_points, _search_tree.balancesTargets() );
+    auto local_target_points = redistribution.getTargetPoints();
 
     // For each target point, query the n_neighbors points closest to the
-    // target.
-    auto queries =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::makeKNNQueries(
-            target_points, PolynomialBasis::size );
+    // target or the points within the support radius.
+    Kokkos::View<int *, DeviceType> indices( "indices", 0 );
+    Kokkos::View<int *, DeviceType> offset( "offset", 0 );
+    Kokkos::View<int *, DeviceType> ranks( "ranks", 0 );
+    Details::MovingLeastSquaresOperatorImpl<DeviceType>::findNeighbors(
+        _search_tree, local_target_points, PolynomialBasis::size,
+        _support_radius, indices, offset, ranks );
 
-    // Perform the actual search.
-    search_tree.query( queries, _indices, _offset, _ranks );
+    // Build the communication pattern once. It is used right below to
+    // retrieve the coordinates of all source points that met the predicates
+    // and then on every call to apply().
+    // NOTE: This is the last collective unless the targets were
+    // redistributed.
+    _plan = Details::CommunicationPlan<DeviceType>( _comm, ranks, indices );
+    auto source_points_with_halo = _plan.fetch( source_points );
 
-    // Retrieve the coordinates of all source points that met the predicates.
-    // NOTE: This is the last collective.
-    source_points = Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
-        _comm, _ranks, _indices, source_points );
-
-    // Transform source points
-    source_points = Details::MovingLeastSquaresOperatorImpl<
-        DeviceType>::transformSourceCoordinates( source_points, _offset,
-                                                 target_points );
-    target_points = Kokkos::View<Coordinate **, DeviceType>( "empty", 0, 0 );
-
-    // Build P (vandermonde matrix)
-    // P is a single 1D storage for multiple P_i matrices. Each matrix is of
-    // size (#source_points_for_specific_target_point, basis_size)
-    auto p =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeVandermonde(
-            source_points, PolynomialBasis() );
-
-    // To build the radial basis function, we need to define the radius of the
-    // radial basis function. Since we use kNN, we need to compute the radius.
-    // We only need the coordinates of the source points because of the
-    // transformation of the coordinates.
-    auto radius =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeRadius(
-            source_points, _offset );
-
-    // Build phi (weight matrix)
-    auto phi =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeWeights(
-            source_points, radius, CompactlySupportedRadialBasisFunction() );
-
-    // Build A (moment matrix)
-    auto a =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeMoments(
-            _offset, p, phi );
-
-    // TODO: it is computationally unnecessary to compute the pseudo-inverse as
-    // MxM (U*E^+*V) as it will later be just used to do MxV. We could instead
-    // return the (U,E^+,V) and do the MxV multiplication. But for now, it's OK.
-    auto t = Details::MovingLeastSquaresOperatorImpl<DeviceType>::invertMoments(
-        a, PolynomialBasis::size );
-    auto inv_a = std::get<0>( t );
+    auto t = Details::MovingLeastSquaresOperatorImpl<DeviceType>::
+        computeCoefficients( offset, source_points_with_halo,
+                             local_target_points, _support_radius,
+                             CompactlySupportedRadialBasisFunction(),
+                             PolynomialBasis() );
+    auto coeffs = std::get<0>( t );
+
+    _offset = redistribution.sendListsBack( offset );
+    _indices = redistribution.sendValuesBack( indices );
+    _ranks = redistribution.sendValuesBack( ranks );
+    _source_points = redistribution.sendValuesBack( source_points_with_halo );
+    coeffs = redistribution.sendValuesBack( coeffs );
+    if ( _search_tree.balancesTargets() )
+        _plan =
+            Details::CommunicationPlan<DeviceType>( _comm, _ranks, _indices );
+
+    // The coefficients are computed in double precision and only stored in
+    // the precision of the operator.
+    _coeffs = Details::MovingLeastSquaresOperatorImpl<
+        DeviceType>::template convertValues<Scalar>( coeffs );
 
     // std::get<1>(t) returns the number of undetermined system. However, this
     // is not enough to know if we will lose order of accuracy. For example, if
@@ -103,18 +247,87 @@ MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
     // this is not a problem if we found at least three points since this is
     // enough to define a quadratic function. Therefore, not only we need to
     // know the rank deficiency but also the dimension of the problem.
+}
 
-    // NOTE: This assumes that the polynomial basis evaluated at {0,0,0} is
-    // going to be [1, 0, 0, ..., 0]^T.
-    _coeffs = Details::MovingLeastSquaresOperatorImpl<
-        DeviceType>::computePolynomialCoefficients( _offset, inv_a, p, phi,
-                                                    PolynomialBasis::size );
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    update( Kokkos::View<Coordinate const **, DeviceType> target_points,
+            double tolerance )
+{
+    DTK_REQUIRE( target_points.extent( 0 ) == _target_points.extent( 0 ) );
+    DTK_REQUIRE( target_points.extent( 1 ) == _target_points.extent( 1 ) );
+    DTK_REQUIRE( tolerance >= 0. );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    using UpdateImpl = Details::OperatorUpdateImpl<DeviceType>;
+
+    // The targets keep their position along the Z-order curve.
+    auto sorted_target_points =
+        UpdateImpl::gatherRows( target_points, _permutation );
+
+    auto status = Impl::classifyMovedTargets(
+        _offset, _source_points, _target_points, sorted_target_points,
+        tolerance, _support_radius );
+    auto moved_targets = UpdateImpl::selectTargets( status, 1 );
+    auto requeried_targets = UpdateImpl::selectTargets( status, 2 );
+
+    // Search again the neighbors of the targets that need it and retrieve
+    // their coordinates. These operations are collective so they are
+    // performed even if there is no such target on this processor.
+    Kokkos::View<int *, DeviceType> new_indices( "indices", 0 );
+    Kokkos::View<int *, DeviceType> new_offset( "offset", 0 );
+    Kokkos::View<int *, DeviceType> new_ranks( "ranks", 0 );
+    Impl::findNeighbors( _search_tree,
+                         UpdateImpl::gatherRows( sorted_target_points,
+                                                 requeried_targets ),
+                         PolynomialBasis::size, _support_radius, new_indices,
+                         new_offset, new_ranks );
+    auto new_source_points =
+        Details::CommunicationPlan<DeviceType>( _comm, new_ranks, new_indices )
+            .fetch( _search_tree.getSourcePoints() );
+
+    // Replace the neighbor lists of these targets. The coefficients of the
+    // new neighbors are computed below.
+    Kokkos::View<int *, DeviceType> offset;
+    Kokkos::View<int *, DeviceType> origin;
+    std::tie( offset, origin ) =
+        UpdateImpl::mergeLists( _offset, requeried_targets, new_offset );
+    _offset = offset;
+    _indices = UpdateImpl::mergeValues( origin, _indices, new_indices );
+    _ranks = UpdateImpl::mergeValues( origin, _ranks, new_ranks );
+    _source_points =
+        UpdateImpl::mergeValues( origin, _source_points, new_source_points );
+    _coeffs = UpdateImpl::mergeValues(
+        origin, _coeffs,
+        Kokkos::View<Scalar *, DeviceType>( "polynomial_coefficients",
+                                            new_indices.extent( 0 ) ) );
+
+    // Recompute the coefficients of the targets that moved only.
+    Kokkos::View<int *, DeviceType> moved_offset;
+    Kokkos::View<int *, DeviceType> moved_entries;
+    std::tie( moved_offset, moved_entries ) =
+        UpdateImpl::extractLists( _offset, moved_targets );
+    auto t = Impl::computeCoefficients(
+        moved_offset, UpdateImpl::gatherRows( _source_points, moved_entries ),
+        UpdateImpl::gatherRows( sorted_target_points, moved_targets ),
+        _support_radius,
+        CompactlySupportedRadialBasisFunction(), PolynomialBasis() );
+    UpdateImpl::scatterRows( std::get<0>( t ), moved_entries, _coeffs );
+
+    _target_points = sorted_target_points;
+
+    // NOTE: This is the last collective.
+    _plan = Details::CommunicationPlan<DeviceType>( _comm, _ranks, _indices );
 }
 
 template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
-          typename PolynomialBasis>
-void MovingLeastSquaresOperator<
-    DeviceType, CompactlySupportedRadialBasisFunction, PolynomialBasis>::
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
     apply( Kokkos::View<double const *, DeviceType> source_values,
            Kokkos::View<double *, DeviceType> target_values ) const
 {
@@ -122,15 +335,273 @@ void MovingLeastSquaresOperator<
     DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
     DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
 
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+
     // Retrieve values for all source points
-    source_values = Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
-        _comm, _ranks, _indices, source_values );
+    auto values =
+        _plan.fetch( Impl::template convertValues<Scalar>( source_values ) );
 
     // Apply A-1 (P^T phi)
-    auto new_target_values = Details::MovingLeastSquaresOperatorImpl<
-        DeviceType>::computeTargetValues( _offset, _coeffs, source_values );
+    auto new_target_values =
+        Impl::template computeTargetValues<Scalar, Scalar>( _offset, _coeffs,
+                                                            values );
 
-    Kokkos::deep_copy( target_values, new_target_values );
+    // Return the target values in the order of the user
+    Details::OperatorUpdateImpl<DeviceType>::scatterRows(
+        new_target_values, _permutation, target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    apply( Kokkos::View<double const **, DeviceType> source_values,
+           Kokkos::View<double **, DeviceType> target_values ) const
+{
+    // Precondition: check that the source and the target are properly sized
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+
+    // Retrieve values of all the fields for all source points
+    auto values =
+        _plan.fetch( Impl::template convertValues<Scalar>( source_values ) );
+
+    // Apply A-1 (P^T phi)
+    auto new_target_values =
+        Impl::template computeTargetValues<Scalar, Scalar>( _offset, _coeffs,
+                                                            values );
+
+    // Return the target values in the order of the user
+    Details::OperatorUpdateImpl<DeviceType>::scatterRows(
+        new_target_values, _permutation, target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    applySubset( Kokkos::View<double const *, DeviceType> source_values,
+                 Kokkos::View<int const *, DeviceType> target_indices,
+                 Kokkos::View<double *, DeviceType> target_values ) const
+{
+    applySubsetImpl( source_values, target_indices, target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    applySubset( Kokkos::View<double const **, DeviceType> source_values,
+                 Kokkos::View<int const *, DeviceType> target_indices,
+                 Kokkos::View<double **, DeviceType> target_values ) const
+{
+    applySubsetImpl( source_values, target_indices, target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+template <typename SourceView, typename TargetView>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    applySubsetImpl( SourceView source_values,
+                     Kokkos::View<int const *, DeviceType> target_indices,
+                     TargetView target_values ) const
+{
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    using UpdateImpl = Details::OperatorUpdateImpl<DeviceType>;
+
+    // Neighbor lists of the selected targets, which are stored in Z-order.
+    // Their entries are also requests of the communication plan.
+    Kokkos::View<int *, DeviceType> offset;
+    Kokkos::View<int *, DeviceType> entries;
+    std::tie( offset, entries ) = UpdateImpl::extractLists(
+        _offset, UpdateImpl::gatherRows( _inverse_permutation,
+                                         target_indices ) );
+
+    // Retrieve the values of their neighbors only
+    auto values = _plan.fetchSubset(
+        Impl::template convertValues<Scalar>( source_values ), entries );
+
+    // Apply A-1 (P^T phi)
+    auto new_target_values = Impl::template computeTargetValues<Scalar, Scalar>(
+        offset, UpdateImpl::gatherRows( _coeffs, entries ), values );
+
+    UpdateImpl::scatterRows( new_target_values, target_indices,
+                             target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+typename MovingLeastSquaresOperator<DeviceType,
+                                   CompactlySupportedRadialBasisFunction,
+                                   PolynomialBasis, Scalar>::ApplyHandle
+MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                           PolynomialBasis, Scalar>::
+    applyBegin( Kokkos::View<double const *, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+
+    ApplyHandle handle;
+    handle.setState( _plan.fetchBegin(
+        Impl::template convertValues<Scalar>( source_values ) ) );
+    return handle;
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    applyEnd( ApplyHandle &handle,
+              Kokkos::View<double *, DeviceType> target_values ) const
+{
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+
+    Kokkos::View<Scalar *, DeviceType> values( "source_values",
+                                               _plan.getNumberOfRequests() );
+    _plan.fetchEnd(
+        handle.template getState<Details::PendingFetch<Scalar>>(), values );
+    handle.clear();
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    auto new_target_values =
+        Impl::template computeTargetValues<Scalar, Scalar>( _offset, _coeffs,
+                                                            values );
+
+    // Return the target values in the order of the user
+    Details::OperatorUpdateImpl<DeviceType>::scatterRows(
+        new_target_values, _permutation, target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+typename MovingLeastSquaresOperator<DeviceType,
+                                   CompactlySupportedRadialBasisFunction,
+                                   PolynomialBasis, Scalar>::ApplyHandle
+MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                           PolynomialBasis, Scalar>::
+    applyBegin( Kokkos::View<double const **, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+
+    ApplyHandle handle;
+    handle.setState( _plan.fetchBegin(
+        Impl::template convertValues<Scalar>( source_values ) ) );
+    return handle;
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    applyEnd( ApplyHandle &handle,
+              Kokkos::View<double **, DeviceType> target_values ) const
+{
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+
+    Kokkos::View<Scalar **, DeviceType> values( "source_values",
+                                                _plan.getNumberOfRequests(),
+                                                target_values.extent( 1 ) );
+    _plan.fetchEnd(
+        handle.template getState<Details::PendingFetch<Scalar>>(), values );
+    handle.clear();
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    auto new_target_values =
+        Impl::template computeTargetValues<Scalar, Scalar>( _offset, _coeffs,
+                                                            values );
+
+    // Return the target values in the order of the user
+    Details::OperatorUpdateImpl<DeviceType>::scatterRows(
+        new_target_values, _permutation, target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    applyTranspose( Kokkos::View<double const *, DeviceType> target_values,
+                    Kokkos::View<double *, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+
+    // Apply (A-1 (P^T phi))^T to the target values in Z-order
+    Kokkos::View<double const *, DeviceType> sorted_target_values =
+        Details::OperatorUpdateImpl<DeviceType>::gatherRows( target_values,
+                                                             _permutation );
+    auto contributions = Impl::template computeSourceContributions<Scalar>(
+        _offset, _coeffs, sorted_target_values );
+
+    // Sum the contributions on the processors that own the source points
+    Kokkos::deep_copy( source_values, 0. );
+    _plan.push( contributions, source_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+void MovingLeastSquaresOperator<DeviceType,
+                                CompactlySupportedRadialBasisFunction,
+                                PolynomialBasis, Scalar>::
+    applyTranspose( Kokkos::View<double const **, DeviceType> target_values,
+                    Kokkos::View<double **, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+
+    Kokkos::View<double const **, DeviceType> sorted_target_values =
+        Details::OperatorUpdateImpl<DeviceType>::gatherRows( target_values,
+                                                             _permutation );
+    auto contributions = Impl::template computeSourceContributions<Scalar>(
+        _offset, _coeffs, sorted_target_values );
+
+    Kokkos::deep_copy( source_values, 0. );
+    _plan.push( contributions, source_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis, typename Scalar>
+DistributedCrsMatrix<DeviceType>
+MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                           PolynomialBasis, Scalar>::getCrsMatrix() const
+{
+    using UpdateImpl = Details::OperatorUpdateImpl<DeviceType>;
+
+    // The rows of the matrix follow the order of the user.
+    Kokkos::View<int *, DeviceType> row_ptrs;
+    Kokkos::View<int *, DeviceType> entries;
+    std::tie( row_ptrs, entries ) =
+        UpdateImpl::extractLists( _offset, _inverse_permutation );
+
+    return DistributedCrsMatrix<DeviceType>(
+        _plan, row_ptrs,
+        UpdateImpl::gatherRows( _plan.getImportPositions(), entries ),
+        UpdateImpl::gatherRows(
+            Details::MovingLeastSquaresOperatorImpl<
+                DeviceType>::template convertValues<double>( _coeffs ),
+            entries ) );
 }
 
 } // end namespace DataTransferKit
@@ -140,6 +611,12 @@ void MovingLeastSquaresOperator<
     template class MovingLeastSquaresOperator<typename NODE::device_type>;     \
     template class MovingLeastSquaresOperator<                                 \
         typename NODE::device_type, Wendland<0>,                               \
-        MultivariatePolynomialBasis<Quadratic, 3>>;
+        MultivariatePolynomialBasis<Quadratic, 3>>;                            \
+    template class MovingLeastSquaresOperator<                                 \
+        typename NODE::device_type, Wendland<0>,                               \
+        MultivariatePolynomialBasis<Linear, 2>>;                               \
+    template class MovingLeastSquaresOperator<                                 \
+        typename NODE::device_type, Wendland<0>,                               \
+        MultivariatePolynomialBasis<Linear, 3>, float>;
 
 #endif
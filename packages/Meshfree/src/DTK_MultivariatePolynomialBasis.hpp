@@ -36,121 +36,172 @@ struct Quadratic
 {
 };
 
-namespace Details
+struct Cubic
 {
+};
 
-template <typename Basis, int DIM>
-struct Size
+// Polynomials of degree at most N. Degree<0> to Degree<3> are the same bases
+// as Constant to Cubic.
+template <int N>
+struct Degree
 {
+    static_assert( N >= 0, "The degree must be nonnegative" );
 };
 
-template <int DIM>
-struct Size<Constant, DIM>
+namespace Details
+{
+
+template <typename Basis>
+struct PolynomialDegree
 {
-    static int constexpr value = 1;
 };
 
 template <>
-struct Size<Linear, 3>
+struct PolynomialDegree<Constant>
 {
-    static int constexpr value = 4;
+    static int constexpr value = 0;
 };
 
 template <>
-struct Size<Quadratic, 3>
+struct PolynomialDegree<Linear>
 {
-    static int constexpr value = 10;
+    static int constexpr value = 1;
 };
 
 template <>
-struct Size<Linear, 2>
+struct PolynomialDegree<Quadratic>
 {
-    static int constexpr value = 3;
+    static int constexpr value = 2;
 };
 
 template <>
-struct Size<Quadratic, 2>
+struct PolynomialDegree<Cubic>
 {
-    static int constexpr value = 6;
+    static int constexpr value = 3;
 };
 
-} // namespace Details
-
-template <typename Basis, int DIM>
-struct MultivariatePolynomialBasis
+template <int N>
+struct PolynomialDegree<Degree<N>>
 {
-    static int constexpr size = Details::Size<Basis, DIM>::value;
-
-    template <typename Point>
-    KOKKOS_INLINE_FUNCTION Kokkos::Array<double, size>
-    operator()( Point const &p ) const;
+    static int constexpr value = N;
 };
 
-// Definition below is required (until C++17) to avoid link-time errors
-// c.f. https://en.cppreference.com/w/cpp/language/definition#ODR-use
-template <typename Basis, int DIM>
-int constexpr MultivariatePolynomialBasis<Basis, DIM>::size;
-
-// NOTE: For now relying on Point::operator[]( int i ) to access the coordinates
-// which make it possible to use various types such as DTK::Point or
-// Kokkos::Array<double, DIM>
-
-template <>
-template <typename Point>
-KOKKOS_INLINE_FUNCTION
-    Kokkos::Array<double, MultivariatePolynomialBasis<Constant, 3>::size>
-    MultivariatePolynomialBasis<Constant, 3>::operator()( Point const & ) const
+// Number of monomials of degree at most @param degree in @param dim
+// variables, i.e. the binomial coefficient (degree + dim, dim).
+KOKKOS_INLINE_FUNCTION constexpr int numberOfMonomials( int degree, int dim )
 {
-    return {{1.}};
+    int n = 1;
+    for ( int k = 1; k <= dim; ++k )
+        n = n * ( degree + k ) / k;
+    return n;
 }
 
-template <>
-template <typename Point>
-KOKKOS_INLINE_FUNCTION
-    Kokkos::Array<double, MultivariatePolynomialBasis<Linear, 3>::size>
-    MultivariatePolynomialBasis<Linear, 3>::operator()( Point const &p ) const
+// The monomials are sorted by degree and, within a degree, in lexicographic
+// order of their variables, e.g. 1, X, Y, X^2, XY, Y^2 in 2D. Every monomial
+// but the first one is the product of a monomial that comes before it, its
+// parent, and of one variable.
+template <int N>
+struct MonomialTable
 {
-    return {{1., p[0], p[1], p[2]}};
+    int parent[N];
+    int variable[N];
+};
+
+template <int DEGREE, int DIM>
+KOKKOS_INLINE_FUNCTION constexpr MonomialTable<
+    numberOfMonomials( DEGREE, DIM )>
+makeMonomialTable()
+{
+    MonomialTable<numberOfMonomials( DEGREE, DIM )> table{};
+    // Last variable of each monomial. The monomials of the next degree are
+    // obtained by multiplying by this variable or by the ones after it.
+    int last[numberOfMonomials( DEGREE, DIM )] = {};
+    int n = 1;
+    int begin = 0;
+    for ( int degree = 1; degree <= DEGREE; ++degree )
+    {
+        int const end = n;
+        for ( int m = begin; m < end; ++m )
+            for ( int v = last[m]; v < DIM; ++v )
+            {
+                table.parent[n] = m;
+                table.variable[n] = v;
+                last[n] = v;
+                ++n;
+            }
+        begin = end;
+    }
+    return table;
 }
 
-template <>
-template <typename Point>
-KOKKOS_INLINE_FUNCTION
-    Kokkos::Array<double, MultivariatePolynomialBasis<Quadratic, 3>::size>
-    MultivariatePolynomialBasis<Quadratic, 3>::
-    operator()( Point const &p ) const
+// Evaluate the monomials K and after. The table is only used in constant
+// expressions so that the loop is fully unrolled with the indices known at
+// compile time.
+template <int DEGREE, int DIM, int K,
+          int N = numberOfMonomials( DEGREE, DIM )>
+struct MonomialEvaluation
 {
-    return {{1., p[0], p[1], p[2], p[0] * p[0], p[0] * p[1], p[0] * p[2],
-             p[1] * p[1], p[1] * p[2], p[2] * p[2]}};
-}
+    template <typename Point>
+    KOKKOS_INLINE_FUNCTION static void apply( Kokkos::Array<double, N> &values,
+                                              Point const &p )
+    {
+        constexpr int parent = makeMonomialTable<DEGREE, DIM>().parent[K];
+        constexpr int variable = makeMonomialTable<DEGREE, DIM>().variable[K];
+        values[K] = values[parent] * p[variable];
+        MonomialEvaluation<DEGREE, DIM, K + 1, N>::apply( values, p );
+    }
+};
 
-template <>
-template <typename Point>
-KOKKOS_INLINE_FUNCTION
-    Kokkos::Array<double, MultivariatePolynomialBasis<Constant, 2>::size>
-    MultivariatePolynomialBasis<Constant, 2>::operator()( Point const & ) const
+template <int DEGREE, int DIM, int N>
+struct MonomialEvaluation<DEGREE, DIM, N, N>
 {
-    return {{1.}};
-}
+    template <typename Point>
+    KOKKOS_INLINE_FUNCTION static void apply( Kokkos::Array<double, N> &,
+                                              Point const & )
+    {
+    }
+};
 
-template <>
-template <typename Point>
-KOKKOS_INLINE_FUNCTION
-    Kokkos::Array<double, MultivariatePolynomialBasis<Linear, 2>::size>
-    MultivariatePolynomialBasis<Linear, 2>::operator()( Point const &p ) const
+} // namespace Details
+
+/**
+ * Basis of the polynomials of degree at most Basis (Constant, Linear,
+ * Quadratic, Cubic, or Degree<N> for any N) in DIM variables. The functions
+ * are the monomials, sorted by degree and, within a degree, in lexicographic
+ * order, e.g. [1, X, Y, X^2, XY, Y^2] for <Quadratic, 2>.
+ */
+template <typename Basis, int DIM>
+struct MultivariatePolynomialBasis
 {
-    return {{1., p[0], p[1]}};
-}
+    static_assert( DIM >= 1, "The dimension must be positive" );
 
-template <>
-template <typename Point>
-KOKKOS_INLINE_FUNCTION
-    Kokkos::Array<double, MultivariatePolynomialBasis<Quadratic, 2>::size>
-    MultivariatePolynomialBasis<Quadratic, 2>::
+    static int constexpr dimension = DIM;
+    static int constexpr size = Details::numberOfMonomials(
+        Details::PolynomialDegree<Basis>::value, DIM );
+
+    // NOTE: For now relying on Point::operator[]( int i ) to access the
+    // coordinates which make it possible to use various types such as
+    // ArborX::Point or Kokkos::Array<double, DIM>. Only the first DIM
+    // coordinates are used.
+    template <typename Point>
+    KOKKOS_INLINE_FUNCTION Kokkos::Array<double, size>
     operator()( Point const &p ) const
-{
-    return {{1., p[0], p[1], p[0] * p[0], p[0] * p[1], p[1] * p[1]}};
-}
+    {
+        Kokkos::Array<double, size> values;
+        values[0] = 1.;
+        Details::MonomialEvaluation<Details::PolynomialDegree<Basis>::value,
+                                    DIM, 1>::apply( values, p );
+        return values;
+    }
+};
+
+// Definition below is required (until C++17) to avoid link-time errors
+// c.f. https://en.cppreference.com/w/cpp/language/definition#ODR-use
+template <typename Basis, int DIM>
+int constexpr MultivariatePolynomialBasis<Basis, DIM>::dimension;
+
+template <typename Basis, int DIM>
+int constexpr MultivariatePolynomialBasis<Basis, DIM>::size;
 
 } // namespace DataTransferKit
 
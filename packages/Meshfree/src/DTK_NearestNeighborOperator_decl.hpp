@@ -12,7 +12,12 @@
 #ifndef DTK_NEAREST_NEIGHBOR_OPERATOR_DECL_HPP
 #define DTK_NEAREST_NEIGHBOR_OPERATOR_DECL_HPP
 
+#include <DTK_DetailsCommunicationPlan.hpp>
 #include <DTK_PointCloudOperator.hpp>
+#include <DTK_PointCloudSearchTree.hpp>
+
+#include <cstdint>
+#include <string>
 
 #include <mpi.h>
 
@@ -29,20 +34,128 @@ class NearestNeighborOperator : public PointCloudOperator<DeviceType>
     using ExecutionSpace = typename DeviceType::execution_space;
 
   public:
+    using device_type = DeviceType;
+    using ApplyHandle = typename PointCloudOperator<DeviceType>::ApplyHandle;
+
     NearestNeighborOperator(
         MPI_Comm comm,
         Kokkos::View<Coordinate const **, DeviceType> source_points,
         Kokkos::View<Coordinate const **, DeviceType> target_points );
 
+    /**
+     * Same as above but reuse a search tree that was built over the source
+     * points.
+     */
+    NearestNeighborOperator(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points );
+
+    /**
+     * Load an operator that was saved with save() instead of searching the
+     * nearest neighbors. The source points, the target points, and the number
+     * of processors must be the same as when the operator was saved,
+     * otherwise all the processors throw. After update(), the target points
+     * are the ones given to the last call to update(). This function is
+     * collective.
+     */
+    NearestNeighborOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        std::string const &prefix );
+
     void
     apply( Kokkos::View<double const *, DeviceType> source_values,
            Kokkos::View<double *, DeviceType> target_values ) const override;
 
+    void
+    apply( Kokkos::View<double const **, DeviceType> source_values,
+           Kokkos::View<double **, DeviceType> target_values ) const override;
+
+    /**
+     * Only the nearest neighbors of the selected targets are fetched, using
+     * the communication plan of apply().
+     */
+    void applySubset(
+        Kokkos::View<double const *, DeviceType> source_values,
+        Kokkos::View<int const *, DeviceType> target_indices,
+        Kokkos::View<double *, DeviceType> target_values ) const override;
+
+    void applySubset(
+        Kokkos::View<double const **, DeviceType> source_values,
+        Kokkos::View<int const *, DeviceType> target_indices,
+        Kokkos::View<double **, DeviceType> target_values ) const override;
+
+    ApplyHandle applyBegin(
+        Kokkos::View<double const *, DeviceType> source_values ) const override;
+
+    void applyEnd( ApplyHandle &handle,
+                   Kokkos::View<double *, DeviceType> target_values )
+        const override;
+
+    ApplyHandle applyBegin(
+        Kokkos::View<double const **, DeviceType> source_values )
+        const override;
+
+    void applyEnd( ApplyHandle &handle,
+                   Kokkos::View<double **, DeviceType> target_values )
+        const override;
+
+    /**
+     * The value at a source point is the sum of the values at the target
+     * points for which it is the nearest neighbor.
+     */
+    void applyTranspose(
+        Kokkos::View<double const *, DeviceType> target_values,
+        Kokkos::View<double *, DeviceType> source_values ) const override;
+
+    void applyTranspose(
+        Kokkos::View<double const **, DeviceType> target_values,
+        Kokkos::View<double **, DeviceType> source_values ) const override;
+
+    /**
+     * Each row has a single entry equal to one.
+     */
+    DistributedCrsMatrix<DeviceType> getCrsMatrix() const override;
+
+    /**
+     * Update the operator after the target points moved. The number of target
+     * points must not change. Only the target points that moved farther than
+     * @param tolerance are searched again, the other ones keep their source
+     * point. The source point of a target is thus at most 2 * tolerance
+     * farther than its actual nearest neighbor. This function is collective.
+     *
+     * The source points that were used to build the operator must not have
+     * been modified.
+     */
+    void update( Kokkos::View<Coordinate const **, DeviceType> target_points,
+                 double tolerance );
+
+    /**
+     * Write the nearest neighbors of the target points to binary files, one
+     * per processor, named `<prefix>.<rank>` where `<prefix>` is
+     * @param prefix and `<rank>` the rank of the processor, e.g. `nn.0`.
+     */
+    void save( std::string const &prefix ) const;
+
   private:
+    // Body of the rank-1 and rank-2 versions of applySubset().
+    template <typename SourceView, typename TargetView>
+    void applySubsetImpl( SourceView source_values,
+                          Kokkos::View<int const *, DeviceType> target_indices,
+                          TargetView target_values ) const;
+
     MPI_Comm _comm;
+    PointCloudSearchTree<DeviceType> _search_tree;
+    // Coordinates of the target points when the source points were found.
+    Kokkos::View<Coordinate **, DeviceType> _target_points;
+    // Hash of the target points given by the user at construction or to the
+    // last update(), which identifies them in the files written by save().
+    std::uint64_t _target_points_hash;
     Kokkos::View<int *, DeviceType> _indices;
     Kokkos::View<int *, DeviceType> _ranks;
     int const _size;
+    Details::CommunicationPlan<DeviceType> _plan;
 };
 
 } // namespace DataTransferKit
@@ -15,6 +15,13 @@
 #include <ArborX.hpp>
 #include <DTK_DBC.hpp>
 #include <DTK_DetailsNearestNeighborOperatorImpl.hpp>
+#include <DTK_DetailsOperatorArchiveImpl.hpp>
+#include <DTK_DetailsOperatorUpdateImpl.hpp>
+#include <DTK_DetailsSpaceFillingCurveImpl.hpp>
+#include <DTK_DetailsTargetRedistribution.hpp>
+
+#include <tuple>
+#include <typeinfo>
 
 namespace DataTransferKit
 {
@@ -23,26 +30,52 @@ template <typename DeviceType>
 NearestNeighborOperator<DeviceType>::NearestNeighborOperator(
     MPI_Comm comm, Kokkos::View<Coordinate const **, DeviceType> source_points,
     Kokkos::View<Coordinate const **, DeviceType> target_points )
-    : _comm( comm )
+    : NearestNeighborOperator(
+          PointCloudSearchTree<DeviceType>( comm, source_points ),
+          target_points )
+{
+}
+
+template <typename DeviceType>
+NearestNeighborOperator<DeviceType>::NearestNeighborOperator(
+    PointCloudSearchTree<DeviceType> const &search_tree,
+    Kokkos::View<Coordinate const **, DeviceType> target_points )
+    : _comm( search_tree.getComm() )
+    , _search_tree( search_tree )
+    , _target_points( "target_points", target_points.extent( 0 ),
+                      target_points.extent( 1 ) )
     , _indices( "indices", 0 )
     , _ranks( "ranks", 0 )
-    , _size( source_points.extent_int( 0 ) )
+    , _size( search_tree.getSourcePoints().extent_int( 0 ) )
 {
     // NOTE: instead of checking the pre-condition that there is at least one
     // source point passed to one of the rank, we let the tree handle the
-    // communication and just check that the tree is not empty.
+    // communication and check that the tree is not empty when it is built.
 
-    // Build distributed search tree over the source points.
-    ArborX::DistributedSearchTree<DeviceType> search_tree( _comm,
-                                                           source_points );
+    // Keep a copy of the target points so that update() can tell which ones
+    // moved.
+    Kokkos::deep_copy( _target_points, target_points );
+    _target_points_hash =
+        Details::OperatorArchiveImpl<DeviceType>::hashPoints( target_points );
 
-    // Tree must have at least one leaf, otherwise it makes little sense to
-    // perform the search for nearest neighbors.
-    DTK_CHECK( !search_tree.empty() );
+    using UpdateImpl = Details::OperatorUpdateImpl<DeviceType>;
 
-    // Query nearest neighbor for all target points.
+    // Query nearest neighbor for all target points. The queries are sorted
+    // along the Z-order curve so that consecutive queries traverse the same
+    // branches of the tree.
+    auto permutation =
+        Details::SpaceFillingCurveImpl<DeviceType>::sortAlongZOrder(
+            target_points );
+    auto sorted_target_points =
+        UpdateImpl::gatherRows( target_points, permutation );
+
+    // The queries are optionally performed on other processors to balance
+    // the work, and the results are sent back.
+    Details::TargetRedistribution<DeviceType> redistribution(
+        _comm, sorted_target_points, search_tree.balancesTargets() );
+    auto local_target_points = redistribution.getTargetPoints();
     auto nearest_queries = Details::NearestNeighborOperatorImpl<
-        DeviceType>::makeNearestNeighborQueries( target_points );
+        DeviceType>::makeNearestNeighborQueries( local_target_points );
 
     // Perform the actual search.
     Kokkos::View<int *, DeviceType> indices( "indices", 0 );
@@ -53,13 +86,120 @@ NearestNeighborOperator<DeviceType>::NearestNeighborOperator(
     // Check post-condition that we did find a nearest neighbor to all target
     // points.
     DTK_ENSURE( ArborX::lastElement( offset ) ==
-                target_points.extent_int( 0 ) );
+                local_target_points.extent_int( 0 ) );
+
+    offset = redistribution.sendListsBack( offset );
+    indices = redistribution.sendValuesBack( indices );
+    ranks = redistribution.sendValuesBack( ranks );
 
-    // Save results.
+    // Save results in the order of the target points of the user.
     // NOTE: we don't bother keeping `offset` around since it is just `[0, 1, 2,
     // ..., n_target_poins]`
-    _indices = indices;
-    _ranks = ranks;
+    _indices = Kokkos::View<int *, DeviceType>( "indices",
+                                                indices.extent( 0 ) );
+    _ranks = Kokkos::View<int *, DeviceType>( "ranks", ranks.extent( 0 ) );
+    UpdateImpl::scatterRows( indices, permutation, _indices );
+    UpdateImpl::scatterRows( ranks, permutation, _ranks );
+
+    // Precompute the communication pattern so that apply() only needs to
+    // exchange the values.
+    _plan = Details::CommunicationPlan<DeviceType>( _comm, _ranks, _indices );
+}
+
+template <typename DeviceType>
+NearestNeighborOperator<DeviceType>::NearestNeighborOperator(
+    MPI_Comm comm, Kokkos::View<Coordinate const **, DeviceType> source_points,
+    Kokkos::View<Coordinate const **, DeviceType> target_points,
+    std::string const &prefix )
+    : _comm( comm )
+    , _search_tree( comm, source_points )
+    , _target_points( "target_points", 0, 0 )
+    , _indices( "indices", 0 )
+    , _ranks( "ranks", 0 )
+    , _size( source_points.extent_int( 0 ) )
+{
+    using ArchiveImpl = Details::OperatorArchiveImpl<DeviceType>;
+
+    _target_points_hash = ArchiveImpl::hashPoints( target_points );
+    auto stream = ArchiveImpl::openForReading(
+        _comm, prefix,
+        ArchiveImpl::makeHeader( _comm,
+                                 typeid( NearestNeighborOperator ).name(),
+                                 source_points, _target_points_hash ) );
+    ArchiveImpl::read( stream, _indices );
+    ArchiveImpl::read( stream, _ranks );
+    ArchiveImpl::read( stream, _target_points );
+    ArchiveImpl::checkRead( _comm, stream );
+    DTK_CHECK( _indices.extent( 0 ) == target_points.extent( 0 ) );
+    DTK_CHECK( _target_points.extent( 0 ) == target_points.extent( 0 ) );
+
+    _plan = Details::CommunicationPlan<DeviceType>( _comm, _ranks, _indices );
+}
+
+template <typename DeviceType>
+void NearestNeighborOperator<DeviceType>::save(
+    std::string const &prefix ) const
+{
+    using ArchiveImpl = Details::OperatorArchiveImpl<DeviceType>;
+
+    auto stream = ArchiveImpl::openForWriting(
+        _comm, prefix,
+        ArchiveImpl::makeHeader( _comm,
+                                 typeid( NearestNeighborOperator ).name(),
+                                 _search_tree.getSourcePoints(),
+                                 _target_points_hash ) );
+    ArchiveImpl::write( stream, _indices );
+    ArchiveImpl::write( stream, _ranks );
+    // The positions at which the targets were searched, which update()
+    // compares the next target points with.
+    ArchiveImpl::write( stream, _target_points );
+}
+
+template <typename DeviceType>
+void NearestNeighborOperator<DeviceType>::update(
+    Kokkos::View<Coordinate const **, DeviceType> target_points,
+    double tolerance )
+{
+    DTK_REQUIRE( target_points.extent( 0 ) == _target_points.extent( 0 ) );
+    DTK_REQUIRE( target_points.extent( 1 ) == _target_points.extent( 1 ) );
+    DTK_REQUIRE( tolerance >= 0. );
+
+    using Impl = Details::NearestNeighborOperatorImpl<DeviceType>;
+    using UpdateImpl = Details::OperatorUpdateImpl<DeviceType>;
+
+    auto requeried_targets = UpdateImpl::selectTargets(
+        Impl::classifyMovedTargets( _target_points, target_points, tolerance ),
+        1 );
+
+    // The search is collective so it is performed even if no target point
+    // moved on this processor.
+    auto nearest_queries = Impl::makeNearestNeighborQueries(
+        UpdateImpl::gatherRows( target_points, requeried_targets ) );
+    Kokkos::View<int *, DeviceType> new_indices( "indices", 0 );
+    Kokkos::View<int *, DeviceType> new_offset( "offset", 0 );
+    Kokkos::View<int *, DeviceType> new_ranks( "ranks", 0 );
+    _search_tree.query( nearest_queries, new_indices, new_offset, new_ranks );
+    DTK_ENSURE( ArborX::lastElement( new_offset ) ==
+                requeried_targets.extent_int( 0 ) );
+
+    // Every target point has exactly one neighbor.
+    int const n_target_points = _target_points.extent( 0 );
+    Kokkos::View<int *, DeviceType> offset( "offset", n_target_points + 1 );
+    ArborX::iota( ExecutionSpace{}, offset );
+    Kokkos::View<int *, DeviceType> origin;
+    std::tie( std::ignore, origin ) =
+        UpdateImpl::mergeLists( offset, requeried_targets, new_offset );
+    _indices = UpdateImpl::mergeValues( origin, _indices, new_indices );
+    _ranks = UpdateImpl::mergeValues( origin, _ranks, new_ranks );
+
+    UpdateImpl::scatterRows(
+        UpdateImpl::gatherRows( target_points, requeried_targets ),
+        requeried_targets, _target_points );
+    _target_points_hash =
+        Details::OperatorArchiveImpl<DeviceType>::hashPoints( target_points );
+
+    // NOTE: This is the last collective.
+    _plan = Details::CommunicationPlan<DeviceType>( _comm, _ranks, _indices );
 }
 
 template <typename DeviceType>
@@ -71,12 +211,150 @@ void NearestNeighborOperator<DeviceType>::apply(
     DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
     DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
 
-    auto values = Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
-        _comm, _ranks, _indices, source_values );
+    auto values = _plan.fetch( source_values );
+
+    Kokkos::deep_copy( target_values, values );
+}
+
+template <typename DeviceType>
+void NearestNeighborOperator<DeviceType>::apply(
+    Kokkos::View<double const **, DeviceType> source_values,
+    Kokkos::View<double **, DeviceType> target_values ) const
+{
+    // Precondition: check that the source and target are properly sized
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    auto values = _plan.fetch( source_values );
 
     Kokkos::deep_copy( target_values, values );
 }
 
+template <typename DeviceType>
+void NearestNeighborOperator<DeviceType>::applySubset(
+    Kokkos::View<double const *, DeviceType> source_values,
+    Kokkos::View<int const *, DeviceType> target_indices,
+    Kokkos::View<double *, DeviceType> target_values ) const
+{
+    applySubsetImpl( source_values, target_indices, target_values );
+}
+
+template <typename DeviceType>
+void NearestNeighborOperator<DeviceType>::applySubset(
+    Kokkos::View<double const **, DeviceType> source_values,
+    Kokkos::View<int const *, DeviceType> target_indices,
+    Kokkos::View<double **, DeviceType> target_values ) const
+{
+    applySubsetImpl( source_values, target_indices, target_values );
+}
+
+template <typename DeviceType>
+template <typename SourceView, typename TargetView>
+void NearestNeighborOperator<DeviceType>::applySubsetImpl(
+    SourceView source_values,
+    Kokkos::View<int const *, DeviceType> target_indices,
+    TargetView target_values ) const
+{
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    // The requests of the plan are the target points.
+    Details::OperatorUpdateImpl<DeviceType>::scatterRows(
+        _plan.fetchSubset( source_values, target_indices ), target_indices,
+        target_values );
+}
+
+template <typename DeviceType>
+typename NearestNeighborOperator<DeviceType>::ApplyHandle
+NearestNeighborOperator<DeviceType>::applyBegin(
+    Kokkos::View<double const *, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+
+    ApplyHandle handle;
+    handle.setState( _plan.fetchBegin( source_values ) );
+    return handle;
+}
+
+template <typename DeviceType>
+void NearestNeighborOperator<DeviceType>::applyEnd(
+    ApplyHandle &handle,
+    Kokkos::View<double *, DeviceType> target_values ) const
+{
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+
+    // The values are received directly in the order of the target points.
+    _plan.fetchEnd( handle.template getState<Details::PendingFetch<double>>(),
+                    target_values );
+    handle.clear();
+}
+
+template <typename DeviceType>
+typename NearestNeighborOperator<DeviceType>::ApplyHandle
+NearestNeighborOperator<DeviceType>::applyBegin(
+    Kokkos::View<double const **, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+
+    ApplyHandle handle;
+    handle.setState( _plan.fetchBegin( source_values ) );
+    return handle;
+}
+
+template <typename DeviceType>
+void NearestNeighborOperator<DeviceType>::applyEnd(
+    ApplyHandle &handle,
+    Kokkos::View<double **, DeviceType> target_values ) const
+{
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+
+    _plan.fetchEnd( handle.template getState<Details::PendingFetch<double>>(),
+                    target_values );
+    handle.clear();
+}
+
+template <typename DeviceType>
+void NearestNeighborOperator<DeviceType>::applyTranspose(
+    Kokkos::View<double const *, DeviceType> target_values,
+    Kokkos::View<double *, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+
+    // Send the target values back to their nearest neighbor.
+    Kokkos::deep_copy( source_values, 0. );
+    _plan.push( target_values, source_values );
+}
+
+template <typename DeviceType>
+void NearestNeighborOperator<DeviceType>::applyTranspose(
+    Kokkos::View<double const **, DeviceType> target_values,
+    Kokkos::View<double **, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    Kokkos::deep_copy( source_values, 0. );
+    _plan.push( target_values, source_values );
+}
+
+template <typename DeviceType>
+DistributedCrsMatrix<DeviceType>
+NearestNeighborOperator<DeviceType>::getCrsMatrix() const
+{
+    int const n_target_points = _indices.extent( 0 );
+    Kokkos::View<int *, DeviceType> row_ptrs( "row_ptrs",
+                                              n_target_points + 1 );
+    ArborX::iota( ExecutionSpace{}, row_ptrs );
+    Kokkos::View<double *, DeviceType> values( "values", n_target_points );
+    Kokkos::deep_copy( values, 1. );
+
+    return DistributedCrsMatrix<DeviceType>( _plan, row_ptrs, values );
+}
+
 } // namespace DataTransferKit
 
 // Explicit instantiation macro
@@ -0,0 +1,209 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_OPERATOR_COMPOSITION_HPP
+#define DTK_OPERATOR_COMPOSITION_HPP
+
+#include <DTK_DBC.hpp>
+#include <DTK_DetailsCommunicationPlan.hpp>
+#include <DTK_DistributedCrsMatrix.hpp>
+#include <DTK_PointCloudOperator.hpp>
+
+#include <ArborX.hpp>
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace DataTransferKit
+{
+
+/**
+ * Fuse two maps applied one after the other into a single matrix. The target
+ * points of @param first must be the source points of @param second, with
+ * the same distribution and the same local indices. The product
+ * second * first is computed once from the neighbor lists and the
+ * coefficients of the two matrices, so that applying the result moves the
+ * source values with a single exchange instead of two and never forms the
+ * intermediate values.
+ *
+ * The result is a DistributedCrsMatrix, not a PointCloudOperator: it can be
+ * applied to one or several fields but it cannot be updated, saved, or
+ * transposed. The entries of a row of the product that refer to the same
+ * source point are merged. The rows are multiplied on the host, by a single
+ * thread, so composing is meant to be done once and amortized over many
+ * applications. Collective.
+ */
+template <typename DeviceType>
+DistributedCrsMatrix<DeviceType>
+compose( DistributedCrsMatrix<DeviceType> const &first,
+         DistributedCrsMatrix<DeviceType> const &second )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    MPI_Comm comm = first.getComm();
+
+    // Owner and local index of the source point of every entry of the first
+    // matrix, and start and length of every row.
+    int const n_first_rows = first.getNumberOfRows();
+    int const n_first_entries = first.getValues().extent( 0 );
+    auto first_row_ptrs = first.getRowPtrs();
+    auto first_columns = first.getColumns();
+    auto first_column_ranks = first.getColumnRanks();
+    auto first_column_indices = first.getColumnIndices();
+    Kokkos::View<int **, DeviceType> first_entries( "entries",
+                                                    n_first_entries, 2 );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "compose::describe_entries" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_first_entries ),
+        KOKKOS_LAMBDA( int j ) {
+            first_entries( j, 0 ) = first_column_ranks( first_columns( j ) );
+            first_entries( j, 1 ) = first_column_indices( first_columns( j ) );
+        } );
+    Kokkos::View<int **, DeviceType> first_rows( "rows", n_first_rows, 2 );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "compose::describe_rows" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_first_rows ),
+        KOKKOS_LAMBDA( int i ) {
+            first_rows( i, 0 ) = first_row_ptrs( i );
+            first_rows( i, 1 ) = first_row_ptrs( i + 1 ) - first_row_ptrs( i );
+        } );
+    Kokkos::fence();
+
+    // Fetch the rows of the first matrix that the columns of the second one
+    // refer to: their start and length, then all their entries.
+    auto second_column_ranks = second.getColumnRanks();
+    Details::CommunicationPlan<DeviceType> row_plan(
+        comm, second_column_ranks, second.getColumnIndices() );
+    auto rows = row_plan.fetch( first_rows );
+
+    int const n_second_columns = second.getNumberOfColumns();
+    Kokkos::View<int *, DeviceType> row_offset( "offset",
+                                                n_second_columns + 1 );
+    Kokkos::parallel_scan(
+        DTK_MARK_REGION( "compose::row_offset" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_second_columns + 1 ),
+        KOKKOS_LAMBDA( int c, int &update, bool final_pass ) {
+            if ( final_pass )
+                row_offset( c ) = update;
+            if ( c < n_second_columns )
+                update += rows( c, 1 );
+        } );
+
+    int const n_requested = ArborX::lastElement( row_offset );
+    Kokkos::View<int *, DeviceType> entry_ranks( "ranks", n_requested );
+    Kokkos::View<int *, DeviceType> entry_indices( "indices", n_requested );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "compose::request_entries" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_second_columns ),
+        KOKKOS_LAMBDA( int c ) {
+            for ( int k = row_offset( c ); k < row_offset( c + 1 ); ++k )
+            {
+                entry_ranks( k ) = second_column_ranks( c );
+                entry_indices( k ) = rows( c, 0 ) + k - row_offset( c );
+            }
+        } );
+    Kokkos::fence();
+
+    Details::CommunicationPlan<DeviceType> entry_plan( comm, entry_ranks,
+                                                       entry_indices );
+    auto entries = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, entry_plan.fetch( first_entries ) );
+    auto entry_values = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, entry_plan.fetch( first.getValues() ) );
+    auto row_offset_host =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, row_offset );
+
+    // Multiply row by row. The entries of a row are sorted by source point
+    // so that the duplicates are adjacent and can be merged.
+    auto second_row_ptrs = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, second.getRowPtrs() );
+    auto second_columns = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, second.getColumns() );
+    auto second_values = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, second.getValues() );
+    int const n_rows = second.getNumberOfRows();
+    std::vector<int> row_ptrs( n_rows + 1, 0 );
+    std::vector<int> ranks;
+    std::vector<int> indices;
+    std::vector<double> values;
+    std::vector<std::tuple<int, int, double>> row;
+    for ( int i = 0; i < n_rows; ++i )
+    {
+        row.clear();
+        for ( int j = second_row_ptrs( i ); j < second_row_ptrs( i + 1 ); ++j )
+        {
+            int const c = second_columns( j );
+            for ( int k = row_offset_host( c ); k < row_offset_host( c + 1 );
+                  ++k )
+                row.emplace_back( entries( k, 0 ), entries( k, 1 ),
+                                  second_values( j ) * entry_values( k ) );
+        }
+        std::sort( row.begin(), row.end() );
+        for ( unsigned int k = 0; k < row.size(); ++k )
+        {
+            int const rank = std::get<0>( row[k] );
+            int const index = std::get<1>( row[k] );
+            if ( k > 0 && rank == ranks.back() && index == indices.back() )
+            {
+                values.back() += std::get<2>( row[k] );
+                continue;
+            }
+            ranks.push_back( rank );
+            indices.push_back( index );
+            values.push_back( std::get<2>( row[k] ) );
+        }
+        row_ptrs[i + 1] = ranks.size();
+    }
+
+    using UnmanagedHostInts =
+        Kokkos::View<int const *, Kokkos::HostSpace,
+                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+    Kokkos::View<int *, DeviceType> product_row_ptrs( "row_ptrs", n_rows + 1 );
+    Kokkos::deep_copy( product_row_ptrs,
+                       UnmanagedHostInts( row_ptrs.data(), row_ptrs.size() ) );
+    Kokkos::View<int *, DeviceType> product_ranks( "ranks", ranks.size() );
+    Kokkos::deep_copy( product_ranks,
+                       UnmanagedHostInts( ranks.data(), ranks.size() ) );
+    Kokkos::View<int *, DeviceType> product_indices( "indices",
+                                                     indices.size() );
+    Kokkos::deep_copy( product_indices,
+                       UnmanagedHostInts( indices.data(), indices.size() ) );
+    Kokkos::View<double *, DeviceType> product_values( "values",
+                                                       values.size() );
+    Kokkos::deep_copy(
+        product_values,
+        Kokkos::View<double const *, Kokkos::HostSpace,
+                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+            values.data(), values.size() ) );
+
+    return DistributedCrsMatrix<DeviceType>(
+        Details::CommunicationPlan<DeviceType>( comm, product_ranks,
+                                                product_indices ),
+        product_row_ptrs, product_values );
+}
+
+/**
+ * Same as above for two operators, which may be of different types. Both of
+ * them must provide getCrsMatrix(). The result is a matrix, not an operator.
+ * Collective.
+ */
+template <typename DeviceType>
+DistributedCrsMatrix<DeviceType>
+compose( PointCloudOperator<DeviceType> const &first,
+         PointCloudOperator<DeviceType> const &second )
+{
+    return compose( first.getCrsMatrix(), second.getCrsMatrix() );
+}
+
+} // end namespace DataTransferKit
+
+#endif
@@ -13,8 +13,14 @@
 #define DTK_POINT_CLOUD_OPERATOR_DECL_HPP
 
 #include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+#include <DTK_DetailsOperatorUpdateImpl.hpp>
+#include <DTK_DistributedCrsMatrix.hpp>
 
-#include <Kokkos_View.hpp>
+#include <Kokkos_Core.hpp>
+
+#include <memory>
+#include <utility>
 
 namespace DataTransferKit
 {
@@ -25,6 +31,57 @@ template <typename DeviceType>
 class PointCloudOperator
 {
   public:
+    /**
+     * State of a transfer that was started with applyBegin() and that must be
+     * completed with applyEnd(). A handle can only be completed once. The
+     * type of the state is chosen by the operator that started the transfer,
+     * e.g. the values that are being exchanged between the processors.
+     */
+    class ApplyHandle
+    {
+      public:
+        template <typename State>
+        void setState( State state )
+        {
+            _state.reset( new Holder<State>( std::move( state ) ) );
+        }
+
+        /**
+         * State given to setState(), which must have been called with the
+         * same type. The state is left in the handle.
+         */
+        template <typename State>
+        State &getState()
+        {
+            auto holder = dynamic_cast<Holder<State> *>( _state.get() );
+            DTK_INSIST( holder != nullptr );
+            return holder->state;
+        }
+
+        /**
+         * Release the state once the transfer is completed.
+         */
+        void clear() { _state.reset(); }
+
+      private:
+        struct HolderBase
+        {
+            virtual ~HolderBase() = default;
+        };
+
+        template <typename State>
+        struct Holder : HolderBase
+        {
+            Holder( State state_ )
+                : state( std::move( state_ ) )
+            {
+            }
+            State state;
+        };
+
+        std::unique_ptr<HolderBase> _state;
+    };
+
     virtual ~PointCloudOperator() = default;
 
     /**
@@ -34,6 +91,144 @@ class PointCloudOperator
     virtual void
     apply( Kokkos::View<double const *, DeviceType> source_values,
            Kokkos::View<double *, DeviceType> target_values ) const = 0;
+
+    /**
+     * Compute the values of several fields at the target points given their
+     * values at the source points. Each column of the views holds one field.
+     * All the fields are transferred together, i.e. with a single exchange of
+     * data between the processors.
+     */
+    virtual void
+    apply( Kokkos::View<double const **, DeviceType> source_values,
+           Kokkos::View<double **, DeviceType> target_values ) const = 0;
+
+    /**
+     * Same as apply() but only compute the target values at the positions
+     * @param target_indices. The other entries of @param target_values are
+     * left untouched. This is meant for transfers that only need to refresh
+     * some of the targets, e.g. in an active region, as only the source values
+     * used by these targets are exchanged between the processors. The
+     * communication pattern of apply() is reused, and every call first tells
+     * the owners which of their values are needed with an exchange of masks,
+     * so this pays off when few targets are selected. This function is
+     * collective, even for the processors that select no target.
+     *
+     * Operators that cannot compute a subset of the targets perform the whole
+     * transfer and copy the selected values.
+     */
+    virtual void
+    applySubset( Kokkos::View<double const *, DeviceType> source_values,
+                 Kokkos::View<int const *, DeviceType> target_indices,
+                 Kokkos::View<double *, DeviceType> target_values ) const
+    {
+        using UpdateImpl = Details::OperatorUpdateImpl<DeviceType>;
+        Kokkos::View<double *, DeviceType> all_target_values(
+            target_values.label(), target_values.extent( 0 ) );
+        apply( source_values, all_target_values );
+        UpdateImpl::scatterRows(
+            UpdateImpl::gatherRows( all_target_values, target_indices ),
+            target_indices, target_values );
+    }
+
+    virtual void
+    applySubset( Kokkos::View<double const **, DeviceType> source_values,
+                 Kokkos::View<int const *, DeviceType> target_indices,
+                 Kokkos::View<double **, DeviceType> target_values ) const
+    {
+        using UpdateImpl = Details::OperatorUpdateImpl<DeviceType>;
+        Kokkos::View<double **, DeviceType> all_target_values(
+            target_values.label(), target_values.extent( 0 ),
+            target_values.extent( 1 ) );
+        apply( source_values, all_target_values );
+        UpdateImpl::scatterRows(
+            UpdateImpl::gatherRows( all_target_values, target_indices ),
+            target_indices, target_values );
+    }
+
+    /**
+     * Split-phase version of apply(). applyBegin() starts moving the source
+     * values where they are needed and returns without waiting for the
+     * communication to complete. The caller is free to do other work, and
+     * even to modify @param source_values, before calling applyEnd() to
+     * compute the target values.
+     *
+     * Operators that cannot overlap communication and computation perform the
+     * whole transfer in applyEnd().
+     */
+    virtual ApplyHandle
+    applyBegin( Kokkos::View<double const *, DeviceType> source_values ) const
+    {
+        // Keep a copy so that the caller may modify the source values.
+        Kokkos::View<double *, DeviceType> source_values_copy(
+            source_values.label(), source_values.extent( 0 ) );
+        Kokkos::deep_copy( source_values_copy, source_values );
+        ApplyHandle handle;
+        handle.setState(
+            Kokkos::View<double const *, DeviceType>( source_values_copy ) );
+        return handle;
+    }
+
+    virtual void
+    applyEnd( ApplyHandle &handle,
+              Kokkos::View<double *, DeviceType> target_values ) const
+    {
+        apply( handle.template getState<
+                   Kokkos::View<double const *, DeviceType>>(),
+               target_values );
+        handle.clear();
+    }
+
+    virtual ApplyHandle
+    applyBegin( Kokkos::View<double const **, DeviceType> source_values ) const
+    {
+        Kokkos::View<double **, DeviceType> source_values_copy(
+            source_values.label(), source_values.extent( 0 ),
+            source_values.extent( 1 ) );
+        Kokkos::deep_copy( source_values_copy, source_values );
+        ApplyHandle handle;
+        handle.setState(
+            Kokkos::View<double const **, DeviceType>( source_values_copy ) );
+        return handle;
+    }
+
+    virtual void
+    applyEnd( ApplyHandle &handle,
+              Kokkos::View<double **, DeviceType> target_values ) const
+    {
+        apply( handle.template getState<
+                   Kokkos::View<double const **, DeviceType>>(),
+               target_values );
+        handle.clear();
+    }
+
+    /**
+     * Apply the transpose of the operator, i.e. compute values at the source
+     * points given values at the target points. This is the adjoint of
+     * apply(): the neighbors and the coefficients of the operator are reused
+     * and the contributions of the target points are summed on the processors
+     * that own the source points.
+     */
+    virtual void applyTranspose(
+        Kokkos::View<double const *, DeviceType> target_values,
+        Kokkos::View<double *, DeviceType> source_values ) const = 0;
+
+    /**
+     * Same as above for several fields, one per column of the views.
+     */
+    virtual void applyTranspose(
+        Kokkos::View<double const **, DeviceType> target_values,
+        Kokkos::View<double **, DeviceType> source_values ) const = 0;
+
+    /**
+     * Materialize the operator as a sparse matrix with one row per target
+     * point and one column per source point in its halo. Operators that do
+     * not have an explicit representation throw.
+     */
+    virtual DistributedCrsMatrix<DeviceType> getCrsMatrix() const
+    {
+        throw DataTransferKitException(
+            "This operator cannot be converted to a sparse matrix" );
+    }
 };
 
 } // end namespace DataTransferKit
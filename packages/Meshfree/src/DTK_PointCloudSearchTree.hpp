@@ -0,0 +1,288 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_POINT_CLOUD_SEARCH_TREE_HPP
+#define DTK_POINT_CLOUD_SEARCH_TREE_HPP
+
+#include <ArborX.hpp>
+#include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+#include <DTK_DetailsCoincidentPoints.hpp>
+#include <DTK_DetailsCommunicationPlan.hpp>
+#include <DTK_DetailsOperatorUpdateImpl.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include <mpi.h>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+
+// Point of the search space for the i-th row of @param points. The search is
+// always done in 3D, so the missing coordinates of points in dimension 1 or 2
+// are set to zero.
+template <typename View>
+KOKKOS_INLINE_FUNCTION ArborX::Point makePoint( View const &points, int i )
+{
+    ArborX::Point point = {{0., 0., 0.}};
+    for ( int d = 0; d < points.extent_int( 1 ); ++d )
+        point[d] = points( i, d );
+    return point;
+}
+
+} // namespace Details
+
+/**
+ * Distributed search tree over a cloud of source points. Building the tree is
+ * collective and it is the most expensive part of the setup of the meshfree
+ * operators. This object can be passed to the constructor of several operators
+ * that share the same source points, or kept around to rebuild an operator
+ * when only the target points change. Copies are cheap and share the same
+ * tree.
+ *
+ * The tree is built by the first search, so that operators that never search,
+ * e.g. when they are loaded from a file, do not pay for it.
+ *
+ * The source points are not copied and must not be modified while the object
+ * is in use. They may live in dimension 1, 2, or 3.
+ *
+ * If @param balance_targets is true, the operators built with this tree
+ * redistribute their target points so that all the processors search and set
+ * up the same number of targets, and send the results back to the processors
+ * that own the targets. It pays off when the target points are unevenly
+ * distributed among the processors. The result does not depend on it.
+ *
+ * If @param coincidence_tolerance is positive, the source points that
+ * coincide up to this tolerance, on the same processor or not, are collapsed
+ * before the tree is built: only one point per cluster is indexed, so that
+ * the neighbors of a target are distinct locations. This improves the
+ * conditioning of the moving least squares problems on clouds built from
+ * element nodes and saves stencil entries and traffic. The other points of a
+ * cluster are never returned by the searches, so the operators use the value
+ * of the representative of the cluster and ignore the values of the others.
+ * The spline operator does not support it.
+ */
+template <typename DeviceType>
+class PointCloudSearchTree
+{
+  public:
+    using device_type = DeviceType;
+
+    PointCloudSearchTree(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        bool balance_targets = false, double coincidence_tolerance = 0. )
+        : _comm( comm )
+        , _source_points( source_points )
+        , _balance_targets( balance_targets )
+        , _coincidence_tolerance( coincidence_tolerance )
+        , _tree( std::make_shared<std::unique_ptr<Tree>>() )
+        , _representatives(
+              std::make_shared<Kokkos::View<int *, DeviceType>>(
+                  "representatives", 0 ) )
+    {
+        DTK_REQUIRE( source_points.extent( 1 ) >= 1 &&
+                     source_points.extent( 1 ) <= 3 );
+    }
+
+    MPI_Comm getComm() const { return _comm; }
+
+    bool balancesTargets() const { return _balance_targets; }
+
+    bool collapsesCoincidentPoints() const
+    {
+        return _coincidence_tolerance > 0.;
+    }
+
+    Kokkos::View<Coordinate const **, DeviceType> getSourcePoints() const
+    {
+        return _source_points;
+    }
+
+    /**
+     * Estimate the radius of a ball that contains about @param n_neighbors
+     * source points, assuming that the source points are quasi-uniformly
+     * distributed in their bounding box. The dimensions of the bounding box
+     * with a zero extent (e.g. for a planar cloud) are ignored, and the
+     * estimate aims at twice as many points to make up for the
+     * non-uniformity. When coincident points are collapsed, only the
+     * representatives of the clusters are counted, which requires the tree to
+     * be built. This function is collective.
+     */
+    double estimateSupportRadius( int n_neighbors ) const
+    {
+        DTK_REQUIRE( n_neighbors > 0 );
+
+        using ExecutionSpace = typename DeviceType::execution_space;
+        auto source_points = _source_points;
+        int const n_local = source_points.extent( 0 );
+        int const spatial_dim = source_points.extent( 1 );
+        DTK_REQUIRE( spatial_dim <= 3 );
+
+        double min_corner[3];
+        double max_corner[3];
+        for ( int d = 0; d < spatial_dim; ++d )
+        {
+            Kokkos::parallel_reduce(
+                DTK_MARK_REGION( "bounding_box_min" ),
+                Kokkos::RangePolicy<ExecutionSpace>( 0, n_local ),
+                KOKKOS_LAMBDA( int i, double &m ) {
+                    if ( source_points( i, d ) < m )
+                        m = source_points( i, d );
+                },
+                Kokkos::Min<double>( min_corner[d] ) );
+            Kokkos::parallel_reduce(
+                DTK_MARK_REGION( "bounding_box_max" ),
+                Kokkos::RangePolicy<ExecutionSpace>( 0, n_local ),
+                KOKKOS_LAMBDA( int i, double &m ) {
+                    if ( source_points( i, d ) > m )
+                        m = source_points( i, d );
+                },
+                Kokkos::Max<double>( max_corner[d] ) );
+        }
+        MPI_Allreduce( MPI_IN_PLACE, min_corner, spatial_dim, MPI_DOUBLE,
+                       MPI_MIN, _comm );
+        MPI_Allreduce( MPI_IN_PLACE, max_corner, spatial_dim, MPI_DOUBLE,
+                       MPI_MAX, _comm );
+        // The searches only return the representatives of the clusters of
+        // coincident points.
+        long long n_points = n_local;
+        if ( collapsesCoincidentPoints() )
+        {
+            getTree();
+            n_points = _representatives->extent( 0 );
+        }
+        MPI_Allreduce( MPI_IN_PLACE, &n_points, 1, MPI_LONG_LONG, MPI_SUM,
+                       _comm );
+
+        double max_extent = 0.;
+        for ( int d = 0; d < spatial_dim; ++d )
+            max_extent = std::max( max_extent, max_corner[d] - min_corner[d] );
+        // All the points are at the same position.
+        if ( !( max_extent > 0. ) )
+            return 1.;
+
+        // Measure of the bounding box in its non-degenerate dimensions.
+        int dim = 0;
+        double measure = 1.;
+        for ( int d = 0; d < spatial_dim; ++d )
+        {
+            double const extent = max_corner[d] - min_corner[d];
+            if ( extent > 1e-12 * max_extent )
+            {
+                ++dim;
+                measure *= extent;
+            }
+        }
+
+        // Measure of the unit ball in dimension dim.
+        double const pi = std::acos( -1. );
+        double const unit_ball[] = {2., pi, 4. / 3. * pi};
+
+        return std::pow( 2. * n_neighbors * measure /
+                             ( unit_ball[dim - 1] * n_points ),
+                         1. / dim );
+    }
+
+    /**
+     * Find the source points that satisfy the predicates. The results are
+     * returned in CRS format: the matches of the i-th query are in
+     * [offset(i), offset(i+1)) with the rank of the processor that owns them
+     * and their local index on that processor. Collective.
+     */
+    template <typename Predicates>
+    void query( Predicates const &queries,
+                Kokkos::View<int *, DeviceType> &indices,
+                Kokkos::View<int *, DeviceType> &offset,
+                Kokkos::View<int *, DeviceType> &ranks ) const
+    {
+        getTree().query( queries, indices, offset, ranks );
+
+        // The tree numbers the representatives of the clusters of coincident
+        // points. Their owners know their index among all the source points.
+        if ( collapsesCoincidentPoints() )
+        {
+            Details::CommunicationPlan<DeviceType> plan( _comm, ranks,
+                                                         indices );
+            indices = plan.fetch( *_representatives );
+        }
+    }
+
+  private:
+    using Tree = ArborX::DistributedSearchTree<DeviceType>;
+
+    Tree const &getTree() const
+    {
+        if ( !*_tree )
+        {
+            auto search_points = getSearchPoints();
+            if ( collapsesCoincidentPoints() )
+            {
+                *_representatives = Details::CoincidentPointsImpl<
+                    DeviceType>::findRepresentatives( _comm, search_points,
+                                                      _coincidence_tolerance );
+                search_points =
+                    Details::OperatorUpdateImpl<DeviceType>::gatherRows(
+                        search_points, *_representatives );
+            }
+            _tree->reset( new Tree( _comm, search_points ) );
+            // The tree must have at least one leaf, otherwise it makes little
+            // sense to perform searches.
+            DTK_CHECK( !( *_tree )->empty() );
+        }
+        return **_tree;
+    }
+
+    // The tree indexes points in 3D. Points in lower dimension are padded
+    // with zeros.
+    Kokkos::View<Coordinate const **, DeviceType> getSearchPoints() const
+    {
+        if ( _source_points.extent( 1 ) == 3 )
+            return _source_points;
+
+        using ExecutionSpace = typename DeviceType::execution_space;
+        auto source_points = _source_points;
+        int const n_points = source_points.extent( 0 );
+        Kokkos::View<Coordinate **, DeviceType> search_points(
+            "search_points", n_points, 3 );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "pad_source_points" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            KOKKOS_LAMBDA( int i ) {
+                ArborX::Point const point =
+                    Details::makePoint( source_points, i );
+                for ( int d = 0; d < 3; ++d )
+                    search_points( i, d ) = point[d];
+            } );
+        Kokkos::fence();
+        return search_points;
+    }
+
+    MPI_Comm _comm;
+    Kokkos::View<Coordinate const **, DeviceType> _source_points;
+    bool _balance_targets;
+    double _coincidence_tolerance;
+    // Shared by all the copies so that the tree is built at most once.
+    std::shared_ptr<std::unique_ptr<Tree>> _tree;
+    // Local index of the i-th point of the tree when coincident points are
+    // collapsed. Built with the tree.
+    std::shared_ptr<Kokkos::View<int *, DeviceType>> _representatives;
+};
+
+} // namespace DataTransferKit
+
+#endif
@@ -13,12 +13,20 @@
 #define DTK_SPLINE_OPERATOR_DECL_HPP
 
 #include <DTK_CompactlySupportedRadialBasisFunctions.hpp>
+#include <DTK_DetailsBasisMatrix.hpp>
+#include <DTK_DetailsOperatorArchiveImpl.hpp>
 #include <DTK_MultivariatePolynomialBasis.hpp>
 #include <DTK_PointCloudOperator.hpp>
+#include <DTK_PointCloudSearchTree.hpp>
 
 #include <Tpetra_CrsMatrix.hpp>
 
+#include <Teuchos_ParameterList.hpp>
+
 #include <Thyra_LinearOpBase.hpp>
+#include <Thyra_LinearOpWithSolveBase.hpp>
+
+#include <string>
 
 #include <mpi.h>
 
@@ -34,17 +42,19 @@ namespace DataTransferKit
  *
  * The class is templated on the DeviceType, the radial basis function
  * (Wendland<0>, Wendland<2>, Wendland<4>, Wendland<6>, Wu<2>, Wu<4>,
- * Buhmann<2>, Buhmann<3>, or Buhmann<4>) and polynonial basis (<Constant, DIM>,
- * <Linear, DIM>, or <Quadratic, DIM>).
+ * Buhmann<2>, Buhmann<3>, or Buhmann<4>) and polynonial basis (<Linear, DIM>
+ * only). The points live in dimension DIM, which is 1, 2, or 3.
  */
 template <typename DeviceType,
           typename CompactlySupportedRadialBasisFunction = Wendland<0>,
           typename PolynomialBasis = MultivariatePolynomialBasis<Linear, 3>>
 class SplineOperator : public PointCloudOperator<DeviceType>
 {
-    static_assert( std::is_same<PolynomialBasis,
-                                MultivariatePolynomialBasis<Linear, 3>>::value,
-                   "Only implemented for linear basis functions!" );
+    static_assert(
+        std::is_same<PolynomialBasis,
+                     MultivariatePolynomialBasis<
+                         Linear, PolynomialBasis::dimension>>::value,
+        "Only implemented for linear basis functions!" );
     using LO = int;
     using GO = long long;
     using NO = Kokkos::Compat::KokkosDeviceWrapperNode<
@@ -55,6 +65,7 @@ class SplineOperator : public PointCloudOperator<DeviceType>
     using Map = Tpetra::Map<LO, GO, NO>;
     using Operator = Tpetra::Operator<SC, LO, GO, NO>;
     using Vector = Tpetra::MultiVector<SC, LO, GO, NO>;
+    using BasisOperator = BasisMatrix<SC, LO, GO, NO>;
 
   public:
     using device_type = DeviceType;
@@ -62,16 +73,117 @@ class SplineOperator : public PointCloudOperator<DeviceType>
     using polynomial_basis = PolynomialBasis;
     using radial_basis_function = CompactlySupportedRadialBasisFunction;
 
+    /**
+     * The optional @param parameters control the solve of the saddle point
+     * system in apply():
+     *  - "Preconditioner" (bool, default true): precondition the Krylov solver
+     *    with a block preconditioner that is factored once at construction.
+     *  - "Warm Start" (bool, default false): start the solve from the solution
+     *    of the previous call to apply() with the same number of fields. This
+     *    pays off when the source values change little from one call to the
+     *    next, e.g. for time-dependent transfers.
+     *  - "Convergence Tolerance" (double, default 1e-10).
+     */
     SplineOperator(
         MPI_Comm comm,
         Kokkos::View<Coordinate const **, DeviceType> source_points,
-        Kokkos::View<Coordinate const **, DeviceType> target_points );
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        Teuchos::ParameterList const &parameters = Teuchos::ParameterList() );
+
+    /**
+     * Same as above but reuse a search tree that was built over the source
+     * points. The tree must not collapse coincident points.
+     */
+    SplineOperator(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        Teuchos::ParameterList const &parameters = Teuchos::ParameterList() );
+
+    /**
+     * Same as above but the neighbors of a point are all the source points
+     * within @param support_radius of it instead of its PolynomialBasis::size
+     * closest source points, and the radial basis function has the same
+     * support everywhere. If the support radius is not positive, it is
+     * estimated from the density of the source points. On quasi-uniform point
+     * clouds, this gives a more regular sparsity pattern for the basis
+     * blocks and the spatial searches are cheaper than nearest neighbor
+     * searches.
+     */
+    SplineOperator(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        double support_radius,
+        Teuchos::ParameterList const &parameters = Teuchos::ParameterList() );
+
+    /**
+     * Load the basis blocks from files written by save() instead of searching
+     * the neighbors and evaluating the radial basis function. The polynomial
+     * blocks are recomputed from the points and the solver is set up with
+     * @param parameters. The source points, the target points, and the number
+     * of processors must be the same as when the operator was saved,
+     * otherwise all the processors throw. This function is collective.
+     */
+    SplineOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        std::string const &prefix,
+        Teuchos::ParameterList const &parameters = Teuchos::ParameterList() );
+
+    /**
+     * Write the basis blocks of the operator to binary files, one per
+     * processor, named `<prefix>.<rank>` where `<prefix>` is @param prefix
+     * and `<rank>` the rank of the processor, e.g. `spline.0`.
+     */
+    void save( std::string const &prefix ) const;
 
     void
     apply( Kokkos::View<double const *, DeviceType> source_values,
            Kokkos::View<double *, DeviceType> target_values ) const override;
 
+    void
+    apply( Kokkos::View<double const **, DeviceType> source_values,
+           Kokkos::View<double **, DeviceType> target_values ) const override;
+
+    /**
+     * Apply A^T = S^T (P + M^T + P^T)^-1 (Q^T + N^T). The basis blocks and
+     * the preconditioner built for apply() are reused, only the saddle point
+     * system is solved with its transpose. The parameters given at
+     * construction apply to this solve as well.
+     */
+    void applyTranspose(
+        Kokkos::View<double const *, DeviceType> target_values,
+        Kokkos::View<double *, DeviceType> source_values ) const override;
+
+    void applyTranspose(
+        Kokkos::View<double const **, DeviceType> target_values,
+        Kokkos::View<double **, DeviceType> source_values ) const override;
+
   private:
+    // The support radius is zero for the nearest neighbor search.
+    void setup( PointCloudSearchTree<DeviceType> const &search_tree,
+                Kokkos::View<Coordinate const **, DeviceType> target_points,
+                double support_radius,
+                Teuchos::ParameterList const &parameters );
+
+    // Build the maps, the prolongation operator and the polynomial blocks.
+    void setupPolynomialBlocks(
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points );
+
+    // Build the solver once all the blocks are available.
+    void
+    setupSolver( Kokkos::View<Coordinate const **, DeviceType> source_points,
+                 Teuchos::ParameterList const &parameters );
+
+    // Compute the coefficients of the spline and evaluate it at the target
+    // points.
+    void solve( Vector const &source, Vector &destination ) const;
+
+    // Solve the transposed saddle point system with the target values on the
+    // right-hand side and restrict its solution to the source points.
+    void solveTranspose( Vector const &target, Vector &destination ) const;
+
     MPI_Comm _comm;
 
     // Prolongation operator.
@@ -81,38 +193,48 @@ class SplineOperator : public PointCloudOperator<DeviceType>
     Teuchos::RCP<const Operator> P;
 
     // Coefficient matrix basis component.
-    Teuchos::RCP<const Operator> M;
+    Teuchos::RCP<const BasisOperator> M;
 
     // Evaluation matrix polynomial component.
     Teuchos::RCP<const Operator> Q;
 
     // Evaluation matrix basis component.
-    Teuchos::RCP<const Operator> N;
+    Teuchos::RCP<const BasisOperator> N;
 
-    // Coupling matrix
-    Teuchos::RCP<const Thyra::LinearOpBase<SC>> _thyra_operator;
+    // Solver for the saddle point system C = (P + M + P^T).
+    Teuchos::RCP<Thyra::LinearOpWithSolveBase<SC>> _solver;
 
-    // Source vector
-    Teuchos::RCP<Vector> _source;
+    // Solver for the transposed system C^T = (P + M^T + P^T). M is not
+    // symmetric when the support of the radial basis function depends on the
+    // point.
+    Teuchos::RCP<Thyra::LinearOpWithSolveBase<SC>> _transpose_solver;
 
-    // Destination vector
-    Teuchos::RCP<Vector> _destination;
+    bool _warm_start;
 
-    // Source vector
-    Teuchos::RCP<Thyra::MultiVectorBase<SC>> _thyra_X;
+    // Coefficients of the spline computed by the last solve. They are the
+    // initial guess of the next solve with warm start.
+    mutable Teuchos::RCP<Vector> _coefficients;
+    mutable Teuchos::RCP<Vector> _transpose_coefficients;
 
-    // Destination vector
-    Teuchos::RCP<Thyra::MultiVectorBase<SC>> _thyra_Y;
+    // Identifies the operator and its points in the files written by save().
+    typename Details::OperatorArchiveImpl<DeviceType>::Header _archive_header;
 
     Teuchos::RCP<Operator> buildPolynomialOperator(
         Teuchos::RCP<const Map> domain_map, Teuchos::RCP<const Map> range_map,
         Kokkos::View<Coordinate const **, DeviceType> points );
 
-    Teuchos::RCP<Operator> buildBasisOperator(
+    Teuchos::RCP<BasisOperator> buildBasisOperator(
         Teuchos::RCP<const Map> domain_map, Teuchos::RCP<const Map> range_map,
-        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        PointCloudSearchTree<DeviceType> const &search_tree,
         Kokkos::View<Coordinate const **, DeviceType> target_points,
-        int const knn );
+        int const knn, double const support_radius );
+
+    Teuchos::RCP<BasisOperator>
+    loadBasisOperator( std::istream &stream, Teuchos::RCP<const Map> domain_map,
+                       Teuchos::RCP<const Map> range_map );
+
+    static void saveBasisOperator( std::ostream &stream,
+                                   BasisOperator const &basis_operator );
 };
 
 } // end namespace DataTransferKit
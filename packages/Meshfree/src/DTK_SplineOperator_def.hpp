@@ -17,19 +17,28 @@
 #include <BelosLinearProblem.hpp>
 #include <BelosTpetraAdapter.hpp>
 #include <DTK_DBC.hpp>
+#include <DTK_DetailsBasisMatrix.hpp>
+#include <DTK_DetailsCommunicationPlan.hpp>
 #include <DTK_DetailsMovingLeastSquaresOperatorImpl.hpp>
-#include <DTK_DetailsNearestNeighborOperatorImpl.hpp> // fetch
+#include <DTK_DetailsOperatorArchiveImpl.hpp>
+#include <DTK_DetailsOperatorUpdateImpl.hpp>
 #include <DTK_DetailsPolynomialMatrix.hpp>
+#include <DTK_DetailsSaddlePointPreconditioner.hpp>
+#include <DTK_DetailsSpaceFillingCurveImpl.hpp>
 #include <DTK_DetailsSplineProlongationOperator.hpp>
+#include <DTK_DetailsTargetRedistribution.hpp>
 
 #include <Stratimikos_DefaultLinearSolverBuilder.hpp>
 #include <Teuchos_XMLParameterListCoreHelpers.hpp>
 #include <Thyra_DefaultAddedLinearOp.hpp>
-#include <Thyra_DefaultMultipliedLinearOp.hpp>
+#include <Thyra_DefaultPreconditioner.hpp>
 #include <Thyra_DefaultScaledAdjointLinearOp.hpp>
 #include <Thyra_LinearOpWithSolveFactoryHelpers.hpp>
 #include <Thyra_TpetraThyraWrappers.hpp>
 
+#include <tuple>
+#include <typeinfo>
+
 namespace DataTransferKit
 {
 
@@ -37,97 +46,142 @@ template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
           typename PolynomialBasis>
 Teuchos::RCP<
     typename SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
-                            PolynomialBasis>::Operator>
+                            PolynomialBasis>::BasisOperator>
 SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
                PolynomialBasis>::
     buildBasisOperator(
         Teuchos::RCP<const Map> domain_map, Teuchos::RCP<const Map> range_map,
-        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        PointCloudSearchTree<DeviceType> const &search_tree,
         Kokkos::View<Coordinate const **, DeviceType> target_points,
-        int const knn )
+        int const knn, double const support_radius )
 {
-    auto teuchos_comm = domain_map->getComm();
-    auto teuchos_mpi_comm =
-        Teuchos::rcp_dynamic_cast<const Teuchos::MpiComm<int>>( teuchos_comm );
-    MPI_Comm comm = ( *teuchos_mpi_comm->getRawMpiComm() )();
-
-    int const num_source_points = source_points.extent( 0 );
-    int const num_points = target_points.extent( 0 );
-
-    ArborX::DistributedSearchTree<DeviceType> distributed_tree( comm,
-                                                                source_points );
-    DTK_CHECK( !distributed_tree.empty() );
-
-    // Perform the actual search.
-    auto queries =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::makeKNNQueries(
-            target_points, knn );
-
-    Kokkos::View<int *, DeviceType> offset( "offset", 0 );
-    Kokkos::View<int *, DeviceType> ranks( "ranks", 0 );
-    Kokkos::View<int *, DeviceType> indices( "indices", 0 );
-    distributed_tree.query( queries, indices, offset, ranks );
-
-    // Retrieve the coordinates of all points that met the predicates.
-    auto source_points_with_halo =
-        Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
-            comm, ranks, indices, source_points );
-
-    auto transformed_source_points = Details::MovingLeastSquaresOperatorImpl<
-        DeviceType>::transformSourceCoordinates( source_points_with_halo,
-                                                 offset, target_points );
-
-    // To build the radial basis function, we need to define the radius of
-    // the radial basis function. Since we use kNN, we need to compute the
-    // radius. We only need the coordinates of the source points because of
-    // the transformation of the coordinates.
-    auto radius =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeRadius(
-            transformed_source_points, offset );
-
-    // Build phi (weight matrix)
-    auto phi =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeWeights(
-            transformed_source_points, radius,
+    MPI_Comm comm = search_tree.getComm();
+
+    using CurveImpl = Details::SpaceFillingCurveImpl<DeviceType>;
+    using UpdateImpl = Details::OperatorUpdateImpl<DeviceType>;
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+
+    // Perform the actual search with the target points sorted along the
+    // Z-order curve, optionally on other processors to balance the work.
+    auto permutation = CurveImpl::sortAlongZOrder( target_points );
+    auto sorted_target_points =
+        UpdateImpl::gatherRows( target_points, permutation );
+    bool const balance_targets = search_tree.balancesTargets();
+    Details::TargetRedistribution<DeviceType> redistribution(
+        comm, sorted_target_points, balance_targets );
+    auto local_target_points = redistribution.getTargetPoints();
+    Kokkos::View<int *, DeviceType> local_offset( "offset", 0 );
+    Kokkos::View<int *, DeviceType> local_ranks( "ranks", 0 );
+    Kokkos::View<int *, DeviceType> local_indices( "indices", 0 );
+    Impl::findNeighbors( search_tree, local_target_points, knn,
+                         support_radius, local_indices, local_offset,
+                         local_ranks );
+
+    // The weights of the redistributed targets are computed where they were
+    // searched and sent back with the neighbor lists.
+    Kokkos::View<double *, DeviceType> local_phi( "weights", 0 );
+    if ( balance_targets )
+    {
+        Details::CommunicationPlan<DeviceType> local_plan( comm, local_ranks,
+                                                           local_indices );
+        local_phi = Impl::computeWeights(
+            local_offset, local_plan.fetch( search_tree.getSourcePoints() ),
+            local_target_points, support_radius,
             CompactlySupportedRadialBasisFunction() );
-
-    // Compute some helper arrays
-    int comm_size = teuchos_comm->getSize();
-
-    std::vector<int> cumulative_points_per_process( comm_size + 1 );
-    MPI_Allgather( &num_source_points, 1, MPI_INT,
-                   cumulative_points_per_process.data(), 1, MPI_INT, comm );
-
-    // Exclusive prefix scan
-    int total = 0;
-    for ( int i = 0; i < comm_size; ++i )
+    }
+    auto sorted_offset = redistribution.sendListsBack( local_offset );
+    auto sorted_ranks = redistribution.sendValuesBack( local_ranks );
+    auto sorted_indices = redistribution.sendValuesBack( local_indices );
+
+    // The rows of the operator follow the order of the target points. The
+    // entries(j)-th neighbor in Z-order is the j-th neighbor in that order.
+    Kokkos::View<int *, DeviceType> offset;
+    Kokkos::View<int *, DeviceType> entries;
+    std::tie( offset, entries ) = UpdateImpl::extractLists(
+        sorted_offset, CurveImpl::invertPermutation( permutation ) );
+    auto ranks = UpdateImpl::gatherRows( sorted_ranks, entries );
+    auto indices = UpdateImpl::gatherRows( sorted_indices, entries );
+
+    Details::CommunicationPlan<DeviceType> plan( comm, ranks, indices );
+
+    Kokkos::View<double *, DeviceType> phi;
+    if ( balance_targets )
     {
-        int current_value = cumulative_points_per_process[i];
-        cumulative_points_per_process[i] = total;
-        total += current_value;
+        phi = UpdateImpl::gatherRows(
+            redistribution.sendValuesBack( local_phi ), entries );
+    }
+    else
+    {
+        // Retrieve the coordinates of all points that met the predicates.
+        auto source_points_with_halo =
+            plan.fetch( search_tree.getSourcePoints() );
+
+        // Build phi (weight matrix) in Z-order and bring it back to the order
+        // of the target points.
+        Kokkos::View<Coordinate **, DeviceType> sorted_source_points_with_halo(
+            "source_points_with_halo", source_points_with_halo.extent( 0 ),
+            source_points_with_halo.extent( 1 ) );
+        UpdateImpl::scatterRows( source_points_with_halo, entries,
+                                 sorted_source_points_with_halo );
+        phi = UpdateImpl::gatherRows(
+            Impl::computeWeights( sorted_offset,
+                                  sorted_source_points_with_halo,
+                                  sorted_target_points, support_radius,
+                                  CompactlySupportedRadialBasisFunction() ),
+            entries );
     }
 
-    // Build matrix
-    auto row_map = range_map;
-    auto crs_matrix = Teuchos::rcp( new CrsMatrix( row_map, knn ) );
+    // The matrix is never assembled. The operator keeps the neighbor lists
+    // and the weights, and it retrieves the entries of the vectors it is
+    // applied to with the same communication plan.
+    return Teuchos::rcp( new BasisOperator( comm, plan, offset, ranks, indices,
+                                            phi, domain_map, range_map ) );
+}
 
-    for ( LO i = 0; i < num_points; ++i )
-        for ( int j = offset( i ); j < offset( i + 1 ); ++j )
-        {
-            const auto row_index = row_map->getGlobalElement( i );
-            const auto col_index =
-                cumulative_points_per_process[ranks( j )] + indices( j );
-            const auto value = phi( j );
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+Teuchos::RCP<
+    typename SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                            PolynomialBasis>::BasisOperator>
+SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+               PolynomialBasis>::
+    loadBasisOperator( std::istream &stream,
+                       Teuchos::RCP<const Map> domain_map,
+                       Teuchos::RCP<const Map> range_map )
+{
+    using ArchiveImpl = Details::OperatorArchiveImpl<DeviceType>;
 
-            crs_matrix->insertGlobalValues( row_index,
-                                            Teuchos::tuple<GO>( col_index ),
-                                            Teuchos::tuple<SC>( value ) );
-        }
+    Kokkos::View<int *, DeviceType> offset( "offset", 0 );
+    Kokkos::View<int *, DeviceType> ranks( "ranks", 0 );
+    Kokkos::View<int *, DeviceType> indices( "indices", 0 );
+    Kokkos::View<double *, DeviceType> values( "values", 0 );
+    ArchiveImpl::read( stream, offset );
+    ArchiveImpl::read( stream, ranks );
+    ArchiveImpl::read( stream, indices );
+    ArchiveImpl::read( stream, values );
+    ArchiveImpl::checkRead( _comm, stream );
+
+    // The communication plan is the only part that is recomputed.
+    Details::CommunicationPlan<DeviceType> plan( _comm, ranks, indices );
+    return Teuchos::rcp( new BasisOperator( _comm, plan, offset, ranks,
+                                            indices, values, domain_map,
+                                            range_map ) );
+}
 
-    crs_matrix->fillComplete( domain_map, range_map );
-    DTK_ENSURE( crs_matrix->isFillComplete() );
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::
+    saveBasisOperator( std::ostream &stream,
+                       BasisOperator const &basis_operator )
+{
+    using ArchiveImpl = Details::OperatorArchiveImpl<DeviceType>;
 
-    return crs_matrix;
+    ArchiveImpl::write( stream, basis_operator.getOffset() );
+    ArchiveImpl::write( stream, basis_operator.getRanks() );
+    ArchiveImpl::write( stream, basis_operator.getIndices() );
+    ArchiveImpl::write( stream, basis_operator.getValues() );
 }
 
 template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
@@ -141,10 +195,7 @@ SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
         Teuchos::RCP<const Map> domain_map, Teuchos::RCP<const Map> range_map,
         Kokkos::View<Coordinate const **, DeviceType> points )
 {
-    const int n = points.extent( 0 );
-    const int spatial_dim = points.extent( 1 );
-
-    DTK_REQUIRE( spatial_dim == 3 );
+    DTK_REQUIRE( points.extent_int( 1 ) == PolynomialBasis::dimension );
 
     auto v = Details::MovingLeastSquaresOperatorImpl<
         DeviceType>::computeVandermonde2( points, PolynomialBasis() );
@@ -160,19 +211,134 @@ SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
     SplineOperator(
         MPI_Comm comm,
         Kokkos::View<Coordinate const **, DeviceType> source_points,
-        Kokkos::View<Coordinate const **, DeviceType> target_points )
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        Teuchos::ParameterList const &parameters )
+    : SplineOperator( PointCloudSearchTree<DeviceType>( comm, source_points ),
+                      target_points, parameters )
+{
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+               PolynomialBasis>::
+    SplineOperator(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        Teuchos::ParameterList const &parameters )
+    : _comm( search_tree.getComm() )
+{
+    setup( search_tree, target_points, 0., parameters );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+               PolynomialBasis>::
+    SplineOperator(
+        PointCloudSearchTree<DeviceType> const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        double support_radius, Teuchos::ParameterList const &parameters )
+    : _comm( search_tree.getComm() )
+{
+    setup( search_tree, target_points,
+           support_radius > 0.
+               ? support_radius
+               : search_tree.estimateSupportRadius( PolynomialBasis::size ),
+           parameters );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+               PolynomialBasis>::
+    SplineOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        std::string const &prefix, Teuchos::ParameterList const &parameters )
     : _comm( comm )
 {
+    using ArchiveImpl = Details::OperatorArchiveImpl<DeviceType>;
+
     DTK_REQUIRE( source_points.extent_int( 1 ) ==
                  target_points.extent_int( 1 ) );
-    // FIXME for now let's assume 3D
-    DTK_REQUIRE( source_points.extent_int( 1 ) == 3 );
-    constexpr int spatial_dim = 3;
+    DTK_REQUIRE( source_points.extent_int( 1 ) ==
+                 PolynomialBasis::dimension );
+
+    _archive_header = ArchiveImpl::makeHeader(
+        _comm, typeid( SplineOperator ).name(), source_points, target_points );
+    auto stream = ArchiveImpl::openForReading( _comm, prefix, _archive_header );
+
+    setupPolynomialBlocks( source_points, target_points );
+    auto prolongation_map = S->getRangeMap();
+    M = loadBasisOperator( stream, prolongation_map, prolongation_map );
+    N = loadBasisOperator( stream, prolongation_map, Q->getRangeMap() );
+
+    setupSolver( source_points, parameters );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::save( std::string const &prefix ) const
+{
+    using ArchiveImpl = Details::OperatorArchiveImpl<DeviceType>;
+
+    auto stream = ArchiveImpl::openForWriting( _comm, prefix, _archive_header );
+    saveBasisOperator( stream, *M );
+    saveBasisOperator( stream, *N );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::
+    setup( PointCloudSearchTree<DeviceType> const &search_tree,
+           Kokkos::View<Coordinate const **, DeviceType> target_points,
+           double support_radius, Teuchos::ParameterList const &parameters )
+{
+    // The interpolation problem is posed on all the source points.
+    if ( search_tree.collapsesCoincidentPoints() )
+        throw DataTransferKitException(
+            "The spline operator cannot collapse coincident source points" );
+
+    auto source_points = search_tree.getSourcePoints();
+    DTK_REQUIRE( source_points.extent_int( 1 ) ==
+                 target_points.extent_int( 1 ) );
+    DTK_REQUIRE( source_points.extent_int( 1 ) ==
+                 PolynomialBasis::dimension );
 
     constexpr int knn = PolynomialBasis::size;
 
+    _archive_header = Details::OperatorArchiveImpl<DeviceType>::makeHeader(
+        _comm, typeid( SplineOperator ).name(), source_points, target_points );
+
+    // Step 0 and 1: build the maps and the matrices
+    setupPolynomialBlocks( source_points, target_points );
+    auto prolongation_map = S->getRangeMap();
+
+    // The same search tree over the source points is used for both M and N.
+    // NOTE: M is not the M from the paper, but an extended size block
+    // matrix
+    M = buildBasisOperator( prolongation_map, prolongation_map, search_tree,
+                            source_points, knn, support_radius );
+    N = buildBasisOperator( prolongation_map, Q->getRangeMap(), search_tree,
+                            target_points, knn, support_radius );
+
+    setupSolver( source_points, parameters );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::
+    setupPolynomialBlocks(
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points )
+{
     // Step 0: build source and target maps
-    auto teuchos_comm = Teuchos::rcp( new Teuchos::MpiComm<int>( comm ) );
+    auto teuchos_comm = Teuchos::rcp( new Teuchos::MpiComm<int>( _comm ) );
     auto source_map = Teuchos::rcp(
         new Map( Teuchos::OrdinalTraits<GO>::invalid(),
                  source_points.extent( 0 ), 0 /*indexBase*/, teuchos_comm ) );
@@ -180,25 +346,33 @@ SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
         new Map( Teuchos::OrdinalTraits<GO>::invalid(),
                  target_points.extent( 0 ), 0 /*indexBase*/, teuchos_comm ) );
 
-    // Step 1: build matrices
-    GO prolongation_offset = teuchos_comm->getRank() ? 0 : spatial_dim + 1;
+    // Step 1: build the polynomial matrices
+    // The first processor holds the coefficients of the polynomial.
+    GO prolongation_offset =
+        teuchos_comm->getRank() ? 0 : PolynomialBasis::size;
     S = Teuchos::rcp( new SplineProlongationOperator<SC, LO, GO, NO>(
         prolongation_offset, source_map ) );
     auto prolongation_map = S->getRangeMap();
 
-    // Build distributed search tree over the source points.
-    // NOTE: M is not the M from the paper, but an extended size block
-    // matrix
-    M = buildBasisOperator( prolongation_map, prolongation_map, source_points,
-                            source_points, knn );
     P = buildPolynomialOperator( prolongation_map, prolongation_map,
                                  source_points );
-    N = buildBasisOperator( prolongation_map, target_map, source_points,
-                            target_points, knn );
     Q = buildPolynomialOperator( prolongation_map, target_map, target_points );
+}
 
-    // Step 3: build Thyra operator: A = (Q + N)*[(P + M + P^T)^-1]*S
-    auto thyraWrapper = []( Teuchos::RCP<const Operator> &op ) {
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::
+    setupSolver( Kokkos::View<Coordinate const **, DeviceType> source_points,
+                 Teuchos::ParameterList const &parameters )
+{
+    auto prolongation_map = S->getRangeMap();
+
+    // Step 2: build the solver for the saddle point system C = (P + M + P^T).
+    // The operator is A = (Q + N)*[(P + M + P^T)^-1]*S but the solve is
+    // performed explicitly in apply() so that its initial guess can be
+    // controlled.
+    auto thyraWrapper = []( Teuchos::RCP<const Operator> const &op ) {
         auto thyra_range_vector_space =
             Thyra::createVectorSpace<SC>( op->getRangeMap() );
         auto thyra_domain_vector_space =
@@ -211,11 +385,8 @@ SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
         return thyra_op;
     };
 
-    auto thyra_S = thyraWrapper( S );
     auto thyra_M = thyraWrapper( M );
-    auto thyra_N = thyraWrapper( N );
     auto thyra_P = thyraWrapper( P );
-    auto thyra_Q = thyraWrapper( Q );
 
     // Create a transpose of P.
     Teuchos::RCP<const Thyra::LinearOpBase<SC>> thyra_P_T =
@@ -227,7 +398,14 @@ SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
     Teuchos::RCP<const Thyra::LinearOpBase<SC>> thyra_C =
         Thyra::add<SC>( thyra_PpM, thyra_P_T );
 
-    // Create parameters for stratimikos to setup the inverse operator.
+    // Create the transpose C^T = (P + M^T + P^T) for applyTranspose()
+    Teuchos::RCP<const Thyra::LinearOpBase<SC>> thyra_C_T = Thyra::add<SC>(
+        Thyra::add<SC>( thyra_P, Thyra::transpose<SC>( thyra_M ) ),
+        thyra_P_T );
+
+    // Create parameters for stratimikos to setup the solver. The
+    // preconditioner, if any, is built below and passed to the solver
+    // directly.
     auto d_stratimikos_list = Teuchos::parameterList( "Stratimikos" );
     d_stratimikos_list->set( "Linear Solver Type", "Belos" );
     d_stratimikos_list->set( "Preconditioner Type", "None" );
@@ -237,32 +415,112 @@ SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
     belos_list.set( "Solver Type", "Pseudo Block GMRES" );
     auto &solver_types_list = belos_list.sublist( "Solver Types" );
     auto &gmres_list = solver_types_list.sublist( "Pseudo Block GMRES" );
-    gmres_list.set( "Convergence Tolerance", 1e-10 );
+    gmres_list.set( "Convergence Tolerance",
+                    parameters.get( "Convergence Tolerance", 1e-10 ) );
     gmres_list.set( "Verbosity",
                     Belos::Errors + Belos::Warnings + Belos::TimingDetails +
                         Belos::FinalSummary + Belos::StatusTestDetails );
     gmres_list.set( "Output Frequency", 1 );
 
-    // Create the inverse of the composite operator C.
     Stratimikos::DefaultLinearSolverBuilder builder;
     builder.setParameterList( d_stratimikos_list );
     Teuchos::RCP<Thyra::LinearOpWithSolveFactoryBase<SC>> factory =
         Thyra::createLinearSolveStrategy( builder );
-    Teuchos::RCP<const Thyra::LinearOpBase<SC>> thyra_C_inv =
-        Thyra::inverse<SC>( *factory, thyra_C );
+    _solver = factory->createOp();
+    _transpose_solver = factory->createOp();
+    if ( parameters.get( "Preconditioner", true ) )
+    {
+        // The preconditioner is factored once here and reused by every
+        // solve. Its transpose preconditions the transposed system.
+        Teuchos::RCP<const Operator> preconditioner =
+            Teuchos::rcp( new SaddlePointPreconditioner<SC, LO, GO, NO>(
+                _comm, M->getOffset(), M->getRanks(), M->getIndices(),
+                M->getValues(),
+                Details::MovingLeastSquaresOperatorImpl<
+                    DeviceType>::computeVandermonde2( source_points,
+                                                      PolynomialBasis() ),
+                prolongation_map ) );
+        auto thyra_preconditioner = thyraWrapper( preconditioner );
+        Thyra::initializePreconditionedOp<SC>(
+            *factory, thyra_C,
+            Thyra::unspecifiedPrec<SC>( thyra_preconditioner ),
+            _solver.ptr() );
+        Thyra::initializePreconditionedOp<SC>(
+            *factory, thyra_C_T,
+            Thyra::unspecifiedPrec<SC>(
+                Thyra::transpose<SC>( thyra_preconditioner ) ),
+            _transpose_solver.ptr() );
+    }
+    else
+    {
+        Thyra::initializeOp<SC>( *factory, thyra_C, _solver.ptr() );
+        Thyra::initializeOp<SC>( *factory, thyra_C_T,
+                                 _transpose_solver.ptr() );
+    }
+    DTK_ENSURE( Teuchos::nonnull( _solver ) );
+    DTK_ENSURE( Teuchos::nonnull( _transpose_solver ) );
 
-    // Create the composite operator B = (Q + N);
-    Teuchos::RCP<const Thyra::LinearOpBase<SC>> thyra_B =
-        Thyra::add<SC>( thyra_Q, thyra_N );
+    _warm_start = parameters.get( "Warm Start", false );
+}
 
-    // Create the coupling matrix A = (B * C^-1 * S).
-    _thyra_operator = Thyra::multiply<SC>( thyra_B, thyra_C_inv, thyra_S );
-    DTK_ENSURE( Teuchos::nonnull( _thyra_operator ) );
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::solve( Vector const &source,
+                                             Vector &destination ) const
+{
+    int const n_fields = source.getNumVectors();
+
+    // Right-hand side of the saddle point system.
+    auto rhs = Teuchos::rcp( new Vector( S->getRangeMap(), n_fields ) );
+    S->apply( source, *rhs );
+
+    // Each field is a column of the multivectors. The Krylov solver handles
+    // them as a block of right-hand sides. The coefficients computed by the
+    // previous solve are the initial guess with warm start.
+    if ( _coefficients.is_null() ||
+         static_cast<int>( _coefficients->getNumVectors() ) != n_fields )
+        _coefficients =
+            Teuchos::rcp( new Vector( S->getRangeMap(), n_fields ) );
+    else if ( !_warm_start )
+        _coefficients->putScalar( 0. );
+    Thyra::solve<SC>(
+        *_solver, Thyra::NOTRANS,
+        *Thyra::createConstMultiVector<SC>( Teuchos::RCP<const Vector>( rhs ) ),
+        Thyra::createMultiVector<SC>( _coefficients ).ptr() );
+
+    // Evaluate the spline at the target points.
+    Q->apply( *_coefficients, destination );
+    N->apply( *_coefficients, destination, Teuchos::NO_TRANS, 1., 1. );
+}
 
-    _source = Teuchos::rcp( new Vector( S->getDomainMap(), 1 ) );
-    _destination = Teuchos::rcp( new Vector( N->getRangeMap(), 1 ) );
-    _thyra_X = Thyra::createMultiVector<SC>( _source );
-    _thyra_Y = Thyra::createMultiVector<SC>( _destination );
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::
+    solveTranspose( Vector const &target, Vector &destination ) const
+{
+    int const n_fields = target.getNumVectors();
+
+    // Right-hand side of the transposed saddle point system.
+    auto rhs = Teuchos::rcp( new Vector( S->getRangeMap(), n_fields ) );
+    Q->apply( target, *rhs, Teuchos::TRANS );
+    N->apply( target, *rhs, Teuchos::TRANS, 1., 1. );
+
+    if ( _transpose_coefficients.is_null() ||
+         static_cast<int>( _transpose_coefficients->getNumVectors() ) !=
+             n_fields )
+        _transpose_coefficients =
+            Teuchos::rcp( new Vector( S->getRangeMap(), n_fields ) );
+    else if ( !_warm_start )
+        _transpose_coefficients->putScalar( 0. );
+    Thyra::solve<SC>(
+        *_transpose_solver, Thyra::NOTRANS,
+        *Thyra::createConstMultiVector<SC>( Teuchos::RCP<const Vector>( rhs ) ),
+        Thyra::createMultiVector<SC>( _transpose_coefficients ).ptr() );
+
+    // Drop the polynomial coefficients.
+    S->apply( *_transpose_coefficients, destination, Teuchos::TRANS );
 }
 
 template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
@@ -278,21 +536,93 @@ void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
     DTK_REQUIRE( target_values.extent( 0 ) ==
                  N->getRangeMap()->getNodeNumElements() );
 
-    auto domain_map = S->getDomainMap();
-    auto range_map = N->getRangeMap();
-
-    auto source = Teuchos::rcp( new Vector( domain_map, 1 ) );
-    auto destination = Teuchos::rcp( new Vector( range_map, 1 ) );
+    Vector source( S->getDomainMap(), 1 );
+    Vector destination( N->getRangeMap(), 1 );
 
     Kokkos::deep_copy(
-        Kokkos::subview( _source->getLocalViewDevice(), Kokkos::ALL, 0 ),
+        Kokkos::subview( source.getLocalViewDevice(), Kokkos::ALL, 0 ),
         source_values );
 
-    _thyra_operator->apply( Thyra::NOTRANS, *_thyra_X, _thyra_Y.ptr(), 1, 0 );
+    solve( source, destination );
 
     Kokkos::deep_copy(
         target_values,
-        Kokkos::subview( _destination->getLocalViewDevice(), Kokkos::ALL, 0 ) );
+        Kokkos::subview( destination.getLocalViewDevice(), Kokkos::ALL, 0 ) );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::
+    apply( Kokkos::View<double const **, DeviceType> source_values,
+           Kokkos::View<double **, DeviceType> target_values ) const
+{
+    // Precondition: check that the source and the target are properly sized
+    DTK_REQUIRE( source_values.extent( 0 ) ==
+                 S->getDomainMap()->getNodeNumElements() );
+    DTK_REQUIRE( target_values.extent( 0 ) ==
+                 N->getRangeMap()->getNodeNumElements() );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    int const n_fields = source_values.extent( 1 );
+    Vector source( S->getDomainMap(), n_fields );
+    Vector destination( N->getRangeMap(), n_fields );
+
+    Kokkos::deep_copy( source.getLocalViewDevice(), source_values );
+
+    solve( source, destination );
+
+    Kokkos::deep_copy( target_values, destination.getLocalViewDevice() );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::
+    applyTranspose( Kokkos::View<double const *, DeviceType> target_values,
+                    Kokkos::View<double *, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( source_values.extent( 0 ) ==
+                 S->getDomainMap()->getNodeNumElements() );
+    DTK_REQUIRE( target_values.extent( 0 ) ==
+                 N->getRangeMap()->getNodeNumElements() );
+
+    Vector target( N->getRangeMap(), 1 );
+    Vector destination( S->getDomainMap(), 1 );
+
+    Kokkos::deep_copy(
+        Kokkos::subview( target.getLocalViewDevice(), Kokkos::ALL, 0 ),
+        target_values );
+
+    solveTranspose( target, destination );
+
+    Kokkos::deep_copy(
+        source_values,
+        Kokkos::subview( destination.getLocalViewDevice(), Kokkos::ALL, 0 ) );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                    PolynomialBasis>::
+    applyTranspose( Kokkos::View<double const **, DeviceType> target_values,
+                    Kokkos::View<double **, DeviceType> source_values ) const
+{
+    DTK_REQUIRE( source_values.extent( 0 ) ==
+                 S->getDomainMap()->getNodeNumElements() );
+    DTK_REQUIRE( target_values.extent( 0 ) ==
+                 N->getRangeMap()->getNodeNumElements() );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    int const n_fields = target_values.extent( 1 );
+    Vector target( N->getRangeMap(), n_fields );
+    Vector destination( S->getDomainMap(), n_fields );
+
+    Kokkos::deep_copy( target.getLocalViewDevice(), target_values );
+
+    solveTranspose( target, destination );
+
+    Kokkos::deep_copy( source_values, destination.getLocalViewDevice() );
 }
 
 } // end namespace DataTransferKit
@@ -300,6 +630,8 @@ void SplineOperator<DeviceType, CompactlySupportedRadialBasisFunction,
 // Explicit instantiation macro
 #define DTK_SPLINE_OPERATOR_INSTANT( NODE )                                    \
     template class SplineOperator<typename NODE::device_type, Wendland<0>,     \
-                                  MultivariatePolynomialBasis<Linear, 3>>;
+                                  MultivariatePolynomialBasis<Linear, 3>>;     \
+    template class SplineOperator<typename NODE::device_type, Wendland<0>,     \
+                                  MultivariatePolynomialBasis<Linear, 2>>;
 
 #endif
@@ -49,6 +49,41 @@ void check_polynomial( boost::math::tools::polynomial<double> const &poly,
     TEST_COMPARE_FLOATING_ARRAYS( v_host, values, relative_tolerance );
 }
 
+template <typename DeviceType, typename RBF>
+void check_batch( RBF const &, Teuchos::FancyOStream &out, bool &success )
+{
+    // Evaluate the function at rows of distances, in one call per row and
+    // one call per distance.
+    using ExecutionSpace = typename DeviceType::execution_space;
+    int const n_rows = 4;
+    int const n_cols = 7;
+    int const n = n_rows * n_cols;
+    Kokkos::View<double *, DeviceType> r( "radii", n );
+    auto r_host = Kokkos::create_mirror_view( r );
+    for ( int i = 0; i < n; ++i )
+        r_host( i ) = .1 + 2.5 * i / n;
+    Kokkos::deep_copy( r, r_host );
+
+    DataTransferKit::RadialBasisFunction<RBF> rbf( 3. );
+    Kokkos::View<double *, DeviceType> v( "values", n );
+    Kokkos::View<double *, DeviceType> v_ref( "values_ref", n );
+    Kokkos::parallel_for( "evaluate",
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_rows ),
+                          KOKKOS_LAMBDA( int i ) {
+                              rbf( &r( i * n_cols ), &v( i * n_cols ),
+                                   n_cols );
+                              for ( int j = i * n_cols; j < ( i + 1 ) * n_cols;
+                                    ++j )
+                                  v_ref( j ) = rbf( r( j ) );
+                          } );
+    Kokkos::fence();
+    auto v_host =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, v );
+    auto v_ref_host =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, v_ref );
+    TEST_COMPARE_FLOATING_ARRAYS( v_host, v_ref_host, 1e-14 );
+}
+
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( CompactlySupportedRadialBasisFunctions,
                                    polynomial_rbf, DeviceType )
 {
@@ -107,6 +142,21 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( CompactlySupportedRadialBasisFunctions,
     TEST_EQUALITY( rbf( 4. ), 2. );
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( CompactlySupportedRadialBasisFunctions,
+                                   batch_rbf, DeviceType )
+{
+    using namespace DataTransferKit;
+    check_batch<DeviceType>( Wendland<0>(), out, success );
+    check_batch<DeviceType>( Wendland<2>(), out, success );
+    check_batch<DeviceType>( Wendland<4>(), out, success );
+    check_batch<DeviceType>( Wendland<6>(), out, success );
+    check_batch<DeviceType>( Wu<2>(), out, success );
+    check_batch<DeviceType>( Wu<4>(), out, success );
+    check_batch<DeviceType>( Buhmann<2>(), out, success );
+    check_batch<DeviceType>( Buhmann<3>(), out, success );
+    check_batch<DeviceType>( Buhmann<4>(), out, success );
+}
+
 // Include the test macros.
 #include "DataTransferKit_ETIHelperMacros.h"
 
@@ -117,7 +167,9 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( CompactlySupportedRadialBasisFunctions,
         CompactlySupportedRadialBasisFunctions, polynomial_rbf,                \
         DeviceType##NODE )                                                     \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
-        CompactlySupportedRadialBasisFunctions, wrap_rbf, DeviceType##NODE )
+        CompactlySupportedRadialBasisFunctions, wrap_rbf, DeviceType##NODE )   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
+        CompactlySupportedRadialBasisFunctions, batch_rbf, DeviceType##NODE )
 // Demangle the types
 DTK_ETI_MANGLING_TYPEDEFS()
 
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * Copyright (c) 2012-2020 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <DTK_DetailsBasisMatrix.hpp>
+#include <DTK_DetailsCommunicationPlan.hpp>
+
+#include <Teuchos_Array.hpp>
+#include <Teuchos_DefaultMpiComm.hpp>
+#include <Teuchos_UnitTestHarness.hpp>
+
+#include <Tpetra_Map.hpp>
+#include <Tpetra_MultiVector.hpp>
+
+#include <vector>
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsBasisMatrix,
+                                   matrix_free_and_assembled, Node )
+{
+    // Check that the matrix-free operator and the assembled matrix give the
+    // same result as a product computed by hand.
+    using DeviceType = typename Node::device_type;
+    using SC = double;
+    using LO = int;
+    using GO = long long;
+    using Map = Tpetra::Map<LO, GO, Node>;
+    using MultiVector = Tpetra::MultiVector<SC, LO, GO, Node>;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    // Processor r owns 5 + r points.
+    auto n_points = [&]( int r ) { return 5 + r; };
+    std::vector<GO> first_global_index( comm_size + 1, 0 );
+    for ( int r = 0; r < comm_size; ++r )
+        first_global_index[r + 1] = first_global_index[r] + n_points( r );
+    int const n = n_points( comm_rank );
+
+    auto teuchos_comm = Teuchos::rcp( new Teuchos::MpiComm<int>( comm ) );
+    auto map = Teuchos::rcp(
+        new Map( Teuchos::OrdinalTraits<Tpetra::global_size_t>::invalid(), n,
+                 0, teuchos_comm ) );
+
+    // The i-th point has three neighbors: the i-th point on this processor,
+    // the first point on the next processor, and the i-th point on the
+    // previous processor.
+    int const next = ( comm_rank + 1 ) % comm_size;
+    int const previous = ( comm_rank + comm_size - 1 ) % comm_size;
+    Kokkos::View<int *, DeviceType> offset( "offset", n + 1 );
+    Kokkos::View<int *, DeviceType> ranks( "ranks", 3 * n );
+    Kokkos::View<int *, DeviceType> indices( "indices", 3 * n );
+    Kokkos::View<double *, DeviceType> values( "values", 3 * n );
+    auto offset_host = Kokkos::create_mirror_view( offset );
+    auto ranks_host = Kokkos::create_mirror_view( ranks );
+    auto indices_host = Kokkos::create_mirror_view( indices );
+    auto values_host = Kokkos::create_mirror_view( values );
+    for ( int i = 0; i < n; ++i )
+    {
+        offset_host( i ) = 3 * i;
+        ranks_host( 3 * i ) = comm_rank;
+        indices_host( 3 * i ) = i;
+        ranks_host( 3 * i + 1 ) = next;
+        indices_host( 3 * i + 1 ) = 0;
+        ranks_host( 3 * i + 2 ) = previous;
+        indices_host( 3 * i + 2 ) = i % n_points( previous );
+        for ( int l = 0; l < 3; ++l )
+            values_host( 3 * i + l ) = 1. + i + .1 * l;
+    }
+    offset_host( n ) = 3 * n;
+    Kokkos::deep_copy( offset, offset_host );
+    Kokkos::deep_copy( ranks, ranks_host );
+    Kokkos::deep_copy( indices, indices_host );
+    Kokkos::deep_copy( values, values_host );
+
+    DataTransferKit::BasisMatrix<SC, LO, GO, Node> basis_matrix(
+        comm, DataTransferKit::Details::CommunicationPlan<DeviceType>(
+                  comm, ranks, indices ),
+        offset, ranks, indices, values, map, map );
+
+    // Two vectors: x = gid + 1 and x = 2 * gid.
+    int const num_vec = 2;
+    std::vector<SC> x( n * num_vec );
+    for ( int i = 0; i < n; ++i )
+    {
+        GO const gid = first_global_index[comm_rank] + i;
+        x[i] = gid + 1.;
+        x[n + i] = 2. * gid;
+    }
+    MultiVector X( map, Teuchos::ArrayView<SC const>( x ), n, num_vec );
+
+    // y = 3 * 1 + 2 * A * x
+    double const alpha = 2.;
+    double const beta = 3.;
+    std::vector<SC> y_ref( n * num_vec );
+    for ( int i = 0; i < n; ++i )
+        for ( int k = 0; k < num_vec; ++k )
+        {
+            double sum = 0.;
+            for ( int j = offset_host( i ); j < offset_host( i + 1 ); ++j )
+            {
+                GO const gid =
+                    first_global_index[ranks_host( j )] + indices_host( j );
+                sum += values_host( j ) * ( k == 0 ? gid + 1. : 2. * gid );
+            }
+            y_ref[k * n + i] = beta + alpha * sum;
+        }
+
+    MultiVector Y( map, num_vec );
+    Y.putScalar( 1. );
+    basis_matrix.apply( X, Y, Teuchos::NO_TRANS, alpha, beta );
+    std::vector<SC> y( n * num_vec );
+    Y.get1dCopy( Teuchos::ArrayView<SC>( y ), n );
+    TEST_COMPARE_FLOATING_ARRAYS( y, y_ref, 1e-14 );
+
+    auto crs_matrix = basis_matrix.buildCrsMatrix();
+    TEST_EQUALITY( crs_matrix->getNodeNumEntries(),
+                   static_cast<size_t>( 3 * n ) );
+    Y.putScalar( 1. );
+    crs_matrix->apply( X, Y, Teuchos::NO_TRANS, alpha, beta );
+    Y.get1dCopy( Teuchos::ArrayView<SC>( y ), n );
+    TEST_COMPARE_FLOATING_ARRAYS( y, y_ref, 1e-14 );
+}
+
+// Include the test macros.
+#include "DataTransferKit_ETIHelperMacros.h"
+
+// Create the test group
+#define UNIT_TEST_GROUP( NODE )                                                \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( DetailsBasisMatrix,                  \
+                                          matrix_free_and_assembled, NODE )
+
+// Demangle the types
+DTK_ETI_MANGLING_TYPEDEFS()
+
+// Instantiate the tests
+DTK_INSTANTIATE_N( UNIT_TEST_GROUP )
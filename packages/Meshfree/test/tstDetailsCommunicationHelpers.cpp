@@ -10,6 +10,7 @@
  ****************************************************************************/
 
 #include <ArborX.hpp>
+#include <DTK_DetailsCommunicationPlan.hpp>
 #include <DTK_DetailsNearestNeighborOperatorImpl.hpp> // fetch
 
 #include <Teuchos_Array.hpp>
@@ -86,6 +87,25 @@ struct Helper
 
         TEST_COMPARE_ARRAYS( toArray( v_imp ), toArray( v_ref ) );
     }
+
+    template <typename View1, typename View2>
+    static void checkPlan( MPI_Comm comm, View1 const &ranks,
+                           View1 const &indices, View2 const &v_exp,
+                           View2 const &v_ref, bool &success,
+                           Teuchos::FancyOStream &out )
+    {
+        DataTransferKit::Details::CommunicationPlan<DeviceType> plan(
+            comm, ranks, indices );
+
+        // The plan is meant to be reused so make sure that fetching several
+        // times gives the same result.
+        for ( int k = 0; k < 2; ++k )
+        {
+            auto v_imp = plan.fetch( v_exp );
+
+            TEST_COMPARE_ARRAYS( toArray( v_imp ), toArray( v_ref ) );
+        }
+    }
 };
 
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsDistributedSearchTreeImpl,
@@ -220,6 +240,278 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsNearestNeighborOperatorImpl, fetch,
 
     Helper<DeviceType>::checkFetch( comm, ranks, indices, w_exp, w_ref, success,
                                     out );
+
+    Helper<DeviceType>::checkPlan( comm, ranks, indices, v_exp, v_ref, success,
+                                   out );
+    Helper<DeviceType>::checkPlan( comm, ranks, indices, w_exp, w_ref, success,
+                                   out );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsCommunicationPlan, many_to_one,
+                                   DeviceType )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    // Every processor requests all the values owned by all the processors in
+    // reverse order, including the ones it owns.
+    int const n = 3;
+    int const n_requests = n * comm_size;
+    Kokkos::View<int *, DeviceType> indices( "indices", n_requests );
+    Kokkos::View<int *, DeviceType> ranks( "ranks", n_requests );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_requests ),
+                          KOKKOS_LAMBDA( int i ) {
+                              int const j = n_requests - 1 - i;
+                              ranks( i ) = j / n;
+                              indices( i ) = j % n;
+                          } );
+    Kokkos::fence();
+
+    Kokkos::View<double *, DeviceType> v_exp( "v", n );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+                          KOKKOS_LAMBDA( int i ) {
+                              v_exp( i ) = 10. * comm_rank + i;
+                          } );
+    Kokkos::fence();
+
+    Kokkos::View<double *, DeviceType> v_ref( "v_ref", n_requests );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_requests ),
+                          KOKKOS_LAMBDA( int i ) {
+                              v_ref( i ) = 10. * ranks( i ) + indices( i );
+                          } );
+    Kokkos::fence();
+
+    Helper<DeviceType>::checkPlan( comm, ranks, indices, v_exp, v_ref, success,
+                                   out );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsCommunicationPlan, duplicates,
+                                   DeviceType )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    // Every processor requests three times the first value owned by each
+    // processor and twice the second value owned by the next processor.
+    int const n = 2;
+    int const next = ( comm_rank + 1 ) % comm_size;
+    int const n_requests = 3 * comm_size + 2;
+    Kokkos::View<int *, DeviceType> indices( "indices", n_requests );
+    Kokkos::View<int *, DeviceType> ranks( "ranks", n_requests );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_requests ),
+                          KOKKOS_LAMBDA( int i ) {
+                              if ( i < 3 * comm_size )
+                              {
+                                  ranks( i ) = i % comm_size;
+                                  indices( i ) = 0;
+                              }
+                              else
+                              {
+                                  ranks( i ) = next;
+                                  indices( i ) = 1;
+                              }
+                          } );
+    Kokkos::fence();
+
+    // Each value is transferred only once.
+    DataTransferKit::Details::CommunicationPlan<DeviceType> plan( comm, ranks,
+                                                                  indices );
+    TEST_EQUALITY( plan.getNumberOfRequests(), n_requests );
+    TEST_EQUALITY( plan.getNumberOfImports(), comm_size + 1 );
+    TEST_EQUALITY( plan.getNumberOfExports(), comm_size + 1 );
+
+    Kokkos::View<double *, DeviceType> v_exp( "v", n );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+                          KOKKOS_LAMBDA( int i ) {
+                              v_exp( i ) = 10. * comm_rank + i;
+                          } );
+    Kokkos::fence();
+
+    Kokkos::View<double *, DeviceType> v_ref( "v_ref", n_requests );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_requests ),
+                          KOKKOS_LAMBDA( int i ) {
+                              v_ref( i ) = 10. * ranks( i ) + indices( i );
+                          } );
+    Kokkos::fence();
+
+    Helper<DeviceType>::checkPlan( comm, ranks, indices, v_exp, v_ref, success,
+                                   out );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsCommunicationPlan, reuse,
+                                   DeviceType )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    // Every processor requests all the values owned by all the processors.
+    // The same plan fetches values of different types and numbers of
+    // components, and several fetches are in flight at the same time.
+    int const n = 4;
+    int const n_requests = n * comm_size;
+    Kokkos::View<int *, DeviceType> indices( "indices", n_requests );
+    Kokkos::View<int *, DeviceType> ranks( "ranks", n_requests );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_requests ),
+                          KOKKOS_LAMBDA( int i ) {
+                              ranks( i ) = i / n;
+                              indices( i ) = i % n;
+                          } );
+    Kokkos::fence();
+
+    DataTransferKit::Details::CommunicationPlan<DeviceType> plan( comm, ranks,
+                                                                  indices );
+
+    int const n_components = 3;
+    Kokkos::View<double *, DeviceType> v( "v", n );
+    Kokkos::View<double **, DeviceType> w( "w", n, n_components );
+    Kokkos::View<float *, DeviceType> x( "x", n );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+                          KOKKOS_LAMBDA( int i ) {
+                              v( i ) = 10. * comm_rank + i;
+                              for ( int j = 0; j < n_components; ++j )
+                                  w( i, j ) = 100. * comm_rank + 10. * i + j;
+                              x( i ) = -v( i );
+                          } );
+    Kokkos::fence();
+
+    Kokkos::View<double *, DeviceType> v_ref( "v_ref", n_requests );
+    Kokkos::View<double **, DeviceType> w_ref( "w_ref", n_requests,
+                                               n_components );
+    Kokkos::View<float *, DeviceType> x_ref( "x_ref", n_requests );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_requests ),
+                          KOKKOS_LAMBDA( int i ) {
+                              v_ref( i ) = 10. * ranks( i ) + indices( i );
+                              for ( int j = 0; j < n_components; ++j )
+                                  w_ref( i, j ) = 100. * ranks( i ) +
+                                                  10. * indices( i ) + j;
+                              x_ref( i ) = -v_ref( i );
+                          } );
+    Kokkos::fence();
+
+    auto v_fetched = plan.fetch( v );
+    TEST_COMPARE_ARRAYS( toArray( v_fetched ), toArray( v_ref ) );
+    auto w_fetched = plan.fetch( w );
+    TEST_COMPARE_ARRAYS( toArray( w_fetched ), toArray( w_ref ) );
+    auto x_fetched = plan.fetch( x );
+    TEST_COMPARE_ARRAYS( toArray( x_fetched ), toArray( x_ref ) );
+
+    auto pending_v = plan.fetchBegin( v );
+    auto pending_w = plan.fetchBegin( w );
+    auto pending_x = plan.fetchBegin( x );
+    // The values may be modified once the fetch started.
+    Kokkos::deep_copy( v, -1. );
+    Kokkos::deep_copy( w, -1. );
+    Kokkos::deep_copy( x, -1.f );
+    Kokkos::View<double *, DeviceType> v_imp( "v_imp", n_requests );
+    Kokkos::View<double **, DeviceType> w_imp( "w_imp", n_requests,
+                                               n_components );
+    Kokkos::View<float *, DeviceType> x_imp( "x_imp", n_requests );
+    plan.fetchEnd( pending_x, x_imp );
+    plan.fetchEnd( pending_w, w_imp );
+    plan.fetchEnd( pending_v, v_imp );
+    TEST_COMPARE_ARRAYS( toArray( v_imp ), toArray( v_ref ) );
+    TEST_COMPARE_ARRAYS( toArray( w_imp ), toArray( w_ref ) );
+    TEST_COMPARE_ARRAYS( toArray( x_imp ), toArray( x_ref ) );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsCommunicationPlan, fetch_subset,
+                                   DeviceType )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    // Every processor requests all the values owned by all the processors but
+    // only retrieves, in reverse order, the ones owned by the next processor
+    // and then again the first one. The last processor retrieves nothing.
+    int const n = 3;
+    int const n_requests = n * comm_size;
+    int const next = ( comm_rank + 1 ) % comm_size;
+    Kokkos::View<int *, DeviceType> indices( "indices", n_requests );
+    Kokkos::View<int *, DeviceType> ranks( "ranks", n_requests );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_requests ),
+                          KOKKOS_LAMBDA( int i ) {
+                              ranks( i ) = i / n;
+                              indices( i ) = i % n;
+                          } );
+    Kokkos::fence();
+
+    DataTransferKit::Details::CommunicationPlan<DeviceType> plan( comm, ranks,
+                                                                  indices );
+
+    int const n_selected = comm_rank < comm_size - 1 ? n + 1 : 0;
+    Kokkos::View<int *, DeviceType> requests( "requests", n_selected );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_selected ),
+                          KOKKOS_LAMBDA( int i ) {
+                              requests( i ) =
+                                  i < n ? next * n + n - 1 - i : 0;
+                          } );
+    Kokkos::fence();
+
+    int const n_components = 2;
+    Kokkos::View<double *, DeviceType> v( "v", n );
+    Kokkos::View<double **, DeviceType> w( "w", n, n_components );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+                          KOKKOS_LAMBDA( int i ) {
+                              v( i ) = 10. * comm_rank + i;
+                              for ( int j = 0; j < n_components; ++j )
+                                  w( i, j ) = 100. * comm_rank + 10. * i + j;
+                          } );
+    Kokkos::fence();
+
+    Kokkos::View<double *, DeviceType> v_ref( "v_ref", n_selected );
+    Kokkos::View<double **, DeviceType> w_ref( "w_ref", n_selected,
+                                               n_components );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_selected ),
+                          KOKKOS_LAMBDA( int i ) {
+                              int const k = requests( i );
+                              v_ref( i ) = 10. * ranks( k ) + indices( k );
+                              for ( int j = 0; j < n_components; ++j )
+                                  w_ref( i, j ) = 100. * ranks( k ) +
+                                                  10. * indices( k ) + j;
+                          } );
+    Kokkos::fence();
+
+    // A fetch of all the values is in flight at the same time.
+    auto pending = plan.fetchBegin( v );
+    auto v_fetched = plan.fetchSubset( v, requests );
+    TEST_COMPARE_ARRAYS( toArray( v_fetched ), toArray( v_ref ) );
+    auto w_fetched = plan.fetchSubset( w, requests );
+    TEST_COMPARE_ARRAYS( toArray( w_fetched ), toArray( w_ref ) );
+    Kokkos::View<double *, DeviceType> v_all( "v_all", n_requests );
+    plan.fetchEnd( pending, v_all );
+    auto v_all_ref = plan.fetch( v );
+    TEST_COMPARE_ARRAYS( toArray( v_all ), toArray( v_all_ref ) );
+
+    // So is push(). Every processor requested every value once.
+    pending = plan.fetchBegin( v );
+    Kokkos::View<double *, DeviceType> ones( "ones", n_requests );
+    Kokkos::deep_copy( ones, 1. );
+    Kokkos::View<double *, DeviceType> counts( "counts", n );
+    plan.push( ones, counts );
+    plan.fetchEnd( pending, v_all );
+    TEST_COMPARE_ARRAYS( toArray( v_all ), toArray( v_all_ref ) );
+    Teuchos::Array<double> counts_ref( n, comm_size );
+    TEST_COMPARE_ARRAYS( toArray( counts ), counts_ref );
 }
 
 // Include the test macros.
@@ -232,7 +524,15 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsNearestNeighborOperatorImpl, fetch,
                                           send_across_network,                 \
                                           DeviceType##NODE )                   \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( DetailsNearestNeighborOperatorImpl,  \
-                                          fetch, DeviceType##NODE )
+                                          fetch, DeviceType##NODE )            \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( DetailsCommunicationPlan,            \
+                                          many_to_one, DeviceType##NODE )      \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( DetailsCommunicationPlan,            \
+                                          duplicates, DeviceType##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( DetailsCommunicationPlan, reuse,     \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( DetailsCommunicationPlan,            \
+                                          fetch_subset, DeviceType##NODE )
 
 // Demangle the types
 DTK_ETI_MANGLING_TYPEDEFS()
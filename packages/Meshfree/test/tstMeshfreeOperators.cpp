@@ -12,17 +12,21 @@
 #include <Teuchos_UnitTestHarness.hpp>
 
 #include <DTK_DBC.hpp> // DataTransferKitException
+#include <DTK_DetailsCoincidentPoints.hpp>
 #include <DTK_MovingLeastSquaresOperator_decl.hpp>
 #include <DTK_MovingLeastSquaresOperator_def.hpp>
+#include <DTK_OperatorComposition.hpp>
 #include <DTK_SplineOperator_decl.hpp>
 #include <DTK_SplineOperator_def.hpp>
 #include <Kokkos_Core.hpp>
 
 #include <array>
 #include <cmath>
+#include <cstdio>
 #include <memory>
 #include <numeric>
 #include <random>
+#include <string>
 #include <vector>
 
 int constexpr DIM = 3;
@@ -125,6 +129,47 @@ struct Helper
 
         return grid_points;
     }
+
+    // Grid of 10 x 10 x 2 source points in the slab of processor @param rank,
+    // i.e. between z = 2 * rank and z = 2 * rank + 1.
+    static std::vector<std::array<double, DIM>> makeSlabSourcePoints( int rank )
+    {
+        return makeGridPoints( {{10, 10, 2}}, {{0., 0., 2. * rank}} );
+    }
+
+    // Grid of @param n_points target points in the slab of processor
+    // @param rank, between the source points, starting at (x, y).
+    static std::vector<std::array<double, DIM>>
+    makeSlabTargetPoints( int rank, std::array<int, DIM> const &n_points,
+                          double x, double y )
+    {
+        return makeGridPoints( n_points, {{x, y, 2. * rank + .5}} );
+    }
+
+    // Values of a smooth function at @param points.
+    static Kokkos::View<double *, DeviceType>
+    makeSmoothValues( std::vector<std::array<double, DIM>> const &points )
+    {
+        int const n = points.size();
+        std::vector<double> values( n );
+        for ( int i = 0; i < n; ++i )
+            values[i] = std::cos( points[i][0] ) + points[i][1] * points[i][2];
+        return makeValues( values );
+    }
+
+    // Check that @param values match the baseline @param values_ref.
+    static void
+    compareValues( Kokkos::View<double const *, DeviceType> values,
+                   Kokkos::View<double const *, DeviceType> values_ref,
+                   double tolerance, bool &success, Teuchos::FancyOStream &out )
+    {
+        auto values_host =
+            Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, values );
+        auto values_ref_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{}, values_ref );
+        TEST_COMPARE_FLOATING_ARRAYS( values_host, values_ref_host,
+                                      tolerance );
+    }
 };
 
 TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, same_npoints_and_basis,
@@ -447,6 +492,1239 @@ TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, single_point_in_radius,
         TEST_ASSERT( std::isfinite( target_values_host[i] ) );
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, multiple_fields,
+                                   OperatorType, Operator )
+{
+    // Check that transferring several fields at once gives the same result as
+    // transferring them one at a time.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    std::array<int, DIM> n_source_points_grid = {10, 10, 2};
+    std::array<double, DIM> offset = {0., 0., 2. * comm_rank};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+
+    std::array<int, DIM> n_target_points_grid = {3, 3, 1};
+    offset = {3.5, 3.5, 2. * comm_rank + .5};
+    auto target_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+
+    int const n_source_points = source_points_arr.size();
+    int const n_target_points = target_points_arr.size();
+    int const n_fields = 3;
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    Operator op( comm, source_points, target_points );
+
+    Kokkos::View<double **, DeviceType> source_values( "source_values",
+                                                       n_source_points,
+                                                       n_fields );
+    auto source_values_host = Kokkos::create_mirror_view( source_values );
+    for ( int i = 0; i < n_source_points; ++i )
+    {
+        auto const &p = source_points_arr[i];
+        source_values_host( i, 0 ) = 1.;
+        source_values_host( i, 1 ) = p[0] - 2 * p[1] + 3 * p[2];
+        source_values_host( i, 2 ) = std::sin( p[0] ) * std::cos( p[1] );
+    }
+    Kokkos::deep_copy( source_values, source_values_host );
+
+    Kokkos::View<double **, DeviceType> target_values( "target_values",
+                                                       n_target_points,
+                                                       n_fields );
+    op.apply( source_values, target_values );
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+
+    // The Krylov solver of the spline operator iterates on all the fields
+    // together so the results only agree up to the solver tolerance.
+    double eps = 0.0;
+    if ( std::is_same<OperatorType, MLS>{} )
+        eps = 1e-14;
+    else if ( std::is_same<OperatorType, Spline>{} )
+        eps = 1e-9;
+
+    for ( int k = 0; k < n_fields; ++k )
+    {
+        Kokkos::View<double *, DeviceType> source_field( "source_field",
+                                                         n_source_points );
+        Kokkos::deep_copy( source_field,
+                           Kokkos::subview( source_values, Kokkos::ALL, k ) );
+        Kokkos::View<double *, DeviceType> target_field( "target_field",
+                                                         n_target_points );
+        op.apply( source_field, target_field );
+        auto target_field_host = Kokkos::create_mirror_view( target_field );
+        Kokkos::deep_copy( target_field_host, target_field );
+
+        std::vector<double> target_field_ref( n_target_points );
+        for ( int i = 0; i < n_target_points; ++i )
+            target_field_ref[i] = target_values_host( i, k );
+        TEST_COMPARE_FLOATING_ARRAYS( target_field_host, target_field_ref,
+                                      eps );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, split_phase,
+                                   OperatorType, Operator )
+{
+    // Check that applyBegin() followed by applyEnd() gives the same result as
+    // apply() even if the source values change in between.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    auto source_points_arr =
+        Helper<DeviceType>::makeSlabSourcePoints( comm_rank );
+    auto target_points_arr = Helper<DeviceType>::makeSlabTargetPoints(
+        comm_rank, {{3, 3, 1}}, 3.5, 3.5 );
+    int const n_target_points = target_points_arr.size();
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+    auto source_values =
+        Helper<DeviceType>::makeSmoothValues( source_points_arr );
+
+    Operator op( comm, source_points, target_points );
+
+    Kokkos::View<double *, DeviceType> target_values_ref( "target_values_ref",
+                                                          n_target_points );
+    op.apply( source_values, target_values_ref );
+
+    auto handle = op.applyBegin( source_values );
+    Kokkos::deep_copy( source_values, 0. );
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    op.applyEnd( handle, target_values );
+
+    Helper<DeviceType>::compareValues( target_values, target_values_ref, 1e-14,
+                                       success, out );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, overlapping_operators,
+                                   OperatorType, Operator )
+{
+    // Check that two operators can be applied in split phase at the same
+    // time, started in a different order on even and odd processors and
+    // completed in the reverse order, without mixing up their messages.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    auto source_points_arr =
+        Helper<DeviceType>::makeSlabSourcePoints( comm_rank );
+
+    // The targets of the first operator are in the domain of the next
+    // processor and those of the second one in the domain of the previous
+    // processor, with different numbers of points.
+    auto first_target_points_arr = Helper<DeviceType>::makeSlabTargetPoints(
+        ( comm_rank + 1 ) % comm_size, {{3, 3, 1}}, 3.5, 3.5 );
+    auto second_target_points_arr = Helper<DeviceType>::makeSlabTargetPoints(
+        ( comm_rank + comm_size - 1 ) % comm_size, {{4, 2, 1}}, 2.5, 4.5 );
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto source_values =
+        Helper<DeviceType>::makeSmoothValues( source_points_arr );
+    auto first_target_points =
+        Helper<DeviceType>::makePoints( first_target_points_arr );
+    auto second_target_points =
+        Helper<DeviceType>::makePoints( second_target_points_arr );
+
+    Operator first( comm, source_points, first_target_points );
+    Operator second( comm, source_points, second_target_points );
+
+    Kokkos::View<double *, DeviceType> first_values_ref(
+        "first_values_ref", first_target_points.extent( 0 ) );
+    first.apply( source_values, first_values_ref );
+    Kokkos::View<double *, DeviceType> second_values_ref(
+        "second_values_ref", second_target_points.extent( 0 ) );
+    second.apply( source_values, second_values_ref );
+
+    Kokkos::View<double *, DeviceType> first_values(
+        "first_values", first_target_points.extent( 0 ) );
+    Kokkos::View<double *, DeviceType> second_values(
+        "second_values", second_target_points.extent( 0 ) );
+    if ( comm_rank % 2 == 0 )
+    {
+        auto first_handle = first.applyBegin( source_values );
+        auto second_handle = second.applyBegin( source_values );
+        second.applyEnd( second_handle, second_values );
+        first.applyEnd( first_handle, first_values );
+    }
+    else
+    {
+        auto second_handle = second.applyBegin( source_values );
+        auto first_handle = first.applyBegin( source_values );
+        first.applyEnd( first_handle, first_values );
+        second.applyEnd( second_handle, second_values );
+    }
+
+    Helper<DeviceType>::compareValues( first_values, first_values_ref, 1e-14,
+                                       success, out );
+    Helper<DeviceType>::compareValues( second_values, second_values_ref,
+                                       1e-14, success, out );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, apply_subset,
+                                   OperatorType, Operator )
+{
+    // Check that applySubset() computes the same values as apply() at the
+    // selected targets and leaves the other ones untouched.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    auto source_points_arr =
+        Helper<DeviceType>::makeSlabSourcePoints( comm_rank );
+    auto target_points_arr = Helper<DeviceType>::makeSlabTargetPoints(
+        comm_rank, {{3, 3, 1}}, 3.5, 3.5 );
+    int const n_target_points = target_points_arr.size();
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+    auto source_values =
+        Helper<DeviceType>::makeSmoothValues( source_points_arr );
+
+    Operator op( comm, source_points, target_points );
+
+    Kokkos::View<double *, DeviceType> target_values_all( "target_values_all",
+                                                          n_target_points );
+    op.apply( source_values, target_values_all );
+
+    // Select every other target, in reverse order.
+    int const n_selected = n_target_points / 2;
+    Kokkos::View<int *, DeviceType> target_indices( "target_indices",
+                                                    n_selected );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n_selected ),
+                          KOKKOS_LAMBDA( int k ) {
+                              target_indices( k ) =
+                                  n_target_points - 2 - 2 * k;
+                          } );
+    Kokkos::fence();
+
+    double const untouched = 1000.;
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    Kokkos::deep_copy( target_values, untouched );
+    op.applySubset( source_values, target_indices, target_values );
+
+    auto target_values_all_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_values_all );
+    std::vector<double> target_values_ref( n_target_points, untouched );
+    for ( int i = n_target_points - 2; i >= 0; i -= 2 )
+        target_values_ref[i] = target_values_all_host( i );
+    Helper<DeviceType>::compareValues(
+        target_values, Helper<DeviceType>::makeValues( target_values_ref ),
+        1e-14, success, out );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, shared_search_tree,
+                                   OperatorType, Operator )
+{
+    // Check that operators built from a search tree shared between several
+    // sets of target points give the same result as operators that build
+    // their own tree.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    std::array<int, DIM> n_source_points_grid = {10, 10, 2};
+    std::array<double, DIM> offset = {0., 0., 2. * comm_rank};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+    int const n_source_points = source_points_arr.size();
+
+    std::vector<double> source_values_arr( n_source_points );
+    for ( int i = 0; i < n_source_points; ++i )
+        source_values_arr[i] =
+            std::sin( source_points_arr[i][0] ) + source_points_arr[i][1];
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto source_values = Helper<DeviceType>::makeValues( source_values_arr );
+
+    PointCloudSearchTree<DeviceType> search_tree( comm, source_points );
+
+    for ( double shift : {0.5, 2.25} )
+    {
+        std::array<int, DIM> n_target_points_grid = {3, 3, 1};
+        offset = {3. + shift, 3. + shift, 2. * comm_rank + .5};
+        auto target_points_arr =
+            Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+        int const n_target_points = target_points_arr.size();
+        auto target_points =
+            Helper<DeviceType>::makePoints( target_points_arr );
+
+        Operator op_ref( comm, source_points, target_points );
+        Kokkos::View<double *, DeviceType> target_values_ref(
+            "target_values_ref", n_target_points );
+        op_ref.apply( source_values, target_values_ref );
+
+        Operator op( search_tree, target_points );
+        Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                          n_target_points );
+        op.apply( source_values, target_values );
+
+        auto target_values_host = Kokkos::create_mirror_view( target_values );
+        Kokkos::deep_copy( target_values_host, target_values );
+        auto target_values_ref_host =
+            Kokkos::create_mirror_view( target_values_ref );
+        Kokkos::deep_copy( target_values_ref_host, target_values_ref );
+        TEST_COMPARE_FLOATING_ARRAYS( target_values_host,
+                                      target_values_ref_host, 1e-14 );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, balance_targets,
+                                   OperatorType, Operator )
+{
+    // Check that redistributing the target points during the setup does not
+    // change the result. The first processor owns most of the targets.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    std::array<int, DIM> n_source_points_grid = {10, 10, 2};
+    std::array<double, DIM> offset = {0., 0., 2. * comm_rank};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+    int const n_source_points = source_points_arr.size();
+
+    std::vector<double> source_values_arr( n_source_points );
+    for ( int i = 0; i < n_source_points; ++i )
+        source_values_arr[i] =
+            std::sin( source_points_arr[i][0] ) + source_points_arr[i][2];
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto source_values = Helper<DeviceType>::makeValues( source_values_arr );
+
+    std::array<int, DIM> n_target_points_grid = {1, 1, 1};
+    if ( comm_rank == 0 )
+        n_target_points_grid = {7, 7, 2 * comm_size};
+    offset = {1.25, 1.25, .5};
+    auto target_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+    int const n_target_points = target_points_arr.size();
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    Operator op_ref( PointCloudSearchTree<DeviceType>( comm, source_points ),
+                     target_points );
+    Kokkos::View<double *, DeviceType> target_values_ref( "target_values_ref",
+                                                          n_target_points );
+    op_ref.apply( source_values, target_values_ref );
+
+    Operator op(
+        PointCloudSearchTree<DeviceType>( comm, source_points, true ),
+        target_points );
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    op.apply( source_values, target_values );
+
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    auto target_values_ref_host =
+        Kokkos::create_mirror_view( target_values_ref );
+    Kokkos::deep_copy( target_values_ref_host, target_values_ref );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref_host,
+                                  1e-12 );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, lower_dimension,
+                                   OperatorType, Operator )
+{
+    // Reproduce a linear function with points in dimension 1 or 2. The source
+    // points are the nodes of a structured grid and the target points are
+    // inside its cells.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+    using PolynomialBasis = typename Operator::polynomial_basis;
+    int constexpr dim = PolynomialBasis::dimension;
+    static_assert( dim == 1 || dim == 2, "Points in dimension 1 or 2" );
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    int const n = 10;
+    int const n_source_points = dim == 1 ? n : n * n;
+    int const n_target_points = dim == 1 ? n - 1 : ( n - 1 ) * ( n - 1 );
+    double const offset = n * comm_rank;
+
+    auto f = []( double x, double y ) { return 1. + 2. * x - 3. * y; };
+
+    Kokkos::View<Coordinate **, DeviceType> source_points(
+        "source_points", n_source_points, dim );
+    Kokkos::View<double *, DeviceType> source_values( "source_values",
+                                                      n_source_points );
+    auto source_points_host = Kokkos::create_mirror_view( source_points );
+    auto source_values_host = Kokkos::create_mirror_view( source_values );
+    for ( int i = 0; i < n_source_points; ++i )
+    {
+        double const x = offset + i % n;
+        double const y = dim == 1 ? 0. : i / n;
+        source_points_host( i, 0 ) = x;
+        if ( dim == 2 )
+            source_points_host( i, 1 ) = y;
+        source_values_host( i ) = f( x, y );
+    }
+    Kokkos::deep_copy( source_points, source_points_host );
+    Kokkos::deep_copy( source_values, source_values_host );
+
+    Kokkos::View<Coordinate **, DeviceType> target_points(
+        "target_points", n_target_points, dim );
+    auto target_points_host = Kokkos::create_mirror_view( target_points );
+    std::vector<double> target_values_ref( n_target_points );
+    for ( int i = 0; i < n_target_points; ++i )
+    {
+        double const x = offset + i % ( n - 1 ) + 0.3;
+        double const y = dim == 1 ? 0. : i / ( n - 1 ) + 0.4;
+        target_points_host( i, 0 ) = x;
+        if ( dim == 2 )
+            target_points_host( i, 1 ) = y;
+        target_values_ref[i] = f( x, y );
+    }
+    Kokkos::deep_copy( target_points, target_points_host );
+
+    Operator op( comm, source_points, target_points );
+
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    op.apply( source_values, target_values );
+
+    double const eps = std::is_same<OperatorType, MLS>{} ? 1e-12 : 1e-9;
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref, eps );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, coincident_points,
+                                   OperatorType, Operator )
+{
+    // Every source point is given twice by its processor and once more by
+    // the previous processor. Once the coincident points are collapsed, one
+    // point per location is left and the operator reproduces a linear
+    // function.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    std::array<int, DIM> n_source_points_grid = {6, 6, 2};
+    std::array<double, DIM> offset = {0., 0., 2. * comm_rank};
+    auto own_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+    offset = {0., 0., 2. * ( ( comm_rank + 1 ) % comm_size )};
+    auto next_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+    auto source_points_arr = own_points_arr;
+    source_points_arr.insert( source_points_arr.end(), own_points_arr.begin(),
+                              own_points_arr.end() );
+    source_points_arr.insert( source_points_arr.end(),
+                              next_points_arr.begin(), next_points_arr.end() );
+
+    std::array<int, DIM> n_target_points_grid = {3, 3, 1};
+    offset = {1.3, 1.6, 2. * comm_rank + .5};
+    auto target_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+
+    int const n_source_points = source_points_arr.size();
+    int const n_target_points = target_points_arr.size();
+
+    auto f = []( std::array<double, DIM> const &p ) {
+        return 1. + p[0] + 2. * p[1] + 3. * p[2];
+    };
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    double const tolerance = 1e-6;
+    double const support_radius = 1.5;
+    PointCloudSearchTree<DeviceType> search_tree( comm, source_points, false,
+                                                  tolerance );
+
+    if ( std::is_same<OperatorType, Spline>{} )
+    {
+        TEST_THROW( Operator( search_tree, target_points, support_radius ),
+                    DataTransferKitException );
+        return;
+    }
+
+    auto representatives =
+        Details::CoincidentPointsImpl<DeviceType>::findRepresentatives(
+            comm, source_points, tolerance );
+    int n_representatives = representatives.extent( 0 );
+    MPI_Allreduce( MPI_IN_PLACE, &n_representatives, 1, MPI_INT, MPI_SUM,
+                   comm );
+    TEST_EQUALITY( n_representatives,
+                   comm_size * static_cast<int>( own_points_arr.size() ) );
+
+    Operator op( search_tree, target_points, support_radius );
+
+    Kokkos::View<double *, DeviceType> source_values( "source_values",
+                                                      n_source_points );
+    auto source_values_host = Kokkos::create_mirror_view( source_values );
+    for ( int i = 0; i < n_source_points; ++i )
+        source_values_host( i ) = f( source_points_arr[i] );
+    Kokkos::deep_copy( source_values, source_values_host );
+
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    op.apply( source_values, target_values );
+    auto target_values_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_values );
+
+    for ( int i = 0; i < n_target_points; ++i )
+        TEST_FLOATING_EQUALITY( target_values_host( i ),
+                                f( target_points_arr[i] ), 1e-10 );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator,
+                                   coincident_points_boundary, OperatorType,
+                                   Operator )
+{
+    // Points closer than the tolerance are merged wherever they are: on
+    // either side of a multiple of the tolerance, far away from the origin,
+    // or on different processors.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    double const tolerance = .1;
+    double const y = comm_rank;
+    std::vector<std::array<double, DIM>> points_arr = {
+        {{1., y, 0.}},
+        {{0.9999999999999999, y, 0.}},
+        {{1.5, y, 0.}},
+        {{1e19, y, 0.}},
+        {{1e19, y, 0.}},
+        {{3., -1., 0.}}};
+    auto points = Helper<DeviceType>::makePoints( points_arr );
+
+    auto representatives =
+        Details::CoincidentPointsImpl<DeviceType>::findRepresentatives(
+            comm, points, tolerance );
+    auto representatives_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, representatives );
+    std::vector<int> representatives_found(
+        representatives_host.data(),
+        representatives_host.data() + representatives_host.extent( 0 ) );
+    // The last point is shared by all the processors.
+    std::vector<int> representatives_ref = {0, 2, 3};
+    if ( comm_rank == 0 )
+        representatives_ref.push_back( 5 );
+    TEST_COMPARE_ARRAYS( representatives_found, representatives_ref );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( MovingLeastSquaresOperatorImpl, team_svd,
+                                   DeviceType )
+{
+    // Check that inverting the moment matrices with a team of threads gives
+    // the same coefficients as inverting them on the stack of a thread.
+    using namespace DataTransferKit;
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    using PolynomialBasis = MultivariatePolynomialBasis<Quadratic, DIM>;
+
+    int const n_target_points = 10;
+    int const n_neighbors = 20;
+    double const radius = 1.;
+    std::vector<std::array<double, DIM>> source_points_arr( n_target_points *
+                                                            n_neighbors );
+    std::vector<std::array<double, DIM>> target_points_arr( n_target_points );
+    Helper<DeviceType>::makeSourceTargetPoints(
+        source_points_arr, target_points_arr, n_neighbors, radius, 0 );
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    // The neighbors of the i-th target point are the source points generated
+    // around it. A zero support radius makes the weights of all of them
+    // positive.
+    Kokkos::View<int *, DeviceType> offset( "offset", n_target_points + 1 );
+    auto offset_host = Kokkos::create_mirror_view( offset );
+    for ( int i = 0; i <= n_target_points; ++i )
+        offset_host( i ) = i * n_neighbors;
+    Kokkos::deep_copy( offset, offset_host );
+
+    std::vector<std::vector<double>> coeffs_found;
+    for ( bool team_svd : {false, true} )
+    {
+        auto t = Impl::computeCoefficients(
+            offset, source_points, target_points, 0., Wendland<0>(),
+            PolynomialBasis(), team_svd );
+        TEST_EQUALITY( std::get<1>( t ), 0 );
+        auto coeffs_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{}, std::get<0>( t ) );
+        coeffs_found.emplace_back( coeffs_host.data(),
+                                   coeffs_host.data() +
+                                       coeffs_host.extent( 0 ) );
+    }
+    TEST_COMPARE_FLOATING_ARRAYS( coeffs_found[1], coeffs_found[0], 1e-8 );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, update, OperatorType,
+                                   Operator )
+{
+    // Check that updating an operator after the target points moved gives the
+    // same result as building a new operator, both when the neighbors are
+    // searched again and when they are kept, with the nearest neighbor search
+    // and with the spatial search.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    std::array<int, DIM> n_source_points_grid = {10, 10, 2};
+    std::array<double, DIM> offset = {0., 0., 2. * comm_rank};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+    int const n_source_points = source_points_arr.size();
+
+    std::vector<double> source_values_arr( n_source_points );
+    for ( int i = 0; i < n_source_points; ++i )
+        source_values_arr[i] =
+            std::sin( source_points_arr[i][0] ) + source_points_arr[i][1];
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto source_values = Helper<DeviceType>::makeValues( source_values_arr );
+
+    // The target points are placed such that their nearest neighbors are
+    // well separated from the other source points.
+    std::array<int, DIM> n_target_points_grid = {3, 3, 1};
+    offset = {3.3, 3.6, 2. * comm_rank + .15};
+    auto target_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+    int const n_target_points = target_points_arr.size();
+
+    // The first target points move slightly, the next ones move to the next
+    // cell of the grid, and the last one does not move.
+    auto moved_target_points_arr = target_points_arr;
+    for ( int i = 0; i < n_target_points - 1; ++i )
+    {
+        if ( i < n_target_points / 2 )
+        {
+            moved_target_points_arr[i][0] += .01 * std::sin( i );
+            moved_target_points_arr[i][1] += .01 * std::cos( i );
+            moved_target_points_arr[i][2] += .005;
+        }
+        else
+        {
+            moved_target_points_arr[i][0] += 1.;
+        }
+    }
+
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+    auto moved_target_points =
+        Helper<DeviceType>::makePoints( moved_target_points_arr );
+
+    // The neighbors are the nearest source points or, with a positive support
+    // radius, the source points within the radius.
+    PointCloudSearchTree<DeviceType> search_tree( comm, source_points );
+    auto const make_operator = [&]( double support_radius,
+                                    decltype( target_points ) points ) {
+        return support_radius > 0.
+                   ? Operator( search_tree, points, support_radius )
+                   : Operator( search_tree, points );
+    };
+    for ( double support_radius : {0., 1.5} )
+        for ( double tolerance : {0., .1} )
+        {
+            auto op = make_operator( support_radius, target_points );
+            Kokkos::View<double *, DeviceType> target_values(
+                "target_values", n_target_points );
+            Kokkos::View<double *, DeviceType> target_values_ref(
+                "target_values_ref", n_target_points );
+
+            // Move the target points and then move them back.
+            for ( auto points : {moved_target_points, target_points} )
+            {
+                op.update( points, tolerance );
+                op.apply( source_values, target_values );
+
+                auto op_ref = make_operator( support_radius, points );
+                op_ref.apply( source_values, target_values_ref );
+
+                auto target_values_host =
+                    Kokkos::create_mirror_view( target_values );
+                Kokkos::deep_copy( target_values_host, target_values );
+                auto target_values_ref_host =
+                    Kokkos::create_mirror_view( target_values_ref );
+                Kokkos::deep_copy( target_values_ref_host,
+                                   target_values_ref );
+                TEST_COMPARE_FLOATING_ARRAYS( target_values_host,
+                                              target_values_ref_host, 1e-12 );
+            }
+        }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, radius_search,
+                                   OperatorType, Operator )
+{
+    // Check that the operators built with a spatial search instead of a
+    // nearest neighbor search reproduce the functions they should.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    std::array<int, DIM> n_source_points_grid = {10, 10, 2};
+    std::array<double, DIM> offset = {0., 0., 2. * comm_rank};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+    int const n_source_points = source_points_arr.size();
+
+    std::array<int, DIM> n_target_points_grid = {3, 3, 1};
+    offset = {3.3, 3.6, 2. * comm_rank + .5};
+    auto target_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+    int const n_target_points = target_points_arr.size();
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    PointCloudSearchTree<DeviceType> search_tree( comm, source_points );
+
+    // With the given radius, every ball contains enough points that are not
+    // coplanar to reproduce a linear function. The estimated radius only
+    // guarantees this on average so only a constant function is checked.
+    for ( double support_radius : {1.5, 0.} )
+    {
+        auto f = [support_radius]( std::array<double, DIM> p ) -> double {
+            return support_radius > 0. ? 4 + 2 * p[0] + 3 * p[1] - 2 * p[2]
+                                       : 3.;
+        };
+        std::vector<double> source_values_arr( n_source_points );
+        for ( int i = 0; i < n_source_points; ++i )
+            source_values_arr[i] = f( source_points_arr[i] );
+        std::vector<double> target_values_ref( n_target_points );
+        for ( int i = 0; i < n_target_points; ++i )
+            target_values_ref[i] = f( target_points_arr[i] );
+        auto source_values =
+            Helper<DeviceType>::makeValues( source_values_arr );
+
+        Operator op( search_tree, target_points, support_radius );
+        Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                          n_target_points );
+        op.apply( source_values, target_values );
+
+        double eps = 0.0;
+        if ( std::is_same<OperatorType, MLS>{} )
+            eps = 1e-12;
+        else if ( std::is_same<OperatorType, Spline>{} )
+            eps = 1e-9;
+
+        auto target_values_host = Kokkos::create_mirror_view( target_values );
+        Kokkos::deep_copy( target_values_host, target_values );
+        TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
+                                      eps );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, solver_parameters,
+                                   OperatorType, Operator )
+{
+    // Check that the preconditioner and the warm start do not change the
+    // result beyond the tolerance of the solver, including when the source
+    // values change between two calls to apply().
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    std::array<int, DIM> n_source_points_grid = {10, 10, 2};
+    std::array<double, DIM> offset = {0., 0., 2. * comm_rank};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+    int const n_source_points = source_points_arr.size();
+
+    std::array<int, DIM> n_target_points_grid = {3, 3, 1};
+    offset = {3.3, 3.6, 2. * comm_rank + .5};
+    auto target_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+    int const n_target_points = target_points_arr.size();
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    Teuchos::ParameterList no_preconditioner;
+    no_preconditioner.set( "Preconditioner", false );
+    Operator op_ref( comm, source_points, target_points, no_preconditioner );
+
+    Teuchos::ParameterList warm_start;
+    warm_start.set( "Warm Start", true );
+    Operator op( comm, source_points, target_points, warm_start );
+
+    for ( double t : {0., .1, .2} )
+    {
+        std::vector<double> source_values_arr( n_source_points );
+        for ( int i = 0; i < n_source_points; ++i )
+            source_values_arr[i] =
+                std::sin( source_points_arr[i][0] + t ) +
+                source_points_arr[i][1];
+        auto source_values =
+            Helper<DeviceType>::makeValues( source_values_arr );
+
+        Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                          n_target_points );
+        op.apply( source_values, target_values );
+        Kokkos::View<double *, DeviceType> target_values_ref(
+            "target_values_ref", n_target_points );
+        op_ref.apply( source_values, target_values_ref );
+
+        auto target_values_host = Kokkos::create_mirror_view( target_values );
+        Kokkos::deep_copy( target_values_host, target_values );
+        auto target_values_ref_host =
+            Kokkos::create_mirror_view( target_values_ref );
+        Kokkos::deep_copy( target_values_ref_host, target_values_ref );
+        TEST_COMPARE_FLOATING_ARRAYS( target_values_host,
+                                      target_values_ref_host, 1e-8 );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, crs_matrix, OperatorType,
+                                   Operator )
+{
+    // Check that the explicit sparse matrix gives the same result as the
+    // operator, or that the operator refuses to be converted.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    // The target points of a processor straddle the source points of the
+    // next one.
+    std::array<int, DIM> n_source_points_grid = {10, 10, 2};
+    std::array<double, DIM> offset = {0., 0., 2. * comm_rank};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+
+    std::array<int, DIM> n_target_points_grid = {3, 3, 2};
+    offset = {3.5, 3.5, 2. * ( ( comm_rank + 1 ) % comm_size ) + .5};
+    auto target_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+
+    int const n_source_points = source_points_arr.size();
+    int const n_target_points = target_points_arr.size();
+    int const n_fields = 2;
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    Operator op( comm, source_points, target_points );
+
+    if ( std::is_same<OperatorType, Spline>{} )
+    {
+        TEST_THROW( op.getCrsMatrix(), DataTransferKitException );
+        return;
+    }
+
+    auto crs_matrix = op.getCrsMatrix();
+    TEST_EQUALITY( crs_matrix.getNumberOfRows(), n_target_points );
+    auto row_ptrs_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, crs_matrix.getRowPtrs() );
+    // Each source point appears at most once in the halo.
+    TEST_ASSERT( crs_matrix.getNumberOfColumns() <=
+                 row_ptrs_host( n_target_points ) );
+
+    Kokkos::View<double **, DeviceType> source_values(
+        "source_values", n_source_points, n_fields );
+    auto source_values_host = Kokkos::create_mirror_view( source_values );
+    for ( int i = 0; i < n_source_points; ++i )
+    {
+        auto const &p = source_points_arr[i];
+        source_values_host( i, 0 ) = 1. + p[0] + 2 * p[1] + 3 * p[2];
+        source_values_host( i, 1 ) = 2. + std::sin( p[0] ) * std::cos( p[1] );
+    }
+    Kokkos::deep_copy( source_values, source_values_host );
+
+    Kokkos::View<double **, DeviceType> target_values_ref(
+        "target_values_ref", n_target_points, n_fields );
+    op.apply( source_values, target_values_ref );
+    auto target_values_ref_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_values_ref );
+
+    Kokkos::View<double **, DeviceType> target_values(
+        "target_values", n_target_points, n_fields );
+    crs_matrix.apply( source_values, target_values );
+    auto target_values_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_values );
+
+    Kokkos::View<double *, DeviceType> source_field( "source_field",
+                                                     n_source_points );
+    Kokkos::deep_copy( source_field,
+                       Kokkos::subview( source_values, Kokkos::ALL, 1 ) );
+    Kokkos::View<double *, DeviceType> target_field( "target_field",
+                                                     n_target_points );
+    crs_matrix.apply( source_field, target_field );
+    auto target_field_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_field );
+
+    for ( int i = 0; i < n_target_points; ++i )
+    {
+        for ( int k = 0; k < n_fields; ++k )
+            TEST_FLOATING_EQUALITY( target_values_host( i, k ),
+                                    target_values_ref_host( i, k ), 1e-12 );
+        TEST_FLOATING_EQUALITY( target_field_host( i ),
+                                target_values_ref_host( i, 1 ), 1e-12 );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, compose, OperatorType,
+                                   Operator )
+{
+    // Check that the composition of two operators gives the same result as
+    // applying them one after the other.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    auto source_points_arr =
+        Helper<DeviceType>::makeSlabSourcePoints( comm_rank );
+
+    std::array<int, DIM> n_middle_points_grid = {6, 6, 2};
+    std::array<double, DIM> offset = {2., 2., 2. * comm_rank};
+    auto middle_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_middle_points_grid, offset );
+
+    // The final target points of a processor depend on the intermediate
+    // points of the next one.
+    auto target_points_arr = Helper<DeviceType>::makeSlabTargetPoints(
+        ( comm_rank + 1 ) % comm_size, {{3, 3, 1}}, 3.5, 3.5 );
+
+    int const n_middle_points = middle_points_arr.size();
+    int const n_target_points = target_points_arr.size();
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto middle_points = Helper<DeviceType>::makePoints( middle_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    Operator first( comm, source_points, middle_points );
+    Operator second( comm, middle_points, target_points );
+
+    auto fused = compose( first, second );
+    TEST_EQUALITY( fused.getNumberOfRows(), n_target_points );
+
+    auto source_values =
+        Helper<DeviceType>::makeSmoothValues( source_points_arr );
+
+    Kokkos::View<double *, DeviceType> middle_values( "middle_values",
+                                                      n_middle_points );
+    first.apply( source_values, middle_values );
+    Kokkos::View<double *, DeviceType> target_values_ref( "target_values_ref",
+                                                          n_target_points );
+    second.apply( middle_values, target_values_ref );
+
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    fused.apply( source_values, target_values );
+
+    Helper<DeviceType>::compareValues( target_values, target_values_ref, 1e-12,
+                                       success, out );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, save_load, OperatorType,
+                                   Operator )
+{
+    // Check that an operator loaded from files gives the same result as the
+    // operator that wrote them, and that files are only loaded with the same
+    // points.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    auto source_points_arr =
+        Helper<DeviceType>::makeSlabSourcePoints( comm_rank );
+    auto target_points_arr = Helper<DeviceType>::makeSlabTargetPoints(
+        comm_rank, {{3, 3, 1}}, 3.3, 3.6 );
+    int const n_target_points = target_points_arr.size();
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    std::string const prefix = "meshfree_operator_archive";
+    Operator op( comm, source_points, target_points );
+    op.save( prefix );
+    Operator loaded_op( comm, source_points, target_points, prefix );
+
+    auto source_values =
+        Helper<DeviceType>::makeSmoothValues( source_points_arr );
+
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    op.apply( source_values, target_values );
+    Kokkos::View<double *, DeviceType> loaded_target_values(
+        "loaded_target_values", n_target_points );
+    loaded_op.apply( source_values, loaded_target_values );
+    Helper<DeviceType>::compareValues( loaded_target_values, target_values,
+                                       1e-12, success, out );
+
+    // The target points moved.
+    target_points_arr[0][0] += .1;
+    auto moved_target_points =
+        Helper<DeviceType>::makePoints( target_points_arr );
+    TEST_THROW( Operator( comm, source_points, moved_target_points, prefix ),
+                DataTransferKitException );
+
+    std::remove( ( prefix + "." + std::to_string( comm_rank ) ).c_str() );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, single_precision,
+                                   OperatorType, Operator )
+{
+    // Check that storing the coefficients and exchanging the values in single
+    // precision only loses single precision accuracy.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+    using SinglePrecisionOperator =
+        MovingLeastSquaresOperator<DeviceType,
+                                   typename Operator::radial_basis_function,
+                                   typename Operator::polynomial_basis, float>;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    // The target points of a processor are surrounded by the source points of
+    // the next one.
+    std::array<int, DIM> n_source_points_grid = {10, 10, 2};
+    std::array<double, DIM> offset = {0., 0., 2. * comm_rank};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+
+    std::array<int, DIM> n_target_points_grid = {3, 3, 1};
+    offset = {3.3, 3.6, 2. * ( ( comm_rank + 1 ) % comm_size ) + .5};
+    auto target_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+
+    int const n_source_points = source_points_arr.size();
+    int const n_target_points = target_points_arr.size();
+    int const n_fields = 2;
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    Operator op( comm, source_points, target_points );
+    SinglePrecisionOperator single_precision_op( comm, source_points,
+                                                 target_points );
+
+    Kokkos::View<double **, DeviceType> source_values(
+        "source_values", n_source_points, n_fields );
+    auto source_values_host = Kokkos::create_mirror_view( source_values );
+    for ( int i = 0; i < n_source_points; ++i )
+    {
+        auto const &p = source_points_arr[i];
+        source_values_host( i, 0 ) = 10. + p[0] - 2 * p[1] + 3 * p[2];
+        source_values_host( i, 1 ) = 2. + std::sin( p[0] ) * std::cos( p[1] );
+    }
+    Kokkos::deep_copy( source_values, source_values_host );
+
+    Kokkos::View<double **, DeviceType> target_values_ref(
+        "target_values_ref", n_target_points, n_fields );
+    op.apply( source_values, target_values_ref );
+    auto target_values_ref_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_values_ref );
+
+    Kokkos::View<double **, DeviceType> target_values(
+        "target_values", n_target_points, n_fields );
+    single_precision_op.apply( source_values, target_values );
+    auto target_values_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_values );
+
+    // The split-phase apply exchanges single precision values as well.
+    Kokkos::View<double *, DeviceType> source_field( "source_field",
+                                                     n_source_points );
+    Kokkos::deep_copy( source_field,
+                       Kokkos::subview( source_values, Kokkos::ALL, 1 ) );
+    Kokkos::View<double *, DeviceType> target_field( "target_field",
+                                                     n_target_points );
+    auto handle = single_precision_op.applyBegin( source_field );
+    single_precision_op.applyEnd( handle, target_field );
+    auto target_field_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_field );
+
+    for ( int i = 0; i < n_target_points; ++i )
+    {
+        for ( int k = 0; k < n_fields; ++k )
+            TEST_FLOATING_EQUALITY( target_values_host( i, k ),
+                                    target_values_ref_host( i, k ), 1e-6 );
+        TEST_FLOATING_EQUALITY( target_field_host( i ),
+                                target_values_ref_host( i, 1 ), 1e-6 );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_2_DECL( MeshfreeOperator, transpose, OperatorType,
+                                   Operator )
+{
+    // Check that applyTranspose() is the adjoint of apply(), i.e. that
+    // <A x, y> = <x, A^T y>, for one and for several fields.
+    using namespace DataTransferKit;
+
+    using DeviceType = typename Operator::device_type;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    // The target points of a processor straddle the source points of the
+    // next one so that the contributions are sent back to several
+    // processors.
+    auto source_points_arr =
+        Helper<DeviceType>::makeSlabSourcePoints( comm_rank );
+    auto target_points_arr = Helper<DeviceType>::makeSlabTargetPoints(
+        ( comm_rank + 1 ) % comm_size, {{3, 3, 2}}, 3.5, 3.5 );
+
+    int const n_source_points = source_points_arr.size();
+    int const n_target_points = target_points_arr.size();
+    int const n_fields = 2;
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    Operator op( comm, source_points, target_points );
+
+    Kokkos::View<double **, DeviceType> source_values(
+        "source_values", n_source_points, n_fields );
+    auto source_values_host = Kokkos::create_mirror_view( source_values );
+    for ( int i = 0; i < n_source_points; ++i )
+    {
+        auto const &p = source_points_arr[i];
+        source_values_host( i, 0 ) = 1. + p[0] + 2 * p[1] + 3 * p[2];
+        source_values_host( i, 1 ) = 2. + std::sin( p[0] ) * std::cos( p[1] );
+    }
+    Kokkos::deep_copy( source_values, source_values_host );
+
+    Kokkos::View<double **, DeviceType> target_values(
+        "target_values", n_target_points, n_fields );
+    op.apply( source_values, target_values );
+    auto target_values_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_values );
+
+    Kokkos::View<double **, DeviceType> adjoint_target_values(
+        "adjoint_target_values", n_target_points, n_fields );
+    auto adjoint_target_values_host =
+        Kokkos::create_mirror_view( adjoint_target_values );
+    for ( int i = 0; i < n_target_points; ++i )
+    {
+        auto const &p = target_points_arr[i];
+        adjoint_target_values_host( i, 0 ) = 1. + p[0] * p[1] - p[2];
+        adjoint_target_values_host( i, 1 ) = 3. + std::cos( p[2] );
+    }
+    Kokkos::deep_copy( adjoint_target_values, adjoint_target_values_host );
+
+    Kokkos::View<double **, DeviceType> adjoint_source_values(
+        "adjoint_source_values", n_source_points, n_fields );
+    op.applyTranspose( adjoint_target_values, adjoint_source_values );
+    auto adjoint_source_values_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, adjoint_source_values );
+
+    // A single field gives the same result as the corresponding column.
+    Kokkos::View<double *, DeviceType> adjoint_target_field(
+        "adjoint_target_field", n_target_points );
+    Kokkos::deep_copy(
+        adjoint_target_field,
+        Kokkos::subview( adjoint_target_values, Kokkos::ALL, 1 ) );
+    Kokkos::View<double *, DeviceType> adjoint_source_field(
+        "adjoint_source_field", n_source_points );
+    op.applyTranspose( adjoint_target_field, adjoint_source_field );
+    auto adjoint_source_field_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, adjoint_source_field );
+
+    // <A x, y> and <x, A^T y> for each field, then <x, A^T y> for the single
+    // field. The local sums are reduced over all the processors.
+    std::array<double, 5> dot_products = {{0., 0., 0., 0., 0.}};
+    for ( int k = 0; k < n_fields; ++k )
+    {
+        for ( int i = 0; i < n_target_points; ++i )
+            dot_products[2 * k] +=
+                target_values_host( i, k ) * adjoint_target_values_host( i, k );
+        for ( int i = 0; i < n_source_points; ++i )
+            dot_products[2 * k + 1] += source_values_host( i, k ) *
+                                       adjoint_source_values_host( i, k );
+    }
+    for ( int i = 0; i < n_source_points; ++i )
+        dot_products[4] +=
+            source_values_host( i, 1 ) * adjoint_source_field_host( i );
+    MPI_Allreduce( MPI_IN_PLACE, dot_products.data(), dot_products.size(),
+                   MPI_DOUBLE, MPI_SUM, comm );
+
+    // The spline operator solves linear systems iteratively.
+    double const eps = std::is_same<OperatorType, Spline>{} ? 1e-8 : 1e-12;
+    for ( int k = 0; k < n_fields; ++k )
+        TEST_FLOATING_EQUALITY( dot_products[2 * k + 1], dot_products[2 * k],
+                                eps );
+    TEST_FLOATING_EQUALITY( dot_products[4], dot_products[3], eps );
+}
+
 // Include the test macros.
 #include "DataTransferKit_ETIHelperMacros.h"
 
@@ -459,9 +1737,16 @@ using Linear3 =
     DataTransferKit::MultivariatePolynomialBasis<DataTransferKit::Linear, 3>;
 using Quadratic3 =
     DataTransferKit::MultivariatePolynomialBasis<DataTransferKit::Quadratic, 3>;
+using Linear1 =
+    DataTransferKit::MultivariatePolynomialBasis<DataTransferKit::Linear, 1>;
+using Linear2 =
+    DataTransferKit::MultivariatePolynomialBasis<DataTransferKit::Linear, 2>;
 
 // Create the test group
 #define UNIT_TEST_GROUP( NODE )                                                \
+    using DeviceType##NODE = typename NODE::device_type;                       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( MovingLeastSquaresOperatorImpl,      \
+                                          team_svd, DeviceType##NODE )         \
     using MLS_Wendland0_Constant3_##NODE =                                     \
         DataTransferKit::MovingLeastSquaresOperator<                           \
             typename NODE::device_type, Wendland0, Constant3>;                 \
@@ -501,6 +1786,50 @@ using Quadratic3 =
     TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator,                    \
                                           single_point_in_radius, MLS,         \
                                           MLS_Wendland0_Quadratic3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, multiple_fields,   \
+                                          MLS,                                 \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, split_phase, MLS,  \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator,                    \
+                                          overlapping_operators, MLS,          \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, apply_subset, MLS, \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator,                    \
+                                          shared_search_tree, MLS,             \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, balance_targets,   \
+                                          MLS, MLS_Wendland0_Linear3_##NODE )  \
+    using MLS_Wendland0_Linear1_##NODE =                                       \
+        DataTransferKit::MovingLeastSquaresOperator<                           \
+            typename NODE::device_type, Wendland0, Linear1>;                   \
+    using MLS_Wendland0_Linear2_##NODE =                                       \
+        DataTransferKit::MovingLeastSquaresOperator<                           \
+            typename NODE::device_type, Wendland0, Linear2>;                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, lower_dimension,   \
+                                          MLS, MLS_Wendland0_Linear1_##NODE )  \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, lower_dimension,   \
+                                          MLS, MLS_Wendland0_Linear2_##NODE )  \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, coincident_points, \
+                                          MLS, MLS_Wendland0_Linear3_##NODE )  \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator,                    \
+                                          coincident_points_boundary, MLS,     \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, update, MLS,       \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, radius_search,     \
+                                          MLS, MLS_Wendland0_Linear3_##NODE )  \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, crs_matrix, MLS,   \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, compose, MLS,      \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, save_load, MLS,    \
+                                          MLS_Wendland0_Linear3_##NODE )       \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, single_precision,  \
+                                          MLS, MLS_Wendland0_Linear3_##NODE )  \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, transpose, MLS,    \
+                                          MLS_Wendland0_Linear3_##NODE )       \
     using Spline_Wendland0_Linear3_##NODE =                                    \
         DataTransferKit::SplineOperator<typename NODE::device_type, Wendland0, \
                                         Linear3>;                              \
@@ -513,6 +1842,51 @@ using Quadratic3 =
                                           Spline_Wendland0_Linear3_##NODE )    \
     TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator,                    \
                                           single_point_in_radius, Spline,      \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, multiple_fields,   \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, split_phase,       \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, apply_subset,      \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator,                    \
+                                          shared_search_tree, Spline,          \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, balance_targets,   \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, coincident_points, \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    using Spline_Wendland0_Linear1_##NODE =                                    \
+        DataTransferKit::SplineOperator<typename NODE::device_type, Wendland0, \
+                                        Linear1>;                              \
+    using Spline_Wendland0_Linear2_##NODE =                                    \
+        DataTransferKit::SplineOperator<typename NODE::device_type, Wendland0, \
+                                        Linear2>;                              \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, lower_dimension,   \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear1_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, lower_dimension,   \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear2_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, radius_search,     \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, solver_parameters, \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, crs_matrix,        \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, save_load,         \
+                                          Spline,                              \
+                                          Spline_Wendland0_Linear3_##NODE )    \
+    TEUCHOS_UNIT_TEST_TEMPLATE_2_INSTANT( MeshfreeOperator, transpose,         \
+                                          Spline,                              \
                                           Spline_Wendland0_Linear3_##NODE )
 
 // Demangle the types
@@ -31,9 +31,40 @@ void checkBasisEvaluation( PolynomialBasis const &b, Point const &x,
 //
 //     error: macro "TEST_EQUALITY" passed 3 arguments, but takes just 2
 
+TEUCHOS_UNIT_TEST( MultivariatePolynomialBasis, 1D )
+{
+    using DataTransferKit::Constant;
+    using DataTransferKit::Cubic;
+    using DataTransferKit::Linear;
+    using DataTransferKit::MultivariatePolynomialBasis;
+    using DataTransferKit::Quadratic;
+    using Point = Kokkos::Array<double, 1>;
+
+    // X -> [ 1 ]
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Constant, 1>::size ), 1 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Constant, 1>(),
+                          Point{{2.}}, {1.}, success, out );
+
+    // X -> [ 1, X ]
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Linear, 1>::size ), 2 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Linear, 1>(),
+                          Point{{2.}}, {{1., 2.}}, success, out );
+
+    // X -> [ 1, X, X^2 ]
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Quadratic, 1>::size ), 3 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Quadratic, 1>(),
+                          Point{{2.}}, {{1., 2., 4.}}, success, out );
+
+    // X -> [ 1, X, X^2, X^3 ]
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Cubic, 1>::size ), 4 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Cubic, 1>(),
+                          Point{{2.}}, {{1., 2., 4., 8.}}, success, out );
+}
+
 TEUCHOS_UNIT_TEST( MultivariatePolynomialBasis, 2D )
 {
     using DataTransferKit::Constant;
+    using DataTransferKit::Cubic;
     using DataTransferKit::Linear;
     using DataTransferKit::MultivariatePolynomialBasis;
     using DataTransferKit::Quadratic;
@@ -55,12 +86,20 @@ TEUCHOS_UNIT_TEST( MultivariatePolynomialBasis, 2D )
     checkBasisEvaluation( MultivariatePolynomialBasis<Quadratic, 2>(),
                           Point{{1., 2.}}, {{1., 1., 2., 1., 2., 4.}}, success,
                           out );
+
+    // (X, Y) -> [ 1, X, Y, X^2, XY, Y^2, X^3, X^2Y, XY^2, Y^3 ]
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Cubic, 2>::size ), 10 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Cubic, 2>(),
+                          Point{{1., 2.}},
+                          {{1., 1., 2., 1., 2., 4., 1., 2., 4., 8.}}, success,
+                          out );
 }
 
 TEUCHOS_UNIT_TEST( MultivariatePolynomialBasis, 3D )
 {
     using ArborX::Point;
     using DataTransferKit::Constant;
+    using DataTransferKit::Cubic;
     using DataTransferKit::Linear;
     using DataTransferKit::MultivariatePolynomialBasis;
     using DataTransferKit::Quadratic;
@@ -81,4 +120,52 @@ TEUCHOS_UNIT_TEST( MultivariatePolynomialBasis, 3D )
     checkBasisEvaluation(
         MultivariatePolynomialBasis<Quadratic, 3>(), Point{{0., 1., 2.}},
         {{1., 0., 1., 2., 0., 0., 0., 1., 2., 4.}}, success, out );
+
+    // (X, Y, Z) -> [ 1, X, Y, Z, X^2, XY, XZ, Y^2, YZ, Z^2, X^3, X^2Y, X^2Z,
+    //                XY^2, XYZ, XZ^2, Y^3, Y^2Z, YZ^2, Z^3 ]
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Cubic, 3>::size ), 20 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Cubic, 3>(),
+                          Point{{1., 2., 3.}},
+                          {{1., 1., 2., 3., 1., 2., 3., 4., 6., 9., 1., 2., 3.,
+                            4., 6., 9., 8., 12., 18., 27.}},
+                          success, out );
+}
+
+TEUCHOS_UNIT_TEST( MultivariatePolynomialBasis, higher_degree )
+{
+    using DataTransferKit::Degree;
+    using DataTransferKit::MultivariatePolynomialBasis;
+
+    // X -> [ 1, X, X^2, X^3, X^4, X^5 ]
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Degree<5>, 1>::size ), 6 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Degree<5>, 1>(),
+                          Kokkos::Array<double, 1>{{2.}},
+                          {{1., 2., 4., 8., 16., 32.}}, success, out );
+
+    // (X, Y) -> [ 1, X, Y, X^2, XY, Y^2, X^3, X^2Y, XY^2, Y^3, X^4, X^3Y,
+    //             X^2Y^2, XY^3, Y^4 ]
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Degree<4>, 2>::size ), 15 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Degree<4>, 2>(),
+                          Kokkos::Array<double, 2>{{1., 2.}},
+                          {{1., 1., 2., 1., 2., 4., 1., 2., 4., 8., 1., 2., 4.,
+                            8., 16.}},
+                          success, out );
+
+    // Same basis as Cubic.
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Degree<3>, 3>::size ), 20 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Degree<3>, 3>(),
+                          ArborX::Point{{1., 2., 3.}},
+                          {{1., 1., 2., 3., 1., 2., 3., 4., 6., 9., 1., 2., 3.,
+                            4., 6., 9., 8., 12., 18., 27.}},
+                          success, out );
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Degree<4>, 3>::size ), 35 );
+
+    // (X, Y, Z, W) -> [ 1, X, Y, Z, W, X^2, XY, XZ, XW, Y^2, YZ, YW, Z^2, ZW,
+    //                   W^2 ]
+    TEST_EQUALITY( ( MultivariatePolynomialBasis<Degree<2>, 4>::size ), 15 );
+    checkBasisEvaluation( MultivariatePolynomialBasis<Degree<2>, 4>(),
+                          Kokkos::Array<double, 4>{{1., 2., 3., 4.}},
+                          {{1., 1., 2., 3., 4., 1., 2., 3., 4., 4., 6., 8., 9.,
+                            12., 16.}},
+                          success, out );
 }
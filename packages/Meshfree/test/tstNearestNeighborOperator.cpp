@@ -13,11 +13,14 @@
 
 #include <DTK_DBC.hpp> // DataTransferKitException
 #include <DTK_NearestNeighborOperator.hpp>
+#include <DTK_OperatorComposition.hpp>
 #include <Kokkos_Core.hpp>
 
 #include <array>
+#include <cstdio>
 #include <numeric>
 #include <random>
+#include <string>
 #include <vector>
 
 std::vector<std::array<DataTransferKit::Coordinate, 3>> makeStructuredCloud(
@@ -82,6 +85,72 @@ void copyPointsFromCloud(
     Kokkos::deep_copy( points, points_host );
 }
 
+// Dimensions and numbers of points of the boxes of the structured clouds.
+struct Box
+{
+    static constexpr double Lx = 2.;
+    static constexpr double Ly = 3.;
+    static constexpr double Lz = 5.;
+    static constexpr int nx = 7;
+    static constexpr int ny = 11;
+    static constexpr int nz = 13;
+};
+
+// Structured cloud in the box of processor @param rank, which is the box of
+// the first processor shifted by @param rank times its diagonal.
+std::vector<std::array<DataTransferKit::Coordinate, 3>> makeBoxCloud( int rank )
+{
+    return makeStructuredCloud( Box::Lx, Box::Ly, Box::Lz, Box::nx, Box::ny,
+                                Box::nz, rank * Box::Lx, rank * Box::Ly,
+                                rank * Box::Lz );
+}
+
+template <typename DeviceType>
+Kokkos::View<DataTransferKit::Coordinate **, DeviceType>
+makeBoxPoints( int rank )
+{
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> points(
+        "box_points", 0, 0 );
+    copyPointsFromCloud<DeviceType>( makeBoxCloud( rank ), points );
+    return points;
+}
+
+// Random cloud of @param n points in the unit cube. All the processors
+// share the same cube.
+template <typename DeviceType>
+Kokkos::View<DataTransferKit::Coordinate **, DeviceType>
+makeRandomPoints( int n, int seed )
+{
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> points(
+        "random_points", 0, 0 );
+    copyPointsFromCloud<DeviceType>( makeRandomCloud( 1., 1., 1., n, seed ),
+                                     points );
+    return points;
+}
+
+// Values equal to the first coordinate of @param points.
+template <typename DeviceType>
+Kokkos::View<double *, DeviceType> makeValues(
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> points )
+{
+    Kokkos::View<double *, DeviceType> values( "values", points.extent( 0 ) );
+    Kokkos::deep_copy( values, Kokkos::subview( points, Kokkos::ALL, 0 ) );
+    return values;
+}
+
+// Check that @param values are exactly the baseline @param values_ref.
+template <typename DeviceType>
+void compareValues( Kokkos::View<double const *, DeviceType> values,
+                    Kokkos::View<double const *, DeviceType> values_ref,
+                    bool &success, Teuchos::FancyOStream &out )
+{
+    auto values_host =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, values );
+    auto values_ref_host =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace{}, values_ref );
+    TEST_COMPARE_ARRAYS( values_host, values_ref_host );
+}
+
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, unique_source_point,
                                    DeviceType )
 {
@@ -150,33 +219,9 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, structured_clouds,
     MPI_Comm_rank( comm, &comm_rank );
 
     // Build the structured cloud of points for the source and the target.
-    double const Lx = 2.;
-    double const Ly = 3.;
-    double const Lz = 5.;
-    unsigned int const nx = 7;
-    unsigned int const ny = 11;
-    unsigned int const nz = 13;
-    double const source_offset_x = comm_rank * Lx;
-    double const source_offset_y = comm_rank * Ly;
-    double const source_offset_z = comm_rank * Lz;
-
-    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> source_points(
-        "source_points", 0, 0 );
-    copyPointsFromCloud<DeviceType>(
-        makeStructuredCloud( Lx, Ly, Lz, nx, ny, nz, source_offset_x,
-                             source_offset_y, source_offset_z ),
-        source_points );
-
-    double const target_offset_x = ( ( comm_rank + 1 ) % comm_size ) * Lx;
-    double const target_offset_y = ( ( comm_rank + 1 ) % comm_size ) * Ly;
-    double const target_offset_z = ( ( comm_rank + 1 ) % comm_size ) * Lz;
-
-    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> target_points(
-        "target_points", 0, 0 );
-    copyPointsFromCloud<DeviceType>(
-        makeStructuredCloud( Lx, Ly, Lz, nx, ny, nz, target_offset_x,
-                             target_offset_y, target_offset_z ),
-        target_points );
+    auto source_points = makeBoxPoints<DeviceType>( comm_rank );
+    auto target_points =
+        makeBoxPoints<DeviceType>( ( comm_rank + 1 ) % comm_size );
 
     unsigned int const n_points = source_points.extent( 0 );
     Kokkos::View<double *, DeviceType> target_values( "target_values",
@@ -185,10 +230,7 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, structured_clouds,
     DataTransferKit::NearestNeighborOperator<DeviceType> nnop(
         comm, source_points, target_points );
 
-    Kokkos::View<double *, DeviceType> source_values( "source_values",
-                                                      n_points );
-    Kokkos::deep_copy( source_values,
-                       Kokkos::subview( source_points, Kokkos::ALL, 0 ) );
+    auto source_values = makeValues( source_points );
 
     nnop.apply( source_values, target_values );
 
@@ -201,6 +243,71 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, structured_clouds,
         TEST_FLOATING_EQUALITY(
             target_values_host( i ),
             static_cast<double>( target_points_host( i, 0 ) ), 1e-14 );
+
+    // The explicit matrix gives the same result and all its columns are
+    // owned by the next processor.
+    auto crs_matrix = nnop.getCrsMatrix();
+    TEST_EQUALITY( crs_matrix.getNumberOfColumns(),
+                   static_cast<int>( n_points ) );
+    auto column_ranks_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, crs_matrix.getColumnRanks() );
+    for ( unsigned int j = 0; j < n_points; ++j )
+        TEST_EQUALITY( column_ranks_host( j ), ( comm_rank + 1 ) % comm_size );
+    Kokkos::deep_copy( target_values, 0. );
+    crs_matrix.apply( source_values, target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        TEST_FLOATING_EQUALITY(
+            target_values_host( i ),
+            static_cast<double>( target_points_host( i, 0 ) ), 1e-14 );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, balance_targets,
+                                   DeviceType )
+{
+    // The first processor owns the targets of all the processors and the
+    // other processors have none. The targets are redistributed for the
+    // search, which must not change the result.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    auto source_points = makeBoxPoints<DeviceType>( comm_rank );
+
+    std::vector<std::array<DataTransferKit::Coordinate, 3>> target_cloud;
+    if ( comm_rank == 0 )
+        for ( int k = comm_size - 1; k >= 0; --k )
+        {
+            auto cloud = makeBoxCloud( k );
+            target_cloud.insert( target_cloud.end(), cloud.begin(),
+                                 cloud.end() );
+        }
+    Kokkos::View<DataTransferKit::Coordinate **, DeviceType> target_points(
+        "target_points", 0, 0 );
+    copyPointsFromCloud<DeviceType>( target_cloud, target_points );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop(
+        DataTransferKit::PointCloudSearchTree<DeviceType>( comm, source_points,
+                                                           true ),
+        target_points );
+
+    auto source_values = makeValues( source_points );
+
+    unsigned int const n_target_points = target_points.extent( 0 );
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    nnop.apply( source_values, target_values );
+
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    auto target_points_host = Kokkos::create_mirror_view( target_points );
+    Kokkos::deep_copy( target_points_host, target_points );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+        TEST_FLOATING_EQUALITY(
+            target_values_host( i ),
+            static_cast<double>( target_points_host( i, 0 ) ), 1e-14 );
 }
 
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, mixed_clouds,
@@ -269,6 +376,310 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, mixed_clouds,
     }
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, split_phase,
+                                   DeviceType )
+{
+    // Same setup as structured_clouds but the transfer is performed in two
+    // phases and the source values are modified in between.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    auto source_points = makeBoxPoints<DeviceType>( comm_rank );
+    auto target_points =
+        makeBoxPoints<DeviceType>( ( comm_rank + 1 ) % comm_size );
+
+    unsigned int const n_points = source_points.extent( 0 );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop(
+        comm, source_points, target_points );
+
+    Kokkos::View<double **, DeviceType> source_values( "source_values",
+                                                       n_points, 2 );
+    Kokkos::deep_copy( Kokkos::subview( source_values, Kokkos::ALL, 0 ),
+                       Kokkos::subview( source_points, Kokkos::ALL, 0 ) );
+    Kokkos::deep_copy( Kokkos::subview( source_values, Kokkos::ALL, 1 ),
+                       Kokkos::subview( source_points, Kokkos::ALL, 2 ) );
+
+    auto handle = nnop.applyBegin( source_values );
+
+    // The values are in flight, the source can be overwritten.
+    Kokkos::deep_copy( source_values, -1. );
+
+    Kokkos::View<double **, DeviceType> target_values( "target_values",
+                                                       n_points, 2 );
+    nnop.applyEnd( handle, target_values );
+
+    // Check results
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    auto target_points_host = Kokkos::create_mirror_view( target_points );
+    Kokkos::deep_copy( target_points_host, target_points );
+    for ( unsigned int i = 0; i < n_points; ++i )
+    {
+        TEST_FLOATING_EQUALITY(
+            target_values_host( i, 0 ),
+            static_cast<double>( target_points_host( i, 0 ) ), 1e-14 );
+        TEST_FLOATING_EQUALITY(
+            target_values_host( i, 1 ),
+            static_cast<double>( target_points_host( i, 2 ) ), 1e-14 );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, apply_subset,
+                                   DeviceType )
+{
+    // Same setup as structured_clouds but only the targets in the lower half
+    // of the box are transferred.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    auto source_points = makeBoxPoints<DeviceType>( comm_rank );
+    int const target_rank = ( comm_rank + 1 ) % comm_size;
+    auto target_points = makeBoxPoints<DeviceType>( target_rank );
+
+    unsigned int const n_points = source_points.extent( 0 );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop(
+        comm, source_points, target_points );
+
+    Kokkos::View<double **, DeviceType> source_values( "source_values",
+                                                       n_points, 2 );
+    Kokkos::deep_copy( Kokkos::subview( source_values, Kokkos::ALL, 0 ),
+                       Kokkos::subview( source_points, Kokkos::ALL, 0 ) );
+    Kokkos::deep_copy( Kokkos::subview( source_values, Kokkos::ALL, 1 ),
+                       Kokkos::subview( source_points, Kokkos::ALL, 2 ) );
+
+    auto target_points_host = Kokkos::create_mirror_view( target_points );
+    Kokkos::deep_copy( target_points_host, target_points );
+    double const z_max = target_rank * Box::Lz + 0.5 * Box::Lz;
+    std::vector<int> selected;
+    for ( unsigned int i = 0; i < n_points; ++i )
+        if ( target_points_host( i, 2 ) < z_max )
+            selected.push_back( i );
+    Kokkos::View<int *, DeviceType> target_indices( "target_indices",
+                                                    selected.size() );
+    auto target_indices_host = Kokkos::create_mirror_view( target_indices );
+    for ( unsigned int k = 0; k < selected.size(); ++k )
+        target_indices_host( k ) = selected[k];
+    Kokkos::deep_copy( target_indices, target_indices_host );
+
+    Kokkos::View<double **, DeviceType> target_values( "target_values",
+                                                       n_points, 2 );
+    Kokkos::deep_copy( target_values, -1. );
+    nnop.applySubset( source_values, target_indices, target_values );
+
+    // Check results
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    for ( unsigned int i = 0; i < n_points; ++i )
+    {
+        bool const is_selected = target_points_host( i, 2 ) < z_max;
+        TEST_FLOATING_EQUALITY(
+            target_values_host( i, 0 ),
+            is_selected ? static_cast<double>( target_points_host( i, 0 ) )
+                        : -1.,
+            1e-14 );
+        TEST_FLOATING_EQUALITY(
+            target_values_host( i, 1 ),
+            is_selected ? static_cast<double>( target_points_host( i, 2 ) )
+                        : -1.,
+            1e-14 );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, update,
+                                   DeviceType )
+{
+    // Check that updating an operator after the target points moved gives the
+    // same result as building a new operator.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    int const n = 1000;
+    auto source_points = makeRandomPoints<DeviceType>( n, comm_rank );
+    auto target_points = makeRandomPoints<DeviceType>( n, comm_rank + 1234 );
+    auto moved_target_points =
+        makeRandomPoints<DeviceType>( n, comm_rank + 5678 );
+
+    auto source_values = makeValues( source_points );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop(
+        comm, source_points, target_points );
+
+    // With a zero tolerance, all the target points that moved are searched
+    // again.
+    nnop.update( moved_target_points, 0. );
+    Kokkos::View<double *, DeviceType> target_values( "target_values", n );
+    nnop.apply( source_values, target_values );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop_ref(
+        comm, source_points, moved_target_points );
+    Kokkos::View<double *, DeviceType> target_values_ref( "target_values_ref",
+                                                          n );
+    nnop_ref.apply( source_values, target_values_ref );
+
+    compareValues<DeviceType>( target_values, target_values_ref, success,
+                               out );
+
+    // With a large tolerance, the target points keep their source point.
+    nnop.update( target_points, 10. );
+    nnop.apply( source_values, target_values );
+    compareValues<DeviceType>( target_values, target_values_ref, success,
+                               out );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, save_load,
+                                   DeviceType )
+{
+    // Check that an operator loaded from files gives the same result as the
+    // operator that wrote them, also after it was updated.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    int const n = 1000;
+    auto source_points = makeRandomPoints<DeviceType>( n, comm_rank );
+    auto target_points = makeRandomPoints<DeviceType>( n, comm_rank + 1234 );
+
+    auto source_values = makeValues( source_points );
+
+    std::string const prefix = "nearest_neighbor_operator_archive";
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop_ref(
+        comm, source_points, target_points );
+    nnop_ref.save( prefix );
+    Kokkos::View<double *, DeviceType> target_values_ref( "target_values_ref",
+                                                          n );
+    nnop_ref.apply( source_values, target_values_ref );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop(
+        comm, source_points, target_points, prefix );
+    Kokkos::View<double *, DeviceType> target_values( "target_values", n );
+    nnop.apply( source_values, target_values );
+
+    compareValues<DeviceType>( target_values, target_values_ref, success,
+                               out );
+
+    // The files do not describe an operator from the target points to the
+    // source points.
+    TEST_THROW( DataTransferKit::NearestNeighborOperator<DeviceType>(
+                    comm, target_points, source_points, prefix ),
+                DataTransferKit::DataTransferKitException );
+
+    // After update(), the operator is identified by the new target points,
+    // even though with a large tolerance none of them is searched again.
+    auto moved_target_points =
+        makeRandomPoints<DeviceType>( n, comm_rank + 5678 );
+    nnop_ref.update( moved_target_points, 10. );
+    nnop_ref.save( prefix );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop_updated(
+        comm, source_points, moved_target_points, prefix );
+    nnop_updated.apply( source_values, target_values );
+    compareValues<DeviceType>( target_values, target_values_ref, success,
+                               out );
+
+    TEST_THROW( DataTransferKit::NearestNeighborOperator<DeviceType>(
+                    comm, source_points, target_points, prefix ),
+                DataTransferKit::DataTransferKitException );
+
+    std::remove( ( prefix + "." + std::to_string( comm_rank ) ).c_str() );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, transpose,
+                                   DeviceType )
+{
+    // Check that applyTranspose() is the adjoint of apply(), i.e. that
+    // <A x, y> = <x, A^T y>, and that it preserves the sum of the values.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    int const n = 1000;
+    auto source_points = makeRandomPoints<DeviceType>( n, comm_rank );
+    auto target_points = makeRandomPoints<DeviceType>( n, comm_rank + 1234 );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop(
+        comm, source_points, target_points );
+
+    auto source_values = makeValues( source_points );
+    Kokkos::View<double *, DeviceType> target_values( "target_values", n );
+    nnop.apply( source_values, target_values );
+
+    Kokkos::View<double *, DeviceType> adjoint_target_values(
+        "adjoint_target_values", n );
+    Kokkos::deep_copy( adjoint_target_values,
+                       Kokkos::subview( target_points, Kokkos::ALL, 1 ) );
+    Kokkos::View<double *, DeviceType> adjoint_source_values(
+        "adjoint_source_values", n );
+    nnop.applyTranspose( adjoint_target_values, adjoint_source_values );
+
+    auto source_values_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, source_values );
+    auto target_values_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, target_values );
+    auto adjoint_source_values_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, adjoint_source_values );
+    auto adjoint_target_values_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, adjoint_target_values );
+    // The local sums are reduced over all the processors.
+    std::array<double, 4> sums = {{0., 0., 0., 0.}};
+    for ( int i = 0; i < n; ++i )
+    {
+        sums[0] += target_values_host( i ) * adjoint_target_values_host( i );
+        sums[1] += source_values_host( i ) * adjoint_source_values_host( i );
+        sums[2] += adjoint_target_values_host( i );
+        sums[3] += adjoint_source_values_host( i );
+    }
+    MPI_Allreduce( MPI_IN_PLACE, sums.data(), sums.size(), MPI_DOUBLE,
+                   MPI_SUM, comm );
+    TEST_FLOATING_EQUALITY( sums[1], sums[0], 1e-12 );
+    TEST_FLOATING_EQUALITY( sums[3], sums[2], 1e-12 );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, compose,
+                                   DeviceType )
+{
+    // Check that the composition of two operators gives the same result as
+    // applying them one after the other. The clouds of all the processors
+    // overlap so the nearest neighbors may be on any processor.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    int const n = 1000;
+    auto source_points = makeRandomPoints<DeviceType>( n, comm_rank );
+    auto middle_points = makeRandomPoints<DeviceType>( n, comm_rank + 1234 );
+    auto target_points =
+        makeRandomPoints<DeviceType>( n / 2, comm_rank + 5678 );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> first(
+        comm, source_points, middle_points );
+    DataTransferKit::NearestNeighborOperator<DeviceType> second(
+        comm, middle_points, target_points );
+
+    auto fused = DataTransferKit::compose( first, second );
+    TEST_EQUALITY( fused.getNumberOfRows(), n / 2 );
+
+    auto source_values = makeValues( source_points );
+    Kokkos::View<double *, DeviceType> middle_values( "middle_values", n );
+    first.apply( source_values, middle_values );
+    Kokkos::View<double *, DeviceType> target_values_ref( "target_values_ref",
+                                                          n / 2 );
+    second.apply( middle_values, target_values_ref );
+    Kokkos::View<double *, DeviceType> target_values( "target_values", n / 2 );
+    fused.apply( source_values, target_values );
+
+    compareValues<DeviceType>( target_values, target_values_ref, success,
+                               out );
+}
+
 // Include the test macros.
 #include "DataTransferKit_ETIHelperMacros.h"
 
@@ -280,7 +691,21 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, mixed_clouds,
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
         NearestNeighborOperator, structured_clouds, DeviceType##NODE )         \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator,             \
-                                          mixed_clouds, DeviceType##NODE )
+                                          balance_targets, DeviceType##NODE )  \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator,             \
+                                          mixed_clouds, DeviceType##NODE )     \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator,             \
+                                          split_phase, DeviceType##NODE )      \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator,             \
+                                          apply_subset, DeviceType##NODE )     \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator, update,     \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator, save_load,  \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator, transpose,  \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator, compose,    \
+                                          DeviceType##NODE )
 
 // Demangle the types
 DTK_ETI_MANGLING_TYPEDEFS()
@@ -64,39 +64,53 @@ void check_result( Kokkos::View<double *, DeviceType> matrices,
     }
 }
 
-TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, full_rank, DeviceType )
+// Compute the pseudo-inverses of the matrices with one team per matrix and
+// return the number of rank-deficient matrices.
+template <typename DeviceType>
+size_t computePseudoInverses( int const n_matrices, int const matrix_size,
+                              Kokkos::View<double *, DeviceType> matrices,
+                              Kokkos::View<double *, DeviceType> inv_matrices )
 {
-    int const n_matrices = 10;
-    int const matrix_size = 32;
-    int const size = n_matrices * matrix_size * matrix_size;
-    Kokkos::View<double *, DeviceType> matrices( "matrices", size );
-    Kokkos::View<double *, DeviceType> inv_matrices( "inv_matrices", size );
-    // For magic number 3, see comment in
-    // DTK_DetailsMovingLeastSquaresOperatorImpl.hpp
-    Kokkos::View<double **, DeviceType> aux( "aux", matrix_size,
-                                             3 * n_matrices * matrix_size );
-
-    // Fill the matrices
-    auto matrices_host = Kokkos::create_mirror_view( matrices );
-    std::default_random_engine random_engine;
-    std::uniform_real_distribution<double> distribution( -1000, 1000 );
-    for ( int i = 0; i < size; ++i )
-        matrices_host( i ) = distribution( random_engine );
-    Kokkos::deep_copy( matrices, matrices_host );
-
-    DataTransferKit::Details::SVDFunctor<DeviceType> svd_functor(
-        matrix_size, matrices, inv_matrices, aux );
-    size_t n_underdetermined = 0;
     using ExecutionSpace = typename DeviceType::execution_space;
+    DataTransferKit::Details::SVDTeamFunctor<DeviceType> svd_functor(
+        matrix_size, matrices, inv_matrices );
+    size_t n_underdetermined = 0;
     Kokkos::parallel_reduce(
         DTK_MARK_REGION( "compute_svd_inverse" ),
-        Kokkos::RangePolicy<ExecutionSpace>( 0, n_matrices ), svd_functor,
-        n_underdetermined );
-
-    std::set<int> rank_deficiency;
+        Kokkos::TeamPolicy<ExecutionSpace>( n_matrices, Kokkos::AUTO ),
+        svd_functor, n_underdetermined );
+    return n_underdetermined;
+}
 
-    check_result( matrices, inv_matrices, n_matrices, matrix_size,
-                  rank_deficiency, out, success );
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, full_rank, DeviceType )
+{
+    // The indices of odd-sized matrices are padded in the round-robin
+    // ordering so check both even and odd sizes.
+    int const n_matrices = 10;
+    for ( int matrix_size : {31, 32} )
+    {
+        int const size = n_matrices * matrix_size * matrix_size;
+        Kokkos::View<double *, DeviceType> matrices( "matrices", size );
+        Kokkos::View<double *, DeviceType> inv_matrices( "inv_matrices",
+                                                         size );
+
+        // Fill the matrices
+        auto matrices_host = Kokkos::create_mirror_view( matrices );
+        std::default_random_engine random_engine;
+        std::uniform_real_distribution<double> distribution( -1000, 1000 );
+        for ( int i = 0; i < size; ++i )
+            matrices_host( i ) = distribution( random_engine );
+        Kokkos::deep_copy( matrices, matrices_host );
+
+        size_t n_underdetermined = computePseudoInverses(
+            n_matrices, matrix_size, matrices, inv_matrices );
+        TEST_EQUALITY( n_underdetermined, 0 );
+
+        std::set<int> rank_deficiency;
+
+        check_result( matrices, inv_matrices, n_matrices, matrix_size,
+                      rank_deficiency, out, success );
+    }
 }
 
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, rank_deficient, DeviceType )
@@ -106,10 +120,6 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, rank_deficient, DeviceType )
     int const size = n_matrices * matrix_size * matrix_size;
     Kokkos::View<double *, DeviceType> matrices( "matrices", size );
     Kokkos::View<double *, DeviceType> inv_matrices( "inv_matrices", size );
-    // For magic number 3, see comment in
-    // DTK_DetailsMovingLeastSquaresOperatorImpl.hpp
-    Kokkos::View<double **, DeviceType> aux( "aux", matrix_size,
-                                             3 * n_matrices * matrix_size );
 
     // Fill the matrices
     auto matrices_host = Kokkos::create_mirror_view( matrices );
@@ -134,14 +144,8 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, rank_deficient, DeviceType )
     }
     Kokkos::deep_copy( matrices, matrices_host );
 
-    DataTransferKit::Details::SVDFunctor<DeviceType> svd_functor(
-        matrix_size, matrices, inv_matrices, aux );
-    size_t n_underdetermined = 0;
-    using ExecutionSpace = typename DeviceType::execution_space;
-    Kokkos::parallel_reduce(
-        DTK_MARK_REGION( "compute_svd_inverse" ),
-        Kokkos::RangePolicy<ExecutionSpace>( 0, n_matrices ), svd_functor,
-        n_underdetermined );
+    size_t n_underdetermined = computePseudoInverses(
+        n_matrices, matrix_size, matrices, inv_matrices );
 
     TEST_EQUALITY( n_underdetermined, n_matrices );
 
@@ -149,6 +153,60 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, rank_deficient, DeviceType )
                   rank_deficiency, out, success );
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, fixed_size, DeviceType )
+{
+    // Check that the fixed-size kernel gives the first row of the
+    // pseudo-inverse.
+    int constexpr matrix_size = 10;
+    int const n_matrices = 10;
+    int const size = n_matrices * matrix_size * matrix_size;
+    Kokkos::View<double *, DeviceType> matrices( "matrices", size );
+    Kokkos::View<double *, DeviceType> inv_matrices( "inv_matrices", size );
+
+    auto matrices_host = Kokkos::create_mirror_view( matrices );
+    std::default_random_engine random_engine;
+    std::uniform_real_distribution<double> distribution( -1000, 1000 );
+    for ( int i = 0; i < size; ++i )
+        matrices_host( i ) = distribution( random_engine );
+    Kokkos::deep_copy( matrices, matrices_host );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    using SVD = DataTransferKit::Details::SVDFixedSize<DeviceType, matrix_size>;
+    Kokkos::View<double *, DeviceType> first_rows( "first_rows",
+                                                   n_matrices * matrix_size );
+    size_t n_underdetermined = 0;
+    Kokkos::parallel_reduce(
+        DTK_MARK_REGION( "compute_svd_inverse_fixed_size" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_matrices ),
+        KOKKOS_LAMBDA( int m, size_t &underdetermined ) {
+            typename SVD::matrix_type a;
+            for ( int i = 0; i < matrix_size; ++i )
+                for ( int j = 0; j < matrix_size; ++j )
+                    a[i][j] = matrices( ( m * matrix_size + i ) * matrix_size +
+                                        j );
+            typename SVD::vector_type first_row;
+            if ( SVD::pseudo_inverse_first_row( a, first_row ) )
+                ++underdetermined;
+            for ( int j = 0; j < matrix_size; ++j )
+                first_rows( m * matrix_size + j ) = first_row[j];
+        },
+        n_underdetermined );
+    TEST_EQUALITY( n_underdetermined, 0 );
+
+    computePseudoInverses( n_matrices, matrix_size, matrices, inv_matrices );
+
+    auto first_rows_host = Kokkos::create_mirror_view( first_rows );
+    Kokkos::deep_copy( first_rows_host, first_rows );
+    auto inv_matrices_host = Kokkos::create_mirror_view( inv_matrices );
+    Kokkos::deep_copy( inv_matrices_host, inv_matrices );
+    for ( int i = 0; i < n_matrices; ++i )
+        for ( int j = 0; j < matrix_size; ++j )
+            TEST_FLOATING_EQUALITY(
+                first_rows_host( i * matrix_size + j ) + 1.,
+                inv_matrices_host( i * matrix_size * matrix_size + j ) + 1.,
+                1e-12 );
+}
+
 // Include the test macros.
 #include "DataTransferKit_ETIHelperMacros.h"
 
@@ -157,7 +215,8 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, rank_deficient, DeviceType )
     using DeviceType##NODE = typename NODE::device_type;                       \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( SVD, full_rank, DeviceType##NODE )   \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( SVD, rank_deficient,                 \
-                                          DeviceType##NODE )
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( SVD, fixed_size, DeviceType##NODE )
 // Demangle the types
 DTK_ETI_MANGLING_TYPEDEFS()
 